@@ -17,8 +17,10 @@
 #include "codec_config.h"
 
 #include "rtos_abstraction_layer.h"
+#include "version.h"
 
 #include "rpmsg.h"
+#include "hrpn_ctrl.h"
 
 #include "stats_task.h"
 
@@ -67,6 +69,9 @@ extern uint32_t max_play_configs;
 
 const int audio_app_supported_period[] = {2, 4, 8, 16, 32};
 
+/* Rates reported in the capabilities, when the board codecs support them */
+static const uint32_t audio_app_caps_rates[] = {44100, 48000, 88200, 96000, 176400, 192000};
+
 static rtos_thread_t audio_thread;
 
 /*******************************************************************************
@@ -75,9 +80,20 @@ static rtos_thread_t audio_thread;
 
 #define EPT_ADDR	(30)
 
+/*
+ * Request id of the command being handled: removed from the command type
+ * before the audio control code sees it, echoed in the type of its response
+ * (commands are handled one at a time, by the control thread).
+ */
+static uint32_t audio_app_ctrl_req_id;
+
 int audio_app_ctrl_send(void *ctrl_handle, void *data, uint32_t len)
 {
 	struct rpmsg_ept *ept = (struct rpmsg_ept *)ctrl_handle;
+	struct audio_resp *resp = data;
+
+	if (len >= sizeof(resp->type))
+		resp->type = HRPN_TYPE_REQ(resp->type, audio_app_ctrl_req_id);
 
 	return rpmsg_send(ept, data, len);
 }
@@ -116,6 +132,52 @@ static void audio_app_setup(struct audio_cmd_run *run)
 	system_config_set_avdecc(aem_id, milan_mode);
 }
 
+/*
+ * Capabilities, from the tables used to validate the run command: play_config[]
+ * entries (run modes), codec rates and audio_app_supported_period[].
+ */
+static void audio_app_caps(struct rpmsg_ept *ept, uint32_t req_id)
+{
+	struct hrpn_resp_caps caps;
+	struct hrpn_caps_audio_config *config;
+	unsigned int i, j;
+
+	memset(&caps, 0, sizeof(caps));
+
+	caps.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_CAPS, req_id);
+	caps.status = HRPN_RESP_STATUS_SUCCESS;
+	caps.version = HRPN_CAPS_VERSION(VERSION_MAJOR, VERSION_MDIUM, VERSION_MINOR);
+	caps.features = HRPN_CAPS_FEATURE_REQ_ID | HRPN_CAPS_FEATURE_AUDIO;
+
+	for (i = 0; (i < max_play_configs) && (i < HRPN_CAPS_AUDIO_CONFIGS_MAX); i++) {
+		config = &caps.audio_config[i];
+
+		for (j = 0; j < AUDIO_APP_MAX_RUN_MODES; j++)
+			if (play_config[i][j])
+				config->modes |= 1 << j;
+
+		for (j = 0; j < sizeof(audio_app_caps_rates) / sizeof(audio_app_caps_rates[0]); j++) {
+			if (config->rate_count >= HRPN_CAPS_AUDIO_RATES_MAX)
+				break;
+
+			/* same audio HAT selection as audio_app_apply_config() */
+			if (BOARD_codec_is_rate_supported(audio_app_caps_rates[j], i == 1))
+				config->rates[config->rate_count++] = audio_app_caps_rates[j];
+		}
+
+		caps.audio_config_count++;
+	}
+
+	for (i = 0; i < sizeof(audio_app_supported_period) / sizeof(audio_app_supported_period[0]); i++) {
+		if (caps.audio_period_count >= HRPN_CAPS_AUDIO_PERIODS_MAX)
+			break;
+
+		caps.audio_periods[caps.audio_period_count++] = audio_app_supported_period[i];
+	}
+
+	rpmsg_send(ept, &caps, sizeof(caps));
+}
+
 static int rpmsg_receive_audio_command(void *ctrl_handle, void *data, uint32_t *len)
 {
 	struct rpmsg_ept *ept = (struct rpmsg_ept *)ctrl_handle;
@@ -134,6 +196,15 @@ int audio_app_ctrl_recv(void *ctrl_handle, void *data, uint32_t *len)
 
 	cmd = (struct audio_command*)data;
 
+	audio_app_ctrl_req_id = HRPN_REQ_ID(cmd->u.cmd.type);
+	cmd->u.cmd.type = HRPN_TYPE(cmd->u.cmd.type);
+
+	/* answered here, not passed to the audio control */
+	if (cmd->u.cmd.type == HRPN_CMD_TYPE_CAPS) {
+		audio_app_caps(ctrl_handle, audio_app_ctrl_req_id);
+		return -1;
+	}
+
 	switch (cmd->u.cmd.type) {
 	case AUDIO_CMD_TYPE_RUN:
 		if (*len != sizeof(struct audio_cmd_run)) {
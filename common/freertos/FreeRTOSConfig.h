@@ -189,4 +189,11 @@ void vConfigureTickInterrupt( void );
 void vClearTickInterrupt( void );
 #define configCLEAR_TICK_INTERRUPT() vClearTickInterrupt()
 
+/* Event tracer task switch hook, for applications built with lib_trace (see
+common/os/trace.h). */
+#if defined(OS_TRACE)
+void os_trace_task_switched_in(const char *name);
+#define traceTASK_SWITCHED_IN() os_trace_task_switched_in(pxCurrentTCB->pcTaskName)
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
@@ -30,12 +30,14 @@
 
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
+#include "task.h"
 
 /* NXP includes. */
 #include "fsl_device_registers.h"
 #include "fsl_common.h"
 
 #include "irq.h"
+#include "os/trace.h"
 
 /*******************************************************************************
  * Global variables
@@ -53,6 +55,9 @@ uint32_t FreeRTOS_tick_interval;
 static void VirtualTimer_IRQn_Handler(void *data)
 {
 	(void)data;
+
+	os_trace_record(OS_TRACE_TICK, xTaskGetTickCountFromISR());
+
 	/* Since vApplicationIRQHandler() enables interrupts to allow interrupt
 	 * nesting: Disable Interrupts here as FreeRTOS_Tick_Handler()
 	 * supposes/requires that.
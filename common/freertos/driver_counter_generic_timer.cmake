@@ -0,0 +1,14 @@
+#Description: Harpoon FreeRTOS specific implentation; user_visible: True
+include_guard(GLOBAL)
+message("Generic timer counter driver component is included.")
+
+# Provides the "generic" counter instance (see os/counter_generic_timer.c)
+mcux_add_macro(
+    CC "-DOS_COUNTER_GENERIC_TIMER"
+)
+
+mcux_add_source(
+    SOURCES
+    os/counter.c
+    os/counter_generic_timer.c
+)
@@ -34,12 +34,29 @@ void vApplicationIdleHook(void)
 
 void cpu_load_stats(void)
 {
+	static uint64_t cpu_idle_last = 0, cpu_busy_last = 0;
+	uint64_t idle, busy;
 	float cpu_load;
 
-	if (cpu_idle + cpu_busy > 0) {
-		cpu_load = (100. * cpu_busy) / (cpu_idle + cpu_busy);
+	/* counts accumulate since boot, see cpu_load_read() */
+	idle = cpu_idle - cpu_idle_last;
+	busy = cpu_busy - cpu_busy_last;
+
+	if (idle + busy > 0) {
+		cpu_load = (100. * busy) / (idle + busy);
 		log_info("CPU load: %.2f%%\n", cpu_load);
 	}
-	cpu_idle = 0;
-	cpu_busy = 0;
+	cpu_idle_last += idle;
+	cpu_busy_last += busy;
+}
+
+/* Busy and total (busy + idle) generic timer counts since boot */
+int cpu_load_read(uint64_t *busy, uint64_t *total)
+{
+	portDISABLE_INTERRUPTS();
+	*busy = cpu_busy;
+	*total = cpu_busy + cpu_idle;
+	portENABLE_INTERRUPTS();
+
+	return 0;
 }
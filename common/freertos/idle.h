@@ -1,5 +1,5 @@
 /*
- * Copyright 2022 NXP
+ * Copyright 2022, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,7 +7,10 @@
 #ifndef _IDLE_H_
 #define _IDLE_H_
 
+#include <stdint.h>
+
 void vApplicationIdleHook(void);
 void cpu_load_stats(void);
+int cpu_load_read(uint64_t *busy, uint64_t *total);
 
 #endif /* _IDLE_H_ */
@@ -5,7 +5,9 @@
  */
 
 #include "os/irq.h"
+#include "os/section.h"
 #include "os/stddef.h"
+#include "os/trace.h"
 #include <stdint.h>
 
 #include "FreeRTOS.h"
@@ -19,7 +21,7 @@ struct irq_handler {
 	void *data;
 };
 
-static struct irq_handler handler[NR_IRQS];
+static struct irq_handler handler[NR_IRQS] OS_HOT_BSS;
 
 
 int irq_register(int nr, void (*func)(void *data), void *data, unsigned int prio)
@@ -74,7 +76,7 @@ exit:
 }
 
 /* Called from port FreeRTOS_IRQ_Handler */
-void vApplicationIRQHandler(uint32_t ulICCIAR)
+void OS_HOT_TEXT vApplicationIRQHandler(uint32_t ulICCIAR)
 {
 	struct irq_handler *hdlr = NULL;
 	unsigned int nr;
@@ -84,14 +86,18 @@ void vApplicationIRQHandler(uint32_t ulICCIAR)
 	if (cpu_load_work_begin == 0)
 		ARM_TIMER_GetCounterCount(ARM_TIMER_VIRTUAL, &cpu_load_work_begin);
 
+	nr = ulICCIAR & NR_IRQS;
+
+	os_trace_irq_entry(nr);
+
 	/* Enable Interrupts to allow interrupts nesting */
 	portENABLE_INTERRUPTS();
 
-	nr = ulICCIAR & NR_IRQS;
-
 	if (nr < NR_IRQS)
 		hdlr = &handler[nr];
 
 	if (hdlr && hdlr->func)
 		hdlr->func(hdlr->data);
+
+	os_trace_irq_exit(nr);
 }
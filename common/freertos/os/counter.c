@@ -1,17 +1,26 @@
 /*
- * Copyright 2021-2023 NXP
+ * Copyright 2021-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include "os/counter.h"
+#include "os/section.h"
 
 #define USEC_PER_SEC	1000000
 #define NSEC_PER_SEC	1000000000
 
 int os_counter_start(os_counter_t *dev)
 {
-	return dev->ops->os_counter_start(dev);
+	int ret;
+
+	ret = dev->ops->os_counter_start(dev);
+
+	/* the counter frequency is known once the hardware is initialized */
+	if (!ret && !dev->ns_mult)
+		os_counter_ns_scale(dev->ops->os_counter_get_frequency(dev), &dev->ns_mult, &dev->ns_shift);
+
+	return ret;
 }
 
 int os_counter_stop(const os_counter_t *dev)
@@ -19,12 +28,12 @@ int os_counter_stop(const os_counter_t *dev)
 	return dev->ops->os_counter_stop(dev);
 }
 
-int os_counter_get_value(const os_counter_t *dev, uint32_t *cnt)
+int OS_HOT_TEXT os_counter_get_value(const os_counter_t *dev, uint32_t *cnt)
 {
 	return dev->ops->os_counter_get_value(dev, cnt);
 }
 
-bool os_counter_is_counting_up(const os_counter_t *dev)
+bool OS_HOT_TEXT os_counter_is_counting_up(const os_counter_t *dev)
 {
 	return dev->ops->os_counter_is_counting_up(dev);
 }
@@ -36,12 +45,15 @@ uint32_t os_counter_us_to_ticks(const os_counter_t *dev, uint64_t time_us)
 	return ticks;
 }
 
-uint64_t os_counter_ticks_to_ns(const os_counter_t *dev, uint32_t ticks)
+uint64_t OS_HOT_TEXT os_counter_ticks_to_ns(const os_counter_t *dev, uint32_t ticks)
 {
+	if (dev->ns_mult)
+		return os_counter_ns_scaled(ticks, dev->ns_mult, dev->ns_shift);
+
 	return (NSEC_PER_SEC * (uint64_t)ticks) / dev->ops->os_counter_get_frequency(dev);
 }
 
-uint32_t os_counter_get_top_value(const os_counter_t *dev)
+uint32_t OS_HOT_TEXT os_counter_get_top_value(const os_counter_t *dev)
 {
 	return dev->ops->os_counter_get_top_value(dev);
 }
@@ -55,13 +67,13 @@ uint8_t os_counter_get_num_of_channels(const os_counter_t *dev)
  * After expiration alarm can be set again, disabling is not needed.
  * When alarm expiration handler is called, channel is considered available and can be set again in that context.
  */
-int os_counter_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
+int OS_HOT_TEXT os_counter_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		const struct os_counter_alarm_cfg *alarm_cfg)
 {
 	return dev->ops->os_counter_set_channel_alarm(dev, chan_id, alarm_cfg);
 }
 
-int os_counter_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
+int OS_HOT_TEXT os_counter_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
 {
 	return dev->ops->os_counter_cancel_channel_alarm(dev, chan_id);
 }
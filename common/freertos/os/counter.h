@@ -1,5 +1,5 @@
 /*
- * Copyright 2021-2024 NXP
+ * Copyright 2021-2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,8 +13,8 @@
 #include "os/counter.h"
 #include "os/irq.h"
 
-/* TODO: support multiple channels */
-#define NB_CHANNELS		1
+/* Maximum number of channels of the counter backends (GPT: 3, TPM: 4, generic timer: 1) */
+#define NB_CHANNELS		4
 
 struct os_counter_ops {
 	int (*os_counter_start)(os_counter_t *dev);
@@ -36,6 +36,8 @@ struct os_counter {
 	bool initialized; /* True if HW is initialized */
 	const struct os_counter_ops *ops; //the hardware specific counter ops
 	struct os_counter_alarm_cfg alarms[NB_CHANNELS];
+	uint64_t ns_mult; /* fixed-point ticks to ns conversion, set on the first start */
+	uint32_t ns_shift;
 };
 
 #define OS_COUNTER_ALARM_CFG_ABSOLUTE (1 << 0)
@@ -46,6 +48,9 @@ extern os_counter_t freertos_counter_instance_0;
 #if defined(BOARD_COUNTER_1_BASE) && defined(BOARD_COUNTER_1_IRQ)
 extern os_counter_t freertos_counter_instance_1;
 #endif
+#if defined(OS_COUNTER_GENERIC_TIMER)
+extern os_counter_t freertos_counter_instance_generic;
+#endif
 
 #define GET_COUNTER_DEVICE_INSTANCE(inst)      (&freertos_counter_instance_ ## inst)
 
@@ -0,0 +1,264 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "os/counter.h"
+#include "os/irq.h"
+#include "os/section.h"
+
+#include "rtos_apps/log.h"
+#include "rtos_abstraction_layer.h"
+
+/*
+ * Counter on the ARM generic timer: the system counter (CNTPCT) and the
+ * EL1 physical timer comparator of the current core (CNTP_CVAL/CNTP_CTL),
+ * the virtual timer being used for the FreeRTOS tick.
+ *
+ * No peripheral is involved: registers are system registers, the frequency
+ * comes from CNTFRQ. The 64-bit system counter is exposed as a 32-bit
+ * counter, like the GPT and TPM backends. There is a single comparator per
+ * core, so a single instance, and alarms must be set and cancelled from the
+ * core handling the interrupt.
+ */
+
+/* EL1 physical timer PPI */
+#define GENERIC_TIMER_PHYS_IRQn		30
+
+#define CNTP_CTL_ENABLE		(1 << 0)
+
+#define GENERIC_TIMER_NB_CHANNELS	1
+
+static inline uint64_t OS_HOT_TEXT generic_timer_count(void)
+{
+	uint64_t cnt;
+
+	__asm volatile ("isb; mrs %0, cntpct_el0" : "=r" (cnt) : : "memory");
+
+	return cnt;
+}
+
+static inline void OS_HOT_TEXT generic_timer_ctl_write(uint64_t ctl)
+{
+	__asm volatile ("msr cntp_ctl_el0, %0; isb" : : "r" (ctl) : "memory");
+}
+
+static inline void OS_HOT_TEXT generic_timer_cval_write(uint64_t cval)
+{
+	__asm volatile ("msr cntp_cval_el0, %0" : : "r" (cval) : "memory");
+}
+
+static int OS_HOT_TEXT set_alarm(os_counter_t *dev, uint8_t chan_id,
+		const struct os_counter_alarm_cfg *alarm_cfg)
+{
+	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
+
+	rtos_assert(dev->initialized == true, "generic timer not initialized!");
+
+	/* Fail if alarm already set for this channel. */
+	if (alarm->callback)
+		return -1;
+
+	/* save the alarm config */
+	alarm->callback = alarm_cfg->callback;
+	alarm->user_data = alarm_cfg->user_data;
+
+	return 0;
+}
+
+static void OS_HOT_TEXT reset_alarm(os_counter_t *dev, uint8_t chan_id)
+{
+	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
+
+	/* reset alarm config */
+	alarm->callback = NULL;
+}
+
+/*
+ * The timer interrupt is level sensitive, and stays asserted until the
+ * comparator is disabled (or reprogrammed in the future).
+ */
+static void OS_HOT_TEXT generic_timer_irq_handler(void *irq_dev)
+{
+	os_counter_t *dev = (os_counter_t *)irq_dev;
+	const struct os_counter_alarm_cfg *alarm;
+	void (*callback)(os_counter_t *dev, uint8_t chan_id, uint32_t irq_counter, void *user_data);
+	void *user_data;
+	uint8_t chan_id = 0;
+	uint32_t now;
+
+	now = (uint32_t)generic_timer_count();
+
+	generic_timer_ctl_write(0);
+
+	alarm = &dev->alarms[chan_id];
+	callback = alarm->callback;
+	user_data = alarm->user_data;
+
+	/* Release the channel first, so that the callback can set a new alarm */
+	reset_alarm(dev, chan_id);
+
+	if (callback)
+		callback(dev, chan_id, now, user_data);
+}
+
+static void counter_init(os_counter_t *dev)
+{
+	IRQn_Type irqn = dev->irqn;
+	int ret;
+
+	generic_timer_ctl_write(0);
+
+	ret = os_irq_register(irqn, generic_timer_irq_handler, (void *)dev, dev->irq_prio);
+	rtos_assert(!ret, "Failed to register counter's IRQ! (%d)", ret);
+	os_irq_enable(irqn);
+
+	dev->initialized = true;
+
+	log_debug("using generic timer irq %d initialized\n", irqn);
+}
+
+/* The system counter always runs, start and stop only (de)initialize the comparator */
+static int os_counter_generic_timer_start(os_counter_t *dev)
+{
+	if (!dev->initialized)
+		counter_init(dev);
+
+	return 0;
+}
+
+static int os_counter_generic_timer_stop(const os_counter_t *dev)
+{
+	generic_timer_ctl_write(0);
+
+	return 0;
+}
+
+static int OS_HOT_TEXT os_counter_generic_timer_get_value(const os_counter_t *dev, uint32_t *cnt)
+{
+	if (!cnt)
+		return -1;
+
+	*cnt = (uint32_t)generic_timer_count();
+
+	return 0;
+}
+
+static bool OS_HOT_TEXT os_counter_generic_timer_is_counting_up(const os_counter_t *dev)
+{
+	return true;
+}
+
+static uint32_t OS_HOT_TEXT os_counter_generic_timer_get_frequency(const os_counter_t *dev)
+{
+	uint64_t freq;
+
+	__asm volatile ("mrs %0, cntfrq_el0" : "=r" (freq));
+
+	return (uint32_t)freq;
+}
+
+static uint32_t OS_HOT_TEXT os_counter_generic_timer_get_top_value(const os_counter_t *dev)
+{
+	return UINT32_MAX;
+}
+
+static uint8_t os_counter_generic_timer_get_num_of_channels(const os_counter_t *dev)
+{
+	return GENERIC_TIMER_NB_CHANNELS;
+}
+
+/*
+ * After expiration alarm can be set again, disabling is not needed.
+ * When alarm expiration handler is called, channel is considered available and can be set again in that context.
+ */
+static int OS_HOT_TEXT os_counter_generic_timer_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
+		const struct os_counter_alarm_cfg *alarm_cfg)
+{
+	uint64_t now;
+	uint32_t delta;
+	int ret = 0;
+
+	if (!alarm_cfg) {
+		log_err("Null pointer for channel ID (%d)\n", chan_id);
+
+		ret = -1;
+		goto exit;
+	}
+
+	if (chan_id >= GENERIC_TIMER_NB_CHANNELS) {
+		log_err("Channel ID (%d) not supported!\n", chan_id);
+
+		ret = -1;
+		goto exit;
+	}
+
+	/* Keep a reference of the alarm config (for callback) */
+	ret = set_alarm(dev, chan_id, alarm_cfg);
+	if (ret) {
+		log_err("Failed to set counter's alarm for device %p channel %d\n",
+			       dev, chan_id);
+
+		goto exit;
+	}
+
+	/*
+	 * Absolute alarms are 32-bit counter values: like a 32-bit compare
+	 * register, the alarm expires at the next time the low bits of the
+	 * system counter match.
+	 */
+	now = generic_timer_count();
+	if (alarm_cfg->flags & OS_COUNTER_ALARM_CFG_ABSOLUTE)
+		delta = alarm_cfg->ticks - (uint32_t)now;
+	else
+		delta = alarm_cfg->ticks;
+
+	generic_timer_cval_write(now + delta);
+	generic_timer_ctl_write(CNTP_CTL_ENABLE);
+
+exit:
+	return ret;
+}
+
+static int OS_HOT_TEXT os_counter_generic_timer_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
+{
+	int ret = 0;
+
+	if (chan_id >= GENERIC_TIMER_NB_CHANNELS) {
+		log_err("Channel ID (%d) not supported!\n", chan_id);
+
+		ret = -1;
+		goto exit;
+	}
+
+	generic_timer_ctl_write(0);
+
+	reset_alarm(dev, chan_id);
+
+exit:
+	return ret;
+}
+
+static const struct os_counter_ops generic_timer_counter_ops = {
+	.os_counter_start = os_counter_generic_timer_start,
+	.os_counter_stop = os_counter_generic_timer_stop,
+	.os_counter_get_num_of_channels = os_counter_generic_timer_get_num_of_channels,
+	.os_counter_get_value = os_counter_generic_timer_get_value,
+	.os_counter_is_counting_up = os_counter_generic_timer_is_counting_up,
+	.os_counter_get_frequency = os_counter_generic_timer_get_frequency,
+	.os_counter_get_top_value = os_counter_generic_timer_get_top_value,
+	.os_counter_set_channel_alarm = os_counter_generic_timer_set_channel_alarm,
+	.os_counter_cancel_channel_alarm = os_counter_generic_timer_cancel_channel_alarm,
+};
+
+#ifndef BOARD_COUNTER_GENERIC_IRQ_PRIO
+#define BOARD_COUNTER_GENERIC_IRQ_PRIO	OS_IRQ_PRIO_DEFAULT
+#endif
+
+os_counter_t freertos_counter_instance_generic OS_HOT_DATA = {
+	.base = NULL,
+	.irqn = GENERIC_TIMER_PHYS_IRQn,
+	.irq_prio = BOARD_COUNTER_GENERIC_IRQ_PRIO,
+	.ops = &generic_timer_counter_ops,
+};
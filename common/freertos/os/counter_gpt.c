@@ -6,6 +6,7 @@
 
 #include "os/counter.h"
 #include "os/irq.h"
+#include "os/section.h"
 
 #include "rtos_apps/log.h"
 #include "rtos_abstraction_layer.h"
@@ -16,9 +17,26 @@
 /* FIXME use fsl_clock to get the frequency */
 #define SOURCE_CLOCK_FREQ_HZ	24000000
 
+/* Output compare channels, channel n uses output compare n + 1 */
+#define GPT_NB_CHANNELS		3
+
+static const uint32_t gpt_chan_irq[GPT_NB_CHANNELS] = {
+	kGPT_OutputCompare1InterruptEnable,
+	kGPT_OutputCompare2InterruptEnable,
+	kGPT_OutputCompare3InterruptEnable,
+};
+
+static const uint32_t gpt_chan_flag[GPT_NB_CHANNELS] = {
+	kGPT_OutputCompare1Flag,
+	kGPT_OutputCompare2Flag,
+	kGPT_OutputCompare3Flag,
+};
+
+#define GPT_CHAN_FLAGS	(kGPT_OutputCompare1Flag | kGPT_OutputCompare2Flag | kGPT_OutputCompare3Flag)
+
 static int os_counter_gpt_get_value(const os_counter_t *dev, uint32_t *cnt);
 
-static int set_alarm(os_counter_t *dev, uint8_t chan_id,
+static int OS_HOT_TEXT set_alarm(os_counter_t *dev, uint8_t chan_id,
 		const struct os_counter_alarm_cfg *alarm_cfg)
 {
 	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
@@ -36,7 +54,7 @@ static int set_alarm(os_counter_t *dev, uint8_t chan_id,
 	return 0;
 }
 
-static void reset_alarm(os_counter_t *dev, uint8_t chan_id)
+static void OS_HOT_TEXT reset_alarm(os_counter_t *dev, uint8_t chan_id)
 {
 	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
 
@@ -44,24 +62,25 @@ static void reset_alarm(os_counter_t *dev, uint8_t chan_id)
 	alarm->callback = NULL;
 }
 
-static void gpt_irq_ack(const os_counter_t *dev, uint8_t chan_id)
+/* Interrupt enable register updates are read-modify-write, shared by all channels */
+static void OS_HOT_TEXT gpt_chan_disable(const os_counter_t *dev, uint8_t chan_id)
 {
-	/* TODO: support multiple channels */
-	if (chan_id != kGPT_OutputCompare_Channel1) {
-		/* TODO: support multiple channels */
-		log_err("Channel ID (%d) not supported!\n", chan_id);
+	unsigned int key = os_irq_lock();
 
-	} else {
-		GPT_DisableInterrupts((GPT_Type *)dev->base, kGPT_OutputCompare1InterruptEnable);
-		GPT_ClearStatusFlags((GPT_Type *)dev->base, kGPT_OutputCompare1Flag);
-	}
+	GPT_DisableInterrupts((GPT_Type *)dev->base, gpt_chan_irq[chan_id]);
+	GPT_ClearStatusFlags((GPT_Type *)dev->base, gpt_chan_flag[chan_id]);
+
+	os_irq_unlock(key);
 }
 
-static void gpt_irq_handler(void *irq_dev)
+static void OS_HOT_TEXT gpt_irq_handler(void *irq_dev)
 {
 	os_counter_t *dev = (os_counter_t *)irq_dev;
 	const struct os_counter_alarm_cfg *alarm;
-	uint8_t chan_id = kGPT_OutputCompare_Channel1; /* TODO support multiple channels*/
+	void (*callback)(os_counter_t *dev, uint8_t chan_id, uint32_t irq_counter, void *user_data);
+	void *user_data;
+	uint32_t status;
+	uint8_t chan_id;
 	uint32_t now;
 	int ret;
 
@@ -69,14 +88,25 @@ static void gpt_irq_handler(void *irq_dev)
 	if (ret)
 		assert(true);
 
-	gpt_irq_ack(dev, chan_id);
+	status = GPT_GetStatusFlags((GPT_Type *)dev->base, GPT_CHAN_FLAGS) &
+		 GPT_GetEnabledInterrupts((GPT_Type *)dev->base);
 
-	alarm = &dev->alarms[chan_id];
+	for (chan_id = 0; chan_id < GPT_NB_CHANNELS; chan_id++) {
+		if (!(status & gpt_chan_flag[chan_id]))
+			continue;
 
-	if (alarm->callback)
-		alarm->callback(dev, chan_id, now, alarm->user_data);
+		gpt_chan_disable(dev, chan_id);
 
-	reset_alarm(dev, chan_id);
+		alarm = &dev->alarms[chan_id];
+		callback = alarm->callback;
+		user_data = alarm->user_data;
+
+		/* Release the channel first, so that the callback can set a new alarm */
+		reset_alarm(dev, chan_id);
+
+		if (callback)
+			callback(dev, chan_id, now, user_data);
+	}
 }
 
 static void counter_init(os_counter_t *dev)
@@ -118,7 +148,7 @@ static int os_counter_gpt_stop(const os_counter_t *dev)
 	return 0;
 }
 
-static int os_counter_gpt_get_value(const os_counter_t *dev, uint32_t *cnt)
+static int OS_HOT_TEXT os_counter_gpt_get_value(const os_counter_t *dev, uint32_t *cnt)
 {
 	if (!cnt)
 		return -1;
@@ -128,35 +158,36 @@ static int os_counter_gpt_get_value(const os_counter_t *dev, uint32_t *cnt)
 	return 0;
 }
 
-static bool os_counter_gpt_is_counting_up(const os_counter_t *dev)
+static bool OS_HOT_TEXT os_counter_gpt_is_counting_up(const os_counter_t *dev)
 {
 	return true;
 }
 
-static uint32_t os_counter_gpt_get_frequency(const os_counter_t *dev)
+static uint32_t OS_HOT_TEXT os_counter_gpt_get_frequency(const os_counter_t *dev)
 {
 	return SOURCE_CLOCK_FREQ_HZ;
 }
 
-static uint32_t os_counter_gpt_get_top_value(const os_counter_t *dev)
+static uint32_t OS_HOT_TEXT os_counter_gpt_get_top_value(const os_counter_t *dev)
 {
 	return UINT32_MAX;
 }
 
 static uint8_t os_counter_gpt_get_num_of_channels(const os_counter_t *dev)
 {
-	return NB_CHANNELS;
+	return GPT_NB_CHANNELS;
 }
 
 /*
  * After expiration alarm can be set again, disabling is not needed.
  * When alarm expiration handler is called, channel is considered available and can be set again in that context.
  */
-static int os_counter_gpt_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
+static int OS_HOT_TEXT os_counter_gpt_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		const struct os_counter_alarm_cfg *alarm_cfg)
 {
 	int ret = 0;
 	uint32_t current, next;
+	unsigned int key;
 
 	if (!alarm_cfg) {
 		log_err("Null pointer for channel ID (%d)\n", chan_id);
@@ -165,8 +196,7 @@ static int os_counter_gpt_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		goto exit;
 	}
 
-	if (chan_id != kGPT_OutputCompare_Channel1) {
-		/* TODO: support multiple channels */
+	if (chan_id >= GPT_NB_CHANNELS) {
 		log_err("Channel ID (%d) not supported!\n", chan_id);
 
 		ret = -1;
@@ -189,27 +219,29 @@ static int os_counter_gpt_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		next += current;
 	}
 
-	GPT_EnableInterrupts((GPT_Type *)dev->base, kGPT_OutputCompare1InterruptEnable);
-	GPT_SetOutputCompareValue((GPT_Type *)dev->base, kGPT_OutputCompare_Channel1, next);
+	/* the flag of a disabled channel is still set on compare matches, clear it before enabling */
+	key = os_irq_lock();
+	GPT_ClearStatusFlags((GPT_Type *)dev->base, gpt_chan_flag[chan_id]);
+	GPT_SetOutputCompareValue((GPT_Type *)dev->base, (gpt_output_compare_channel_t)chan_id, next);
+	GPT_EnableInterrupts((GPT_Type *)dev->base, gpt_chan_irq[chan_id]);
+	os_irq_unlock(key);
 
 exit:
 	return ret;
 }
 
-static int os_counter_gpt_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
+static int OS_HOT_TEXT os_counter_gpt_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
 {
 	int ret = 0;
 
-	if (chan_id != kGPT_OutputCompare_Channel1) {
-		/* TODO: support multiple channels */
+	if (chan_id >= GPT_NB_CHANNELS) {
 		log_err("Channel ID (%d) not supported!\n", chan_id);
 
 		ret = -1;
 		goto exit;
 	}
 
-	GPT_DisableInterrupts((GPT_Type *)dev->base, kGPT_OutputCompare1InterruptEnable);
-	GPT_ClearStatusFlags((GPT_Type *)dev->base, kGPT_OutputCompare1Flag);
+	gpt_chan_disable(dev, chan_id);
 
 	reset_alarm(dev, chan_id);
 
@@ -232,7 +264,7 @@ static const struct os_counter_ops gpt_counter_ops = {
 #endif
 
 #if defined(BOARD_COUNTER_0_BASE) && defined(BOARD_COUNTER_0_IRQ) && defined(BOARD_COUNTER_0_IRQ_PRIO)
-os_counter_t freertos_counter_instance_0 = {
+os_counter_t freertos_counter_instance_0 OS_HOT_DATA = {
 	.base = BOARD_COUNTER_0_BASE,
 	.irqn = BOARD_COUNTER_0_IRQ,
 	.irq_prio = BOARD_COUNTER_0_IRQ_PRIO,
@@ -241,7 +273,7 @@ os_counter_t freertos_counter_instance_0 = {
 #endif
 
 #if defined(BOARD_COUNTER_1_BASE) && defined(BOARD_COUNTER_1_IRQ) && defined(BOARD_COUNTER_1_IRQ_PRIO)
-os_counter_t freertos_counter_instance_1 = {
+os_counter_t freertos_counter_instance_1 OS_HOT_DATA = {
 	.base = BOARD_COUNTER_1_BASE,
 	.irqn = BOARD_COUNTER_1_IRQ,
 	.irq_prio = BOARD_COUNTER_1_IRQ_PRIO,
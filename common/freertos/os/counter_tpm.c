@@ -6,6 +6,7 @@
 
 #include "os/counter.h"
 #include "os/irq.h"
+#include "os/section.h"
 
 #include "rtos_apps/log.h"
 #include "rtos_abstraction_layer.h"
@@ -16,9 +17,26 @@
 /* FIXME use fsl_clock to get the frequency */
 #define SOURCE_CLOCK_FREQ_HZ	24000000
 
+/* Output compare channels */
+#define TPM_NB_CHANNELS		4
+
+static const uint32_t tpm_chan_irq[TPM_NB_CHANNELS] = {
+	kTPM_Chnl0InterruptEnable,
+	kTPM_Chnl1InterruptEnable,
+	kTPM_Chnl2InterruptEnable,
+	kTPM_Chnl3InterruptEnable,
+};
+
+static const uint32_t tpm_chan_flag[TPM_NB_CHANNELS] = {
+	kTPM_Chnl0Flag,
+	kTPM_Chnl1Flag,
+	kTPM_Chnl2Flag,
+	kTPM_Chnl3Flag,
+};
+
 static int os_counter_tpm_get_value(const os_counter_t *dev, uint32_t *cnt);
 
-static int set_alarm(os_counter_t *dev, uint8_t chan_id,
+static int OS_HOT_TEXT set_alarm(os_counter_t *dev, uint8_t chan_id,
 		const struct os_counter_alarm_cfg *alarm_cfg)
 {
 	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
@@ -36,7 +54,7 @@ static int set_alarm(os_counter_t *dev, uint8_t chan_id,
 	return 0;
 }
 
-static void reset_alarm(os_counter_t *dev, uint8_t chan_id)
+static void OS_HOT_TEXT reset_alarm(os_counter_t *dev, uint8_t chan_id)
 {
 	struct os_counter_alarm_cfg *alarm = &dev->alarms[chan_id];
 
@@ -44,24 +62,25 @@ static void reset_alarm(os_counter_t *dev, uint8_t chan_id)
 	alarm->callback = NULL;
 }
 
-static void tpm_irq_ack(os_counter_t *dev, uint8_t chan_id)
+/* Interrupt enable register updates are read-modify-write, shared by all channels */
+static void OS_HOT_TEXT tpm_chan_disable(os_counter_t *dev, uint8_t chan_id)
 {
-	/* TODO: support multiple channels */
-	if (chan_id != kTPM_Chnl_0) {
-		/* TODO: support multiple channels */
-		log_err("Channel ID (%d) not supported!\n", chan_id);
+	unsigned int key = os_irq_lock();
 
-	} else {
-		TPM_DisableInterrupts((TPM_Type *)dev->base, kTPM_Chnl0InterruptEnable);
-		TPM_ClearStatusFlags((TPM_Type *)dev->base, kTPM_Chnl0Flag);
-	}
+	TPM_DisableInterrupts((TPM_Type *)dev->base, tpm_chan_irq[chan_id]);
+	TPM_ClearStatusFlags((TPM_Type *)dev->base, tpm_chan_flag[chan_id]);
+
+	os_irq_unlock(key);
 }
 
-static void tpm_irq_handler(void *irq_dev)
+static void OS_HOT_TEXT tpm_irq_handler(void *irq_dev)
 {
 	os_counter_t *dev = (os_counter_t *)irq_dev;
 	const struct os_counter_alarm_cfg *alarm;
-	uint8_t chan_id = kTPM_Chnl_0; /* TODO support multiple channels*/
+	void (*callback)(os_counter_t *dev, uint8_t chan_id, uint32_t irq_counter, void *user_data);
+	void *user_data;
+	uint32_t status;
+	uint8_t chan_id;
 	uint32_t now;
 	int ret;
 
@@ -69,14 +88,25 @@ static void tpm_irq_handler(void *irq_dev)
 	if (ret)
 		assert(true);
 
-	tpm_irq_ack(dev, chan_id);
+	status = TPM_GetStatusFlags((TPM_Type *)dev->base) &
+		 TPM_GetEnabledInterrupts((TPM_Type *)dev->base);
 
-	alarm = &dev->alarms[chan_id];
+	for (chan_id = 0; chan_id < TPM_NB_CHANNELS; chan_id++) {
+		if (!(status & tpm_chan_flag[chan_id]))
+			continue;
 
-	if (alarm->callback)
-		alarm->callback(dev, chan_id, now, alarm->user_data);
+		tpm_chan_disable(dev, chan_id);
 
-	reset_alarm(dev, chan_id);
+		alarm = &dev->alarms[chan_id];
+		callback = alarm->callback;
+		user_data = alarm->user_data;
+
+		/* Release the channel first, so that the callback can set a new alarm */
+		reset_alarm(dev, chan_id);
+
+		if (callback)
+			callback(dev, chan_id, now, user_data);
+	}
 }
 
 static void counter_init(os_counter_t *dev)
@@ -121,7 +151,7 @@ static int os_counter_tpm_stop(const os_counter_t *dev)
 	return 0;
 }
 
-static int os_counter_tpm_get_value(const os_counter_t *dev, uint32_t *cnt)
+static int OS_HOT_TEXT os_counter_tpm_get_value(const os_counter_t *dev, uint32_t *cnt)
 {
 	if (!cnt)
 		return -1;
@@ -131,35 +161,36 @@ static int os_counter_tpm_get_value(const os_counter_t *dev, uint32_t *cnt)
 	return 0;
 }
 
-static bool os_counter_tpm_is_counting_up(const os_counter_t *dev)
+static bool OS_HOT_TEXT os_counter_tpm_is_counting_up(const os_counter_t *dev)
 {
 	return true;
 }
 
-static uint32_t os_counter_tpm_get_frequency(const os_counter_t *dev)
+static uint32_t OS_HOT_TEXT os_counter_tpm_get_frequency(const os_counter_t *dev)
 {
 	return SOURCE_CLOCK_FREQ_HZ;
 }
 
-static uint32_t os_counter_tpm_get_top_value(const os_counter_t *dev)
+static uint32_t OS_HOT_TEXT os_counter_tpm_get_top_value(const os_counter_t *dev)
 {
 	return TPM_MAX_COUNTER_VALUE((TPM_Type *)dev->base);
 }
 
 static uint8_t os_counter_tpm_get_num_of_channels(const os_counter_t *dev)
 {
-	return NB_CHANNELS;
+	return TPM_NB_CHANNELS;
 }
 
 /*
  * After expiration alarm can be set again, disabling is not needed.
  * When alarm expiration handler is called, channel is considered available and can be set again in that context.
  */
-static int os_counter_tpm_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
+static int OS_HOT_TEXT os_counter_tpm_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		const struct os_counter_alarm_cfg *alarm_cfg)
 {
 	int ret = 0;
 	uint32_t current, next;
+	unsigned int key;
 
 	if (!alarm_cfg) {
 		log_err("Null pointer for channel ID (%d)\n", chan_id);
@@ -168,8 +199,7 @@ static int os_counter_tpm_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		goto exit;
 	}
 
-	if (chan_id != kTPM_Chnl_0) {
-		/* TODO: support multiple channels */
+	if (chan_id >= TPM_NB_CHANNELS) {
 		log_err("Channel ID (%d) not supported!\n", chan_id);
 
 		ret = -1;
@@ -192,27 +222,29 @@ static int os_counter_tpm_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
 		next += current;
 	}
 
-	TPM_EnableInterrupts((TPM_Type *)dev->base, kTPM_Chnl0InterruptEnable);
-	TPM_SetupOutputCompare((TPM_Type *)dev->base, kTPM_Chnl_0, kTPM_NoOutputSignal, next);
+	/* the flag of a disabled channel is still set on compare matches, clear it before enabling */
+	key = os_irq_lock();
+	TPM_ClearStatusFlags((TPM_Type *)dev->base, tpm_chan_flag[chan_id]);
+	TPM_SetupOutputCompare((TPM_Type *)dev->base, (tpm_chnl_t)chan_id, kTPM_NoOutputSignal, next);
+	TPM_EnableInterrupts((TPM_Type *)dev->base, tpm_chan_irq[chan_id]);
+	os_irq_unlock(key);
 
 exit:
 	return ret;
 }
 
-static int os_counter_tpm_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
+static int OS_HOT_TEXT os_counter_tpm_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id)
 {
 	int ret = 0;
 
-	if (chan_id != kTPM_Chnl_0) {
-		/* TODO: support multiple channels */
+	if (chan_id >= TPM_NB_CHANNELS) {
 		log_err("Channel ID (%d) not supported!\n", chan_id);
 
 		ret = -1;
 		goto exit;
 	}
 
-	TPM_DisableInterrupts((TPM_Type *)dev->base, kTPM_Chnl0InterruptEnable);
-	TPM_ClearStatusFlags((TPM_Type *)dev->base, kTPM_Chnl0Flag);
+	tpm_chan_disable(dev, chan_id);
 
 	reset_alarm(dev, chan_id);
 
@@ -235,7 +267,7 @@ static const struct os_counter_ops tpm_counter_ops = {
 #endif
 
 #if defined(BOARD_COUNTER_0_BASE) && defined(BOARD_COUNTER_0_IRQ) && defined(BOARD_COUNTER_0_IRQ_PRIO)
-os_counter_t freertos_counter_instance_0 = {
+os_counter_t freertos_counter_instance_0 OS_HOT_DATA = {
 	.base = BOARD_COUNTER_0_BASE,
 	.irqn = BOARD_COUNTER_0_IRQ,
 	.irq_prio = BOARD_COUNTER_0_IRQ_PRIO,
@@ -244,7 +276,7 @@ os_counter_t freertos_counter_instance_0 = {
 #endif
 
 #if defined(BOARD_COUNTER_1_BASE) && defined(BOARD_COUNTER_1_IRQ) && defined(BOARD_COUNTER_1_IRQ_PRIO)
-os_counter_t freertos_counter_instance_1 = {
+os_counter_t freertos_counter_instance_1 OS_HOT_DATA = {
 	.base = BOARD_COUNTER_1_BASE,
 	.irqn = BOARD_COUNTER_1_IRQ,
 	.irq_prio = BOARD_COUNTER_1_IRQ_PRIO,
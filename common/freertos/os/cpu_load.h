@@ -1,5 +1,5 @@
 /*
- * Copyright 2022 NXP
+ * Copyright 2022, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,5 +10,6 @@
 #include <idle.h>
 
 #define os_cpu_load_stats() cpu_load_stats()
+#define os_cpu_load_read(busy, total) cpu_load_read(busy, total)
 
 #endif /* #ifndef _FREERTOS_CPU_LOAD_H_ */
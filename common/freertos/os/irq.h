@@ -1,5 +1,5 @@
 /*
- * Copyright 2022 NXP
+ * Copyright 2022, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -31,6 +31,40 @@ static inline void os_irq_disable(unsigned int irq)
 	DisableIRQ(irq);
 }
 
+/* Mask the interrupts of the current core, returns the key to restore them */
+static inline unsigned int os_irq_lock(void)
+{
+	uint64_t daif;
+
+	__asm volatile ("mrs %0, daif; msr daifset, #2" : "=r" (daif) : : "memory");
+
+	return (unsigned int)daif;
+}
+
+static inline void os_irq_unlock(unsigned int key)
+{
+	__asm volatile ("msr daif, %0" : : "r" ((uint64_t)key) : "memory");
+}
+
+/*
+ * Raise software generated interrupt @sgi (0 to 15) on the current core
+ * (GICv3 ICC_SGI1R_EL1: target list of the current cluster, Aff0 < 16)
+ */
+static inline void os_irq_trigger_sgi(unsigned int sgi)
+{
+	uint64_t mpidr, sgi1r;
+
+	__asm volatile ("mrs %0, mpidr_el1" : "=r" (mpidr));
+
+	sgi1r = ((uint64_t)(sgi & 0xf) << 24) |
+		(((mpidr >> 32) & 0xff) << 48) |	/* Aff3 */
+		(((mpidr >> 16) & 0xff) << 32) |	/* Aff2 */
+		(((mpidr >> 8) & 0xff) << 16) |		/* Aff1 */
+		(1 << (mpidr & 0xf));			/* target list (Aff0) */
+
+	__asm volatile ("msr s3_0_c12_c11_5, %0; isb" : : "r" (sgi1r) : "memory");
+}
+
 #include "os/irq.h" /* include os priority abstractions from common/os/irq.h */
 
 #endif /* #ifndef _FREERTOS_IRQ_H_ */
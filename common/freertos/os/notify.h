@@ -0,0 +1,51 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FREERTOS_NOTIFY_H_
+#define _FREERTOS_NOTIFY_H_
+
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define OS_NOTIFY_NAME	"task notification"
+
+typedef struct {
+	TaskHandle_t task;
+} os_notify_t;
+
+static inline void os_notify_init(os_notify_t *notify)
+{
+	notify->task = xTaskGetCurrentTaskHandle();
+}
+
+static inline int os_notify_give(os_notify_t *notify)
+{
+	xTaskNotifyGive(notify->task);
+
+	return 0;
+}
+
+static inline int os_notify_give_from_isr(os_notify_t *notify, bool *yield)
+{
+	BaseType_t woken = pdFALSE;
+
+	vTaskNotifyGiveFromISR(notify->task, &woken);
+
+	*yield = (woken == pdTRUE);
+
+	return 0;
+}
+
+static inline int os_notify_take(os_notify_t *notify, uint32_t timeout_ms)
+{
+	TickType_t ticks = (timeout_ms == OS_NOTIFY_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+	return ulTaskNotifyTake(pdTRUE, ticks) ? 0 : -1;
+}
+
+#endif /* #ifndef _FREERTOS_NOTIFY_H_ */
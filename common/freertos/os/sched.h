@@ -0,0 +1,18 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _FREERTOS_SCHED_H_
+#define _FREERTOS_SCHED_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+static inline void os_sched_yield(void)
+{
+	taskYIELD();
+}
+
+#endif /* #ifndef _FREERTOS_SCHED_H_ */
@@ -14,7 +14,16 @@
 enum {
 	HRPN_CMD_TYPE_LATENCY_RUN = 0x0000,
 	HRPN_CMD_TYPE_LATENCY_STOP,
+	HRPN_CMD_TYPE_LATENCY_PING,
+	HRPN_CMD_TYPE_LATENCY_SOAK_READ,
 	HRPN_RESP_TYPE_LATENCY = 0x0010,
+	HRPN_RESP_TYPE_LATENCY_SAMPLES,
+	HRPN_RESP_TYPE_LATENCY_DONE,
+	HRPN_RESP_TYPE_LATENCY_TRACE,
+	HRPN_RESP_TYPE_LATENCY_PONG,
+	HRPN_RESP_TYPE_LATENCY_STATS,
+	HRPN_RESP_TYPE_LATENCY_HIST,
+	HRPN_RESP_TYPE_LATENCY_SOAK,
 
 	HRPN_CMD_TYPE_AUDIO_RUN = AUDIO_CMD_TYPE_RUN,
 	HRPN_CMD_TYPE_AUDIO_STOP = AUDIO_CMD_TYPE_STOP,
@@ -47,22 +56,113 @@ enum {
 	HRPN_CMD_TYPE_ETHERNET_RUN = 0x600,
 	HRPN_CMD_TYPE_ETHERNET_STOP,
 	HRPN_RESP_TYPE_INDUSTRIAL = 0x6ff,
+
+	HRPN_CMD_TYPE_TELEMETRY = 0x700,
+	HRPN_RESP_TYPE_TELEMETRY = 0x710,
+	HRPN_RESP_TYPE_TELEMETRY_DATA,
+
+	HRPN_CMD_TYPE_CAPS = 0x800,
+	HRPN_RESP_TYPE_CAPS = 0x810,
 };
 
+/*
+ * Message type word: message type in the low 16 bits, request id in the high
+ * 16 bits. The request id set by Linux in a command is echoed in the type
+ * word of its response, so that the responses of pipelined commands can be
+ * matched, in any order. Commands without request id (0), and unsolicited
+ * messages (raw samples, traces, statistics, end of run) have a 0 request id.
+ */
+#define HRPN_TYPE_MASK			0xffff
+#define HRPN_REQ_ID_SHIFT		16
+#define HRPN_REQ_ID_MAX			0xffff
+
+#define HRPN_TYPE(type)			((type) & HRPN_TYPE_MASK)
+#define HRPN_REQ_ID(type)		((type) >> HRPN_REQ_ID_SHIFT)
+#define HRPN_TYPE_REQ(type, req_id)	(HRPN_TYPE(type) | ((uint32_t)(req_id) << HRPN_REQ_ID_SHIFT))
+
 enum {
 	HRPN_RESP_STATUS_SUCCESS = 0,
 	HRPN_RESP_STATUS_ERROR = 1,
 };
 
+/* Latency test case id for a load given by struct hrpn_cmd_latency_run .load */
+#define HRPN_LATENCY_TEST_CASE_CUSTOM	0
+
+/* Latency test load conditions */
+#define HRPN_LATENCY_LOAD_IRQ		(1 << 1)	/* extra IRQ load from a second counter */
+#define HRPN_LATENCY_LOAD_CPU		(1 << 2)	/* CPU load in the lowest priority task */
+#define HRPN_LATENCY_LOAD_CPU_SEM	(1 << 3)	/* semaphore load in the CPU load task */
+#define HRPN_LATENCY_LOAD_INVD_CACHE	(1 << 4)	/* periodic cache invalidation */
+#define HRPN_LATENCY_LOAD_LINUX		(1 << 5)	/* Linux load */
+#define HRPN_LATENCY_LOAD_OCRAM		(1 << 6)	/* measurement code and statistics in OCRAM */
+#define HRPN_LATENCY_LOAD_MEM		(1 << 7)	/* memory interference in the lowest priority task */
+#define HRPN_LATENCY_LOAD_ALL		(HRPN_LATENCY_LOAD_IRQ | HRPN_LATENCY_LOAD_CPU | \
+					 HRPN_LATENCY_LOAD_CPU_SEM | HRPN_LATENCY_LOAD_INVD_CACHE | \
+					 HRPN_LATENCY_LOAD_LINUX | HRPN_LATENCY_LOAD_OCRAM | \
+					 HRPN_LATENCY_LOAD_MEM)
+
+enum {
+	HRPN_LATENCY_MODE_RELATIVE = 0,	/* alarm re-armed one period after each wake-up */
+	HRPN_LATENCY_MODE_PERIODIC,	/* alarms on a fixed t0 + n * period timeline */
+	HRPN_LATENCY_MODE_SCHED,	/* no alarm, task to task scheduling costs (HRPN_LATENCY_METRIC_SCHED_xxx) */
+};
+
+/* Memory interference load access patterns, over the footprint, one access per stride */
+enum {
+	HRPN_LATENCY_MEM_READ_WRITE = 0,	/* read-modify-write, in address order */
+	HRPN_LATENCY_MEM_READ,		/* reads, in address order */
+	HRPN_LATENCY_MEM_WRITE,		/* writes, in address order */
+	HRPN_LATENCY_MEM_RANDOM,	/* reads, in random order (defeats the hardware prefetchers) */
+	HRPN_LATENCY_MEM_PATTERN_MAX,
+};
+
 enum {
 	HRPN_PROTOCOL_CAN = 0,
 	HRPN_PROTOCOL_CAN_FD = 1,
 };
 
+/* Size of the Linux load profile tag, including the terminating null byte */
+#define HRPN_LATENCY_LINUX_LOAD_LEN	64
+
+/*
+ * Interrupt storm source: software generated interrupt raised at a fixed
+ * rate, with a busy loop handler. With nesting, the handler raises a second
+ * interrupt one priority level higher, and so on, up to @nest levels.
+ */
+#define HRPN_LATENCY_IRQ_STORM_SOURCES_MAX	4
+
+struct hrpn_latency_irq_source {
+	uint32_t period_us;	/* interrupt period */
+	uint32_t duration_us;	/* handler busy loop duration */
+	uint32_t prio;		/* OS interrupt priority (lower value is higher priority), 0: latency alarm priority */
+	uint32_t nest;		/* nested interrupts raised by the handler */
+};
+
+/* Parameters set to 0 take the RTOS application default value */
 struct hrpn_cmd_latency_run {
 	uint32_t type;
 	uint32_t id;
 	bool quiet;
+	uint32_t mode;
+	bool capture;		/* stream raw samples (HRPN_RESP_TYPE_LATENCY_SAMPLES messages) */
+	uint32_t load;		/* HRPN_LATENCY_LOAD_xxx mask, for HRPN_LATENCY_TEST_CASE_CUSTOM */
+	uint32_t period_us;	/* latency alarm period */
+	uint32_t irq_load_duration_us;	/* IRQ load handler busy loop duration */
+	uint32_t irq_load_period_us;	/* IRQ load period, 0: once just before each latency alarm */
+	uint32_t hist_sub_bits;	/* histogram resolution (log2 of linear sub-buckets per power of 2, plus 1) */
+	uint32_t duration_s;	/* test duration, 0: run until stopped */
+	char linux_load[HRPN_LATENCY_LINUX_LOAD_LEN];	/* Linux load profile run by harpoon_ctrl, empty if none */
+	uint32_t trace_threshold_us;	/* send the event trace on irq delays above this value, 0: disabled */
+	bool wakeup_matrix;	/* rotate the ISR to task wake-up over all primitives, add task to task wake-ups */
+	uint32_t cpu_mask;	/* cores running a benchmark task (SMP builds), 0: first core only */
+	uint32_t load_cpu_mask;	/* cores running the test case load tasks (SMP builds), 0: same as cpu_mask */
+	uint32_t irq_storm_count;	/* interrupt storm sources, 0: no storm */
+	struct hrpn_latency_irq_source irq_storm[HRPN_LATENCY_IRQ_STORM_SOURCES_MAX];
+	bool stats_report;	/* send the end of run statistics (HRPN_RESP_TYPE_LATENCY_STATS messages) */
+	uint32_t soak_window_s;	/* soak mode window (per-window statistics time series), 0: disabled */
+	uint32_t mem_size;	/* memory interference load footprint per load core (bytes) */
+	uint32_t mem_stride;	/* memory interference load stride (bytes) */
+	uint32_t mem_pattern;	/* memory interference load access pattern, HRPN_LATENCY_MEM_xxx */
 };
 
 struct hrpn_cmd_latency_stop {
@@ -74,6 +174,199 @@ struct hrpn_resp_latency {
 	uint32_t status;
 };
 
+/* Raw sample, in counter ticks */
+struct hrpn_latency_sample {
+	uint32_t prog;		/* programmed alarm time */
+	uint32_t irq;		/* counter value in the alarm IRQ handler */
+	uint32_t wakeup;	/* counter value when the benchmark task resumed */
+};
+
+#define HRPN_LATENCY_SAMPLES_MAX	32
+
+/* Unsolicited messages sent while a test case runs in capture mode */
+struct hrpn_resp_latency_samples {
+	uint32_t type;
+	uint32_t status;
+	uint32_t seq;		/* batch sequence number, to detect lost batches */
+	uint32_t dropped;	/* samples dropped so far (capture ring full) */
+	uint32_t frequency;	/* counter frequency (Hz) */
+	uint32_t count;		/* number of valid entries in samples[] */
+	struct hrpn_latency_sample samples[HRPN_LATENCY_SAMPLES_MAX];
+};
+
+/* Outlier tracer event types */
+enum {
+	HRPN_TRACE_EV_IRQ_ENTRY = 1,	/* arg: IRQ number, HRPN_TRACE_IRQ_UNKNOWN if not available */
+	HRPN_TRACE_EV_IRQ_EXIT,		/* arg: IRQ number, HRPN_TRACE_IRQ_UNKNOWN if not available */
+	HRPN_TRACE_EV_TICK,		/* arg: tick count */
+	HRPN_TRACE_EV_TASK_SWITCH,	/* arg: first 4 characters of the task name */
+	HRPN_TRACE_EV_CACHE_INVAL_ENTRY,
+	HRPN_TRACE_EV_CACHE_INVAL_EXIT,
+	HRPN_TRACE_EV_LATENCY_IRQ,	/* latency alarm handler */
+	HRPN_TRACE_EV_LATENCY_WAKEUP,	/* latency task wake-up, arg: irq delay (ns) */
+	HRPN_TRACE_EV_MAX,
+};
+
+#define HRPN_TRACE_IRQ_UNKNOWN		0xffffffff
+
+struct hrpn_trace_event {
+	uint64_t ts;		/* RTOS core generic timer count */
+	uint32_t type;
+	uint32_t arg;
+};
+
+#define HRPN_LATENCY_TRACE_EVENTS_MAX	24
+
+/*
+ * Unsolicited messages sent when an irq delay exceeds the trace threshold:
+ * the events that preceded the outlier, oldest first, split over several
+ * messages. The last event is the wake-up that measured the outlier.
+ */
+struct hrpn_resp_latency_trace {
+	uint32_t type;
+	uint32_t status;
+	uint32_t seq;		/* outlier sequence number */
+	uint32_t value;		/* outlier irq delay (ns) */
+	uint32_t frequency;	/* event timestamp frequency (Hz) */
+	uint32_t index;		/* index of events[0] in the trace */
+	uint32_t total;		/* number of events in the trace */
+	uint32_t count;		/* number of valid entries in events[] */
+	struct hrpn_trace_event events[HRPN_LATENCY_TRACE_EVENTS_MAX];
+};
+
+/* Latency statistics metrics */
+enum {
+	HRPN_LATENCY_METRIC_IRQ_DELAY = 0,	/* programmed alarm -> counter ISR */
+	HRPN_LATENCY_METRIC_IRQ_TO_SCHED,	/* counter ISR -> benchmark task running */
+	HRPN_LATENCY_METRIC_SCHED_SWITCH,	/* task blocks -> same priority task running */
+	HRPN_LATENCY_METRIC_SCHED_PREEMPT,	/* semaphore give -> higher priority task running */
+	HRPN_LATENCY_METRIC_SCHED_YIELD,	/* task yields -> same priority task running */
+	HRPN_LATENCY_METRIC_SCHED_MUTEX_PI,	/* mutex unlock by a boosted task -> higher priority owner running */
+	HRPN_LATENCY_METRIC_MAX,
+};
+
+/*
+ * Unsolicited messages sent at the end of a test case run with stats_report
+ * set, one per metric and per benchmark core (each followed by the metric
+ * histogram, HRPN_RESP_TYPE_LATENCY_HIST messages), before the test case end
+ * (HRPN_RESP_TYPE_LATENCY_DONE message, or response to the stop command).
+ * Values are in ns, over the whole test case.
+ */
+struct hrpn_resp_latency_stats {
+	uint32_t type;
+	uint32_t status;
+	uint32_t core;		/* core running the benchmark task */
+	uint32_t metric;	/* HRPN_LATENCY_METRIC_xxx */
+	uint64_t count;		/* number of samples */
+	uint32_t min;
+	uint32_t mean;
+	uint32_t max;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t p99_9;
+	uint32_t p99_99;
+	uint32_t p99_999;
+	uint32_t p99_9999;
+	uint32_t late_alarm_sched;	/* alarms missed (scheduled too late, benchmark task wait timed out) */
+};
+
+struct hrpn_latency_hist_bucket {
+	uint32_t index;		/* log-linear histogram bucket (common/libs/hdr_hist) */
+	uint32_t count;
+};
+
+#define HRPN_LATENCY_HIST_BUCKETS_MAX	48
+
+/*
+ * Unsolicited messages sent after each statistics message: the non-empty
+ * buckets of the metric histogram, in increasing order, split over several
+ * messages.
+ */
+struct hrpn_resp_latency_hist {
+	uint32_t type;
+	uint32_t status;
+	uint32_t core;
+	uint32_t metric;	/* HRPN_LATENCY_METRIC_xxx */
+	uint32_t sub_bits;	/* histogram resolution */
+	uint32_t index;		/* index of buckets[0] in the non-empty buckets */
+	uint32_t total;		/* number of non-empty buckets */
+	uint32_t count;		/* number of valid entries in buckets[] */
+	struct hrpn_latency_hist_bucket buckets[HRPN_LATENCY_HIST_BUCKETS_MAX];
+};
+
+/*
+ * Soak mode: statistics of the irq delay of the first benchmark core, per
+ * time window, kept in a ring of the latest windows. The ring can be read
+ * while the test case runs, and after it ended (until the next soak mode
+ * test case starts). Windows are closed on the generic timer, shared by
+ * Linux and the RTOS.
+ */
+struct hrpn_latency_soak_entry {
+	uint64_t start;		/* window start, generic timer count */
+	uint32_t duration_ms;	/* window duration (longer if no sample for a while, shorter for the last one) */
+	uint32_t count;		/* samples in the window */
+	uint32_t min;		/* irq delay (ns) */
+	uint32_t mean;
+	uint32_t max;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t p99_99;
+	uint32_t irq_to_sched_max;	/* ns */
+	uint32_t late_alarm_sched;	/* alarms missed in the window */
+};
+
+#define HRPN_LATENCY_SOAK_ENTRIES_MAX	9	/* fits in a 496 bytes RPMsg payload */
+
+struct hrpn_cmd_latency_soak_read {
+	uint32_t type;
+	uint32_t seq;		/* sequence number of the first window to read */
+};
+
+/*
+ * Answer to a soak read command: up to HRPN_LATENCY_SOAK_ENTRIES_MAX windows
+ * from the requested one, or from the oldest one still in the ring if it was
+ * overwritten.
+ */
+struct hrpn_resp_latency_soak {
+	uint32_t type;
+	uint32_t status;
+	uint32_t window_s;	/* window duration, 0 if no soak mode test case ran */
+	uint32_t seq;		/* sequence number of entries[0] */
+	uint32_t total;		/* windows recorded so far (sequence number of the next one) */
+	uint32_t missed;	/* windows not recorded (control task late) */
+	uint32_t count;		/* number of valid entries in entries[] */
+	uint32_t frequency;	/* generic timer frequency (Hz) */
+	uint64_t start;		/* test case start, generic timer count */
+	struct hrpn_latency_soak_entry entries[HRPN_LATENCY_SOAK_ENTRIES_MAX];
+};
+
+/*
+ * IPC round trip benchmark: pings are echoed by the latency application
+ * control endpoint, and by a dedicated task on the IPC endpoint (raw rpmsg
+ * path). Timestamps are generic timer counts, shared by Linux and the RTOS.
+ */
+#define HRPN_LATENCY_IPC_EPT		31
+#define HRPN_LATENCY_PING_PAYLOAD_MAX	256
+
+struct hrpn_cmd_latency_ping {
+	uint32_t type;
+	uint32_t seq;
+	uint64_t ts_send;	/* Linux generic timer count when sent */
+	uint32_t len;		/* payload length, the message is truncated after it */
+	uint8_t payload[HRPN_LATENCY_PING_PAYLOAD_MAX];
+};
+
+struct hrpn_resp_latency_pong {
+	uint32_t type;
+	uint32_t status;
+	uint32_t seq;		/* ping sequence number */
+	uint32_t len;		/* payload length (ping payload echoed), the message is truncated after it */
+	uint64_t ts_mbox;	/* RTOS generic timer count at the latest mailbox interrupt, 0 if not available */
+	uint64_t ts_recv;	/* RTOS generic timer count when the ping was received by the RTOS task */
+	uint64_t ts_send;	/* RTOS generic timer count when the pong was sent */
+	uint8_t payload[HRPN_LATENCY_PING_PAYLOAD_MAX];
+};
+
 /* Industrial application commands */
 struct hrpn_cmd_industrial_run {
 	uint32_t type;
@@ -116,13 +409,154 @@ struct hrpn_cmd_ethernet {
 	} u;
 };
 
-struct hrpn_cmd {
+/*
+ * Telemetry: runtime counters pushed by the RTOS application on a dedicated
+ * endpoint, at the period set by the telemetry command (sent on that endpoint,
+ * 0 period to stop). A snapshot of the counters is sent in one or more
+ * HRPN_RESP_TYPE_TELEMETRY_DATA messages with the same sequence number, the
+ * last one flagged with HRPN_TELEMETRY_LAST.
+ */
+#define HRPN_TELEMETRY_EPT		32
+#define HRPN_TELEMETRY_PERIOD_MIN_MS	100
+#define HRPN_TELEMETRY_PERIOD_MAX_MS	3600000
+
+enum {
+	HRPN_TELEMETRY_SOURCE_SYSTEM = 0,
+	HRPN_TELEMETRY_SOURCE_LATENCY,
+	HRPN_TELEMETRY_SOURCE_CAN,
+	HRPN_TELEMETRY_SOURCE_MAX,
+};
+
+/* System counters */
+enum {
+	HRPN_TELEMETRY_SYSTEM_CPU_LOAD = 0,	/* since the previous snapshot, in 0.01% */
+	HRPN_TELEMETRY_SYSTEM_HEAP_USED,	/* bytes */
+	HRPN_TELEMETRY_SYSTEM_HEAP_FREE,
+	HRPN_TELEMETRY_SYSTEM_HEAP_MIN_FREE,
+	HRPN_TELEMETRY_SYSTEM_MAX,
+};
+
+/* Latency test case counters, the instance is the core (ns unless noted) */
+enum {
+	HRPN_TELEMETRY_LATENCY_COUNT = 0,	/* samples */
+	HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MIN,
+	HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MEAN,
+	HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MAX,
+	HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MIN,
+	HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MEAN,
+	HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MAX,
+	HRPN_TELEMETRY_LATENCY_LATE_ALARM_SCHED,	/* count */
+	HRPN_TELEMETRY_LATENCY_MAX,
+};
+
+/* CAN counters, the instance is the message buffer (HRPN_TELEMETRY_INSTANCE_NONE for the controller) */
+enum {
+	HRPN_TELEMETRY_CAN_BITRATE = 0,		/* bit/s */
+	HRPN_TELEMETRY_CAN_GLOBAL_IRQ,
+	HRPN_TELEMETRY_CAN_TX_IRQ,
+	HRPN_TELEMETRY_CAN_TX,
+	HRPN_TELEMETRY_CAN_TX_BUSY,
+	HRPN_TELEMETRY_CAN_TX_FAIL,
+	HRPN_TELEMETRY_CAN_RX_IRQ,
+	HRPN_TELEMETRY_CAN_RX,
+	HRPN_TELEMETRY_CAN_RX_OVERFLOW,
+	HRPN_TELEMETRY_CAN_RX_FAIL,
+	HRPN_TELEMETRY_CAN_MAX,
+};
+
+#define HRPN_TELEMETRY_INSTANCE_NONE	0xff
+
+struct hrpn_cmd_telemetry {
 	uint32_t type;
+	uint32_t period_ms;	/* 0: stop */
 };
 
-struct hrpn_resp {
+struct hrpn_resp_telemetry {
 	uint32_t type;
 	uint32_t status;
+	uint32_t period_ms;	/* period applied */
+};
+
+struct hrpn_telemetry_value {
+	uint16_t id;		/* HRPN_TELEMETRY_<source>_* */
+	uint8_t source;		/* HRPN_TELEMETRY_SOURCE_* */
+	uint8_t instance;
+	uint32_t value;		/* counters wrap around */
+};
+
+#define HRPN_TELEMETRY_VALUES_MAX	60	/* fits in a 496 bytes RPMsg payload */
+#define HRPN_TELEMETRY_LAST		(1 << 0)
+
+struct hrpn_resp_telemetry_data {
+	uint32_t type;
+	uint32_t seq;		/* snapshot sequence number */
+	uint32_t time_ms;	/* snapshot time, since the telemetry start */
+	uint16_t count;		/* number of valid entries in values[] */
+	uint16_t flags;
+	struct hrpn_telemetry_value values[HRPN_TELEMETRY_VALUES_MAX];
+};
+
+/*
+ * Capabilities: version, features and parameter ranges of the running RTOS
+ * application, answered on the control endpoint by all applications. The
+ * fields of the features not supported are 0.
+ */
+#define HRPN_CAPS_VERSION(major, medium, minor)	(((major) << 16) | ((medium) << 8) | (minor))
+
+#define HRPN_CAPS_FEATURE_REQ_ID	(1 << 0)	/* request ids echoed (pipelined commands) */
+#define HRPN_CAPS_FEATURE_TELEMETRY	(1 << 1)	/* telemetry endpoint */
+#define HRPN_CAPS_FEATURE_LATENCY	(1 << 2)
+#define HRPN_CAPS_FEATURE_AUDIO		(1 << 3)
+#define HRPN_CAPS_FEATURE_CAN		(1 << 4)
+#define HRPN_CAPS_FEATURE_ETHERNET	(1 << 5)
+
+#define HRPN_CAPS_AUDIO_CONFIGS_MAX	2	/* audio_cmd_run .index: 0 default, 1 audio HAT */
+#define HRPN_CAPS_AUDIO_RATES_MAX	8
+#define HRPN_CAPS_AUDIO_PERIODS_MAX	8
+
+struct hrpn_caps_audio_config {
+	uint32_t modes;		/* bit n set: audio_cmd_run .mode n supported */
+	uint32_t rate_count;
+	uint32_t rates[HRPN_CAPS_AUDIO_RATES_MAX];	/* Hz */
+};
+
+struct hrpn_cmd_caps {
+	uint32_t type;
+};
+
+struct hrpn_resp_caps {
+	uint32_t type;
+	uint32_t status;
+	uint32_t version;		/* HRPN_CAPS_VERSION() */
+	uint32_t features;		/* HRPN_CAPS_FEATURE_* */
+
+	/* latency */
+	uint32_t latency_test_cases;	/* test case ids below this value */
+	uint32_t latency_loads;		/* HRPN_LATENCY_LOAD_* accepted by the custom test case */
+	uint32_t latency_modes;		/* HRPN_LATENCY_MODE_* ids below this value */
+	uint32_t latency_period_us_min;
+	uint32_t latency_period_us_max;
+	uint32_t latency_cpu_mask;	/* cores available to the benchmark and load tasks */
+	uint32_t latency_mem_size_max;	/* memory load footprint, per core */
+
+	/* audio */
+	uint32_t audio_config_count;
+	struct hrpn_caps_audio_config audio_config[HRPN_CAPS_AUDIO_CONFIGS_MAX];
+	uint32_t audio_period_count;
+	uint32_t audio_periods[HRPN_CAPS_AUDIO_PERIODS_MAX];	/* frames */
+
+	/* industrial, run mode ids below these values */
+	uint32_t can_modes;
+	uint32_t ethernet_modes;
+};
+
+struct hrpn_cmd {
+	uint32_t type;		/* HRPN_TYPE_REQ(type, request id) */
+};
+
+struct hrpn_resp {
+	uint32_t type;		/* HRPN_TYPE_REQ(type, request id of the command) */
+	uint32_t status;
 };
 
 struct hrpn_command {
@@ -130,12 +564,16 @@ struct hrpn_command {
 		struct hrpn_cmd cmd;
 		struct hrpn_cmd_latency_run latency_run;
 		struct hrpn_cmd_latency_stop latency_stop;
+		struct hrpn_cmd_latency_ping latency_ping;
+		struct hrpn_cmd_latency_soak_read latency_soak_read;
 		struct audio_cmd_run audio_run;
 		struct audio_cmd_stop audio_stop;
 		struct audio_cmd_pipeline audio_pipeline;
 		struct hrpn_cmd_industrial_run industrial_run;
 		struct hrpn_cmd_industrial_stop industrial_stop;
 		struct hrpn_cmd_ethernet ethernet;
+		struct hrpn_cmd_telemetry telemetry;
+		struct hrpn_cmd_caps caps;
 	} u;
 };
 
@@ -143,8 +581,17 @@ struct hrpn_response {
 	union {
 		struct hrpn_resp resp;
 		struct hrpn_resp_latency latency;
+		struct hrpn_resp_latency_samples latency_samples;
+		struct hrpn_resp_latency_trace latency_trace;
+		struct hrpn_resp_latency_pong latency_pong;
+		struct hrpn_resp_latency_stats latency_stats;
+		struct hrpn_resp_latency_hist latency_hist;
+		struct hrpn_resp_latency_soak latency_soak;
 		struct audio_resp audio;
 		struct hrpn_resp_industrial industrial;
+		struct hrpn_resp_telemetry telemetry;
+		struct hrpn_resp_telemetry_data telemetry_data;
+		struct hrpn_resp_caps caps;
 	} u;
 };
 
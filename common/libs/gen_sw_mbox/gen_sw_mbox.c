@@ -8,6 +8,7 @@
 
 #include "os/irq.h"
 #include "os/mmu.h"
+#include "os/trace.h"
 
 #include "fsl_device_registers.h"
 
@@ -76,6 +77,7 @@ struct gen_sw_mbox {
 	struct gen_sw_mbox_chan chan[MAX_CH];
 	int ref_cnt;
 	rtos_sem_t lock;
+	uint64_t rx_ts; /* generic timer count of the latest received message */
 };
 
 static struct gen_sw_mbox *mbox_inst[MBOX_MAX_INST];
@@ -131,6 +133,8 @@ static void gen_sw_mbox_handler(void *data)
 		if (mmio->rx_status[i] != S_BUSY)
 			continue;
 
+		mbox->rx_ts = os_trace_timestamp();
+
 		msg = mmio->rx_ch[i];
 		__DSB();
 		mmio->rx_status[i] = S_DONE;
@@ -184,6 +188,24 @@ int gen_sw_mbox_sendmsg(void *base, uint32_t ch, uint32_t msg, bool block)
 	return 0;
 }
 
+/*
+ * Generic timer count when the latest message was received (mailbox
+ * interrupt), 0 if none, for IPC latency measurements.
+ */
+uint64_t gen_sw_mbox_rx_timestamp(void *base)
+{
+	struct gen_sw_mbox *mbox;
+	uint64_t ts = 0;
+
+	rtos_sem_take(&gen_sw_mbox_semaphore, RTOS_WAIT_FOREVER);
+	mbox = gen_sw_mbox_get_instance(base);
+	if (mbox)
+		ts = mbox->rx_ts;
+	rtos_sem_give(&gen_sw_mbox_semaphore);
+
+	return ts;
+}
+
 int gen_sw_mbox_register_chan_callback(void *base, uint32_t ch,
 				       void (*recv_cb)(void *data, uint32_t msg),
 				       void *data)
@@ -304,6 +326,7 @@ int gen_sw_mbox_register(void *base, int irq, int remote_irq, uint32_t irq_prio)
 
 	mbox->irq = irq;
 	mbox->remote_irq = remote_irq;
+	mbox->rx_ts = 0;
 
 	mbox->mmio_pa = base;
 	if (os_mmu_map("MBOX", (uint8_t **)&mbox->mmio,
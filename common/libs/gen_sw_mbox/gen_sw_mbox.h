@@ -14,5 +14,6 @@ int gen_sw_mbox_unregister(void *base);
 int gen_sw_mbox_register_chan_callback(void *base, uint32_t ch, void (*recv_cb)(void *data, uint32_t msg), void *data);
 int gen_sw_mbox_unregister_chan_callback(void *base, uint32_t ch);
 int gen_sw_mbox_sendmsg(void *base, uint32_t ch, uint32_t msg, bool block);
+uint64_t gen_sw_mbox_rx_timestamp(void *base);
 
 #endif /* GEN_SW_MBOX_H_ */
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include "hdr_hist.h"
+
+int hdr_hist_init(struct hdr_hist *h, const char *name, unsigned int sub_bits)
+{
+	if ((sub_bits < HDR_HIST_SUB_BITS_MIN) || (sub_bits > HDR_HIST_SUB_BITS_MAX))
+		return -1;
+
+	h->name = name;
+	h->sub_bits = sub_bits;
+	hdr_hist_reset(h);
+
+	return 0;
+}
+
+void hdr_hist_reset(struct hdr_hist *h)
+{
+	memset(h->count, 0, sizeof(h->count));
+	h->total = 0;
+	h->sum = 0;
+	h->overflow = 0;
+	h->min = UINT32_MAX;
+	h->max = 0;
+}
+
+int hdr_hist_merge(struct hdr_hist *dst, const struct hdr_hist *src)
+{
+	unsigned int i;
+
+	if (dst->sub_bits != src->sub_bits)
+		return -1;
+
+	for (i = 0; i < HDR_HIST_BUCKETS(src->sub_bits); i++)
+		dst->count[i] += src->count[i];
+
+	dst->total += src->total;
+	dst->sum += src->sum;
+	dst->overflow += src->overflow;
+
+	if (src->min < dst->min)
+		dst->min = src->min;
+
+	if (src->max > dst->max)
+		dst->max = src->max;
+
+	return 0;
+}
+
+/* Buckets up to the highest non-empty one, the following ones are all zero */
+static unsigned int hdr_hist_used(const struct hdr_hist *h)
+{
+	return h->total ? hdr_hist_index(h, h->max) + 1 : 0;
+}
+
+/*
+ * Same as a structure copy, but only the buckets in use are copied: latency
+ * histograms only fill their first few hundred buckets. The buckets of @dst
+ * above the copied ones are cleared, @dst must be a valid histogram.
+ */
+void hdr_hist_copy(struct hdr_hist *dst, const struct hdr_hist *src)
+{
+	unsigned int used = hdr_hist_used(src);
+	unsigned int dst_used = hdr_hist_used(dst);
+
+	memcpy(dst->count, src->count, used * sizeof(src->count[0]));
+	if (dst_used > used)
+		memset(&dst->count[used], 0, (dst_used - used) * sizeof(dst->count[0]));
+
+	dst->name = src->name;
+	dst->sub_bits = src->sub_bits;
+	dst->min = src->min;
+	dst->max = src->max;
+	dst->total = src->total;
+	dst->sum = src->sum;
+	dst->overflow = src->overflow;
+}
+
+uint32_t hdr_hist_bucket_low(const struct hdr_hist *h, unsigned int idx)
+{
+	unsigned int half = 1U << (h->sub_bits - 1);
+	unsigned int shift;
+
+	if (idx < (1U << h->sub_bits))
+		return idx;
+
+	shift = idx / half - 1;
+
+	return (uint32_t)(idx - shift * half) << shift;
+}
+
+uint32_t hdr_hist_bucket_high(const struct hdr_hist *h, unsigned int idx)
+{
+	unsigned int half = 1U << (h->sub_bits - 1);
+	unsigned int shift;
+
+	if (idx < (1U << h->sub_bits))
+		return idx;
+
+	shift = idx / half - 1;
+
+	return hdr_hist_bucket_low(h, idx) + ((1U << shift) - 1);
+}
+
+/*
+ * Smallest value such that at least ppm / 1000000 of the samples are lower
+ * or equal to it. The upper bound of the matching bucket is reported (so the
+ * result is never optimistic), clamped to the largest recorded value.
+ */
+uint32_t hdr_hist_value_at_ppm(const struct hdr_hist *h, uint32_t ppm)
+{
+	uint64_t rank, cumul = 0;
+	uint32_t val;
+	unsigned int i;
+
+	if (!h->total)
+		return 0;
+
+	if (ppm > 1000000)
+		ppm = 1000000;
+
+	rank = (h->total * ppm + 999999) / 1000000;
+	if (!rank)
+		rank = 1;
+
+	for (i = 0; i < HDR_HIST_BUCKETS(h->sub_bits); i++) {
+		cumul += h->count[i];
+		if (cumul >= rank)
+			break;
+	}
+
+	if (i == HDR_HIST_BUCKETS(h->sub_bits))
+		return h->max;
+
+	val = hdr_hist_bucket_high(h, i);
+	if (val > h->max)
+		val = h->max;
+
+	if (val < h->min)
+		val = h->min;
+
+	return val;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _HDR_HIST_H_
+#define _HDR_HIST_H_
+
+#include <stdint.h>
+
+/*
+ * Log-linear (HDR style) histogram of 32-bit values.
+ *
+ * Values below 2^sub_bits get one bucket each. Above, every power of two
+ * range is split in 2^(sub_bits - 1) linear sub-buckets, so the relative
+ * error of any reported value stays below 2^-(sub_bits - 1) whatever its
+ * magnitude (< 1.6% with the default 7 bits).
+ *
+ * Memory is bounded (fixed size structure), an update is a few arithmetic
+ * operations, and two histograms with the same sub_bits can be merged.
+ */
+#define HDR_HIST_VALUE_BITS	32
+#define HDR_HIST_SUB_BITS_MIN	2
+#define HDR_HIST_SUB_BITS_MAX	7
+#define HDR_HIST_SUB_BITS	HDR_HIST_SUB_BITS_MAX
+
+#define HDR_HIST_BUCKETS(sub_bits)	((HDR_HIST_VALUE_BITS - (sub_bits) + 2) << ((sub_bits) - 1))
+#define HDR_HIST_BUCKETS_MAX		HDR_HIST_BUCKETS(HDR_HIST_SUB_BITS_MAX)
+
+/* Percentile ranks, in parts per million of the samples */
+#define HDR_HIST_PPM_P50	500000
+#define HDR_HIST_PPM_P99	990000
+#define HDR_HIST_PPM_P99_9	999000
+#define HDR_HIST_PPM_P99_99	999900
+#define HDR_HIST_PPM_P99_999	999990
+#define HDR_HIST_PPM_P99_9999	999999
+
+struct hdr_hist {
+	const char *name;
+	uint32_t sub_bits;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;		/* number of samples */
+	uint64_t sum;		/* sum of the samples, for the mean */
+	uint64_t overflow;	/* samples above UINT32_MAX, accounted in the last bucket */
+	uint32_t count[HDR_HIST_BUCKETS_MAX];
+};
+
+static inline unsigned int hdr_hist_index(const struct hdr_hist *h, uint32_t val)
+{
+	unsigned int shift;
+
+	if (val < (1U << h->sub_bits))
+		return val;
+
+	shift = (31 - __builtin_clz(val)) - h->sub_bits + 1;
+
+	return (shift << (h->sub_bits - 1)) + (val >> shift);
+}
+
+static inline void hdr_hist_update(struct hdr_hist *h, uint64_t val)
+{
+	uint32_t v;
+
+	if (val > UINT32_MAX) {
+		h->overflow++;
+		v = UINT32_MAX;
+	} else {
+		v = val;
+	}
+
+	h->count[hdr_hist_index(h, v)]++;
+	h->total++;
+	h->sum += v;
+
+	if (v < h->min)
+		h->min = v;
+
+	if (v > h->max)
+		h->max = v;
+}
+
+static inline uint32_t hdr_hist_mean(const struct hdr_hist *h)
+{
+	return h->total ? h->sum / h->total : 0;
+}
+
+int hdr_hist_init(struct hdr_hist *h, const char *name, unsigned int sub_bits);
+void hdr_hist_reset(struct hdr_hist *h);
+int hdr_hist_merge(struct hdr_hist *dst, const struct hdr_hist *src);
+void hdr_hist_copy(struct hdr_hist *dst, const struct hdr_hist *src);
+uint32_t hdr_hist_bucket_low(const struct hdr_hist *h, unsigned int idx);
+uint32_t hdr_hist_bucket_high(const struct hdr_hist *h, unsigned int idx);
+uint32_t hdr_hist_value_at_ppm(const struct hdr_hist *h, uint32_t ppm);
+
+#endif /* _HDR_HIST_H_ */
@@ -0,0 +1,11 @@
+# Description: lib providing a log-linear (HDR) histogram
+include_guard(GLOBAL)
+message("lib_hdr_hist component is included.")
+
+target_sources(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/hdr_hist.c
+)
+
+target_include_directories(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/.
+)
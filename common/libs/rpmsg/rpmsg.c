@@ -25,12 +25,16 @@ int rpmsg_send(struct rpmsg_ept *ept, void *data, uint32_t len)
 	return ret;
 }
 
-int rpmsg_recv(struct rpmsg_ept *ept, void *data, uint32_t *len)
+/*
+ * Wait up to @timeout_ms for a message (RL_BLOCK: forever, RL_DONT_BLOCK: no
+ * wait), RL_ERR_NO_BUFF is returned on timeout.
+ */
+int rpmsg_recv_timeout(struct rpmsg_ept *ept, void *data, uint32_t *len, uint32_t timeout_ms)
 {
 	uint32_t msg_src_addr;
 	int32_t ret;
 
-	ret = rpmsg_queue_recv(ept->ri->rl_inst, ept->ept_q, (uint32_t *)&msg_src_addr, (char *)data, *len, len, RL_DONT_BLOCK);
+	ret = rpmsg_queue_recv(ept->ri->rl_inst, ept->ept_q, (uint32_t *)&msg_src_addr, (char *)data, *len, len, timeout_ms);
 	if (ret != RL_SUCCESS) {
 		if (ret != RL_ERR_NO_BUFF)
 			log_err("rpmsg_queue_recv() failed\n");
@@ -46,6 +50,11 @@ int rpmsg_recv(struct rpmsg_ept *ept, void *data, uint32_t *len)
 	return ret;
 }
 
+int rpmsg_recv(struct rpmsg_ept *ept, void *data, uint32_t *len)
+{
+	return rpmsg_recv_timeout(ept, data, len, RL_DONT_BLOCK);
+}
+
 struct rpmsg_ept *rpmsg_create_ept(struct rpmsg_instance *ri, int ept_addr, const char *sn)
 {
 	struct rpmsg_ept *ept;
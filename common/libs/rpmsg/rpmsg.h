@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 NXP
+ * Copyright 2022-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -31,6 +31,7 @@ struct rpmsg_ept *rpmsg_create_ept(struct rpmsg_instance *ri, int ept_addr, cons
 int rpmsg_destroy_ept(struct rpmsg_ept *ept);
 int rpmsg_send(struct rpmsg_ept *ept, void *data, uint32_t len);
 int rpmsg_recv(struct rpmsg_ept *ept, void *data, uint32_t *len);
+int rpmsg_recv_timeout(struct rpmsg_ept *ept, void *data, uint32_t *len, uint32_t timeout_ms);
 struct rpmsg_ept *rpmsg_transport_init(int link_id, int ept_addr, const char *sn);
 
 #endif /* _RPMSG_H_ */
@@ -0,0 +1,11 @@
+# Description: lib pushing runtime counters to Linux on a dedicated RPMsg endpoint
+include_guard(GLOBAL)
+message("lib_telemetry component is included.")
+
+target_sources(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/telemetry.c
+)
+
+target_include_directories(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/.
+)
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "rtos_apps/log.h"
+#include "os/cpu_load.h"
+
+#if defined(FSL_RTOS_FREE_RTOS)
+#include "FreeRTOS.h"
+#endif
+
+#include "telemetry.h"
+
+static void telemetry_response(struct telemetry *t, uint32_t req_id, uint32_t status)
+{
+	struct hrpn_resp_telemetry resp;
+
+	resp.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_TELEMETRY, req_id);
+	resp.status = status;
+	resp.period_ms = t->period_ms;
+	rpmsg_send(t->ept, &resp, sizeof(resp));
+}
+
+static void telemetry_command(struct telemetry *t)
+{
+	struct hrpn_command cmd;
+	uint32_t period_ms;
+	uint32_t req_id;
+	uint32_t len;
+
+	len = sizeof(cmd);
+	if (rpmsg_recv(t->ept, &cmd, &len) < 0)
+		return;
+
+	/* echoed in the response */
+	req_id = HRPN_REQ_ID(cmd.u.cmd.type);
+
+	if ((HRPN_TYPE(cmd.u.cmd.type) != HRPN_CMD_TYPE_TELEMETRY) || (len != sizeof(struct hrpn_cmd_telemetry))) {
+		telemetry_response(t, req_id, HRPN_RESP_STATUS_ERROR);
+		return;
+	}
+
+	period_ms = cmd.u.telemetry.period_ms;
+	if (period_ms && ((period_ms < HRPN_TELEMETRY_PERIOD_MIN_MS) || (period_ms > HRPN_TELEMETRY_PERIOD_MAX_MS))) {
+		log_err("invalid telemetry period: %u ms\n", period_ms);
+		telemetry_response(t, req_id, HRPN_RESP_STATUS_ERROR);
+		return;
+	}
+
+	if (period_ms && !t->period_ms) {
+		/* first snapshot at the next poll */
+		t->elapsed_ms = period_ms;
+		t->time_ms = 0;
+		t->seq = 0;
+		os_cpu_load_read(&t->cpu_busy, &t->cpu_total);
+	}
+
+	t->period_ms = period_ms;
+
+	log_info("telemetry period: %u ms\n", period_ms);
+
+	telemetry_response(t, req_id, HRPN_RESP_STATUS_SUCCESS);
+}
+
+static void telemetry_flush(struct telemetry *t, uint16_t flags)
+{
+	uint32_t len;
+	int err;
+
+	t->msg.flags = flags;
+
+	len = offsetof(struct hrpn_resp_telemetry_data, values) + t->msg.count * sizeof(t->msg.values[0]);
+
+	err = rpmsg_send(t->ept, &t->msg, len);
+	if (err) {
+		log_err("rpmsg_send() failed (err: %d), telemetry stopped\n", err);
+		t->period_ms = 0;
+	}
+
+	t->msg.count = 0;
+}
+
+static void telemetry_system(struct telemetry *t)
+{
+	uint64_t busy, total;
+#if defined(FSL_RTOS_FREE_RTOS) && defined(configTOTAL_HEAP_SIZE)
+	size_t free_heap;
+#endif
+
+	if (!os_cpu_load_read(&busy, &total)) {
+		if (total > t->cpu_total)
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_SYSTEM, HRPN_TELEMETRY_INSTANCE_NONE,
+				      HRPN_TELEMETRY_SYSTEM_CPU_LOAD,
+				      ((busy - t->cpu_busy) * 10000) / (total - t->cpu_total));
+
+		t->cpu_busy = busy;
+		t->cpu_total = total;
+	}
+
+#if defined(FSL_RTOS_FREE_RTOS) && defined(configTOTAL_HEAP_SIZE)
+	free_heap = xPortGetFreeHeapSize();
+
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_SYSTEM, HRPN_TELEMETRY_INSTANCE_NONE,
+		      HRPN_TELEMETRY_SYSTEM_HEAP_USED, configTOTAL_HEAP_SIZE - free_heap);
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_SYSTEM, HRPN_TELEMETRY_INSTANCE_NONE,
+		      HRPN_TELEMETRY_SYSTEM_HEAP_FREE, free_heap);
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_SYSTEM, HRPN_TELEMETRY_INSTANCE_NONE,
+		      HRPN_TELEMETRY_SYSTEM_HEAP_MIN_FREE, xPortGetMinimumEverFreeHeapSize());
+#endif
+}
+
+void telemetry_add(struct telemetry *t, uint8_t source, uint8_t instance, uint16_t id, uint32_t value)
+{
+	struct hrpn_telemetry_value *v;
+
+	if (t->msg.count == HRPN_TELEMETRY_VALUES_MAX)
+		telemetry_flush(t, 0);
+
+	v = &t->msg.values[t->msg.count++];
+	v->id = id;
+	v->source = source;
+	v->instance = instance;
+	v->value = value;
+}
+
+/* Sends the last message of the snapshot */
+void telemetry_send(struct telemetry *t)
+{
+	telemetry_flush(t, HRPN_TELEMETRY_LAST);
+}
+
+/*
+ * Handles the telemetry commands, and starts a snapshot (with the system
+ * counters) once the telemetry period elapsed: returns true if the caller must
+ * add its counters and send it. @elapsed_ms is the time since the previous
+ * call (the control task poll period).
+ */
+bool telemetry_poll(struct telemetry *t, uint32_t elapsed_ms)
+{
+	telemetry_command(t);
+
+	if (!t->period_ms)
+		return false;
+
+	t->time_ms += elapsed_ms;
+	t->elapsed_ms += elapsed_ms;
+
+	if (t->elapsed_ms < t->period_ms)
+		return false;
+
+	/* no burst of snapshots if polled late */
+	t->elapsed_ms -= t->period_ms;
+	if (t->elapsed_ms >= t->period_ms)
+		t->elapsed_ms = 0;
+
+	t->seq++;
+
+	t->msg.type = HRPN_RESP_TYPE_TELEMETRY_DATA;
+	t->msg.seq = t->seq;
+	t->msg.time_ms = t->time_ms;
+	t->msg.count = 0;
+
+	telemetry_system(t);
+
+	return true;
+}
+
+int telemetry_init(struct telemetry *t, struct rpmsg_instance *ri)
+{
+	memset(t, 0, sizeof(*t));
+
+	t->ept = rpmsg_create_ept(ri, HRPN_TELEMETRY_EPT, "rpmsg-raw");
+	if (!t->ept) {
+		log_err("rpmsg_create_ept() failed\n");
+		return -1;
+	}
+
+	return 0;
+}
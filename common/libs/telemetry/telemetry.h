@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hrpn_ctrl.h"
+#include "rpmsg.h"
+
+/*
+ * Telemetry push channel (see HRPN_TELEMETRY_EPT): polled by the control task
+ * of the application, which adds its own counters to each snapshot.
+ *
+ *	if (telemetry_poll(&t, CONTROL_POLL_PERIOD)) {
+ *		telemetry_add(&t, HRPN_TELEMETRY_SOURCE_..., instance, id, value);
+ *		...
+ *		telemetry_send(&t);
+ *	}
+ */
+struct telemetry {
+	struct rpmsg_ept *ept;
+	uint32_t period_ms;	/* 0: stopped */
+	uint32_t elapsed_ms;	/* since the previous snapshot */
+	uint32_t time_ms;	/* since the telemetry start */
+	uint32_t seq;
+
+	/* CPU load of the previous snapshot */
+	uint64_t cpu_busy;
+	uint64_t cpu_total;
+
+	struct hrpn_resp_telemetry_data msg;
+};
+
+int telemetry_init(struct telemetry *t, struct rpmsg_instance *ri);
+bool telemetry_poll(struct telemetry *t, uint32_t elapsed_ms);
+void telemetry_add(struct telemetry *t, uint8_t source, uint8_t instance, uint16_t id, uint32_t value);
+void telemetry_send(struct telemetry *t);
+
+#endif /* _TELEMETRY_H_ */
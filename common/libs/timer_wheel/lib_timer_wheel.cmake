@@ -0,0 +1,11 @@
+# Description: lib multiplexing software timers on a counter channel
+include_guard(GLOBAL)
+message("lib_timer_wheel component is included.")
+
+target_sources(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/timer_wheel.c
+)
+
+target_include_directories(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/.
+)
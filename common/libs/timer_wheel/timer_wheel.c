@@ -0,0 +1,285 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include "os/irq.h"
+
+#include "rtos_apps/log.h"
+
+#include "timer_wheel.h"
+
+#define TIMER_WHEEL_MASK	(TIMER_WHEEL_SLOTS - 1)
+
+/* Called with the wheel locked */
+static void timer_wheel_insert(struct timer_wheel *w, struct timer_wheel_timer *t)
+{
+	struct timer_wheel_timer **head = &w->slot[t->expiry & TIMER_WHEEL_MASK];
+
+	t->prev = NULL;
+	t->next = *head;
+	if (*head)
+		(*head)->prev = t;
+	*head = t;
+
+	t->pending = true;
+	w->count++;
+}
+
+/* Called with the wheel locked */
+static void timer_wheel_remove(struct timer_wheel *w, struct timer_wheel_timer *t)
+{
+	if (t->prev)
+		t->prev->next = t->next;
+	else
+		w->slot[t->expiry & TIMER_WHEEL_MASK] = t->next;
+
+	if (t->next)
+		t->next->prev = t->prev;
+
+	t->pending = false;
+	w->count--;
+}
+
+/*
+ * Next wheel tick with an expiring timer, or the end of the current wheel
+ * revolution if none. Called with the wheel locked.
+ */
+static uint32_t timer_wheel_next_expiry(struct timer_wheel *w)
+{
+	struct timer_wheel_timer *t;
+	uint32_t tick;
+
+	for (tick = w->now + 1; tick != w->now + TIMER_WHEEL_SLOTS; tick++)
+		for (t = w->slot[tick & TIMER_WHEEL_MASK]; t; t = t->next)
+			if (t->expiry == tick)
+				return tick;
+
+	return tick;
+}
+
+/* Called with the wheel locked */
+static int timer_wheel_arm(struct timer_wheel *w)
+{
+	w->target = timer_wheel_next_expiry(w);
+
+	w->alarm.ticks = w->base + (w->target - w->now) * w->tick_ticks;
+	w->alarm.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+
+	return os_counter_set_channel_alarm(w->dev, w->chan_id, &w->alarm);
+}
+
+/*
+ * Expire the timers of the next tick. The wheel is unlocked while a
+ * callback runs, and the slot is scanned again after each callback, as the
+ * callback may have started or cancelled other timers of the slot.
+ */
+static void timer_wheel_tick(struct timer_wheel *w)
+{
+	struct timer_wheel_timer *t;
+	unsigned int key;
+
+	key = os_irq_lock();
+
+	w->now++;
+	w->base += w->tick_ticks;
+
+	do {
+		for (t = w->slot[w->now & TIMER_WHEEL_MASK]; t; t = t->next)
+			if (t->expiry == w->now)
+				break;
+
+		if (!t)
+			break;
+
+		timer_wheel_remove(w, t);
+
+		if (t->period) {
+			t->expiry += t->period;
+			timer_wheel_insert(w, t);
+		}
+
+		os_irq_unlock(key);
+
+		t->callback(t, t->user_data);
+
+		key = os_irq_lock();
+	} while (1);
+
+	os_irq_unlock(key);
+}
+
+static void timer_wheel_alarm_handler(os_counter_t *dev, uint8_t chan_id,
+		uint32_t irq_counter, void *user_data)
+{
+	struct timer_wheel *w = user_data;
+	unsigned int key;
+	uint32_t cnt;
+
+	do {
+		/*
+		 * All the ticks elapsed since the previous alarm: empty ones, the
+		 * alarm one, and later ones if the alarm was handled late
+		 */
+		os_counter_get_value(dev, &cnt);
+		while ((cnt - w->base) >= w->tick_ticks)
+			timer_wheel_tick(w);
+
+		key = os_irq_lock();
+
+		if (!w->count) {
+			w->running = false;
+			os_irq_unlock(key);
+			break;
+		}
+
+		if (timer_wheel_arm(w) < 0) {
+			log_err("wheel alarm failed, %u timers stopped\n", w->count);
+			w->running = false;
+			os_irq_unlock(key);
+			break;
+		}
+
+		os_irq_unlock(key);
+
+		/* next expiring tick already elapsed */
+		os_counter_get_value(dev, &cnt);
+	} while ((int32_t)(w->alarm.ticks - cnt) <= 0);
+}
+
+/*
+ * Set up a timer wheel with a @resolution_us wheel tick, on channel
+ * @chan_id of counter @dev. The counter must already be started.
+ */
+int timer_wheel_init(struct timer_wheel *w, os_counter_t *dev, uint8_t chan_id, uint32_t resolution_us)
+{
+	memset(w, 0, sizeof(*w));
+
+	if (os_counter_get_top_value(dev) != UINT32_MAX) {
+		log_err("32-bit counter required\n");
+		return -1;
+	}
+
+	w->dev = dev;
+	w->chan_id = chan_id;
+	w->tick_ticks = os_counter_us_to_ticks(dev, resolution_us);
+	if (!w->tick_ticks) {
+		log_err("invalid resolution: %u us\n", resolution_us);
+		return -1;
+	}
+
+	w->alarm.callback = timer_wheel_alarm_handler;
+	w->alarm.user_data = w;
+
+	return 0;
+}
+
+/* Stop the wheel, pending timers are dropped (and can be started again) */
+void timer_wheel_exit(struct timer_wheel *w)
+{
+	struct timer_wheel_timer *t;
+	unsigned int key, i;
+
+	key = os_irq_lock();
+
+	if (w->running)
+		os_counter_cancel_channel_alarm(w->dev, w->chan_id);
+
+	w->running = false;
+
+	for (i = 0; i < TIMER_WHEEL_SLOTS; i++) {
+		for (t = w->slot[i]; t; t = t->next)
+			t->pending = false;
+
+		w->slot[i] = NULL;
+	}
+
+	w->count = 0;
+
+	os_irq_unlock(key);
+}
+
+void timer_wheel_timer_init(struct timer_wheel_timer *t,
+		void (*callback)(struct timer_wheel_timer *timer, void *user_data), void *user_data)
+{
+	memset(t, 0, sizeof(*t));
+
+	t->callback = callback;
+	t->user_data = user_data;
+}
+
+/*
+ * Start a timer expiring in @delay_us, then every @period_us (rounded to the
+ * wheel resolution) if not 0. Fails if the timer is already pending.
+ */
+int timer_wheel_timer_start(struct timer_wheel *w, struct timer_wheel_timer *t,
+		uint32_t delay_us, uint32_t period_us)
+{
+	uint32_t delay, period;
+	unsigned int key;
+	uint32_t cnt;
+	int err = 0;
+
+	delay = os_counter_us_to_ticks(w->dev, delay_us);
+	delay = (delay + w->tick_ticks - 1) / w->tick_ticks;
+
+	period = os_counter_us_to_ticks(w->dev, period_us);
+	period = (period + w->tick_ticks / 2) / w->tick_ticks;
+	if (period_us && !period)
+		period = 1;
+
+	key = os_irq_lock();
+
+	if (t->pending) {
+		err = -1;
+		goto out;
+	}
+
+	os_counter_get_value(w->dev, &cnt);
+
+	/* the wheel restarts with a tick starting now */
+	if (!w->running)
+		w->base = cnt;
+
+	/* part of the current tick already elapsed */
+	if (w->running || !delay)
+		delay++;
+
+	/* ticks without expiring timers are not processed until the alarm one */
+	t->expiry = w->now + (cnt - w->base) / w->tick_ticks + delay;
+	t->period = period;
+
+	timer_wheel_insert(w, t);
+
+	/* alarm moved earlier if the timer expires before the armed tick */
+	if (!w->running || ((int32_t)(t->expiry - w->target) < 0)) {
+		err = timer_wheel_arm(w);
+		if (err < 0) {
+			timer_wheel_remove(w, t);
+			goto out;
+		}
+
+		w->running = true;
+	}
+
+out:
+	os_irq_unlock(key);
+
+	return err;
+}
+
+/* Cancel a timer, nothing is done if it is not pending */
+void timer_wheel_timer_cancel(struct timer_wheel *w, struct timer_wheel_timer *t)
+{
+	unsigned int key;
+
+	key = os_irq_lock();
+
+	if (t->pending)
+		timer_wheel_remove(w, t);
+
+	os_irq_unlock(key);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "os/counter.h"
+
+/*
+ * Software timers multiplexed on a single counter channel (hashed timing
+ * wheel).
+ *
+ * While timers are pending, the channel alarm is programmed for the next
+ * wheel tick (the wheel resolution) with an expiring timer, and at least once
+ * per wheel revolution: empty ticks don't raise interrupts. Each tick
+ * processes one slot of the wheel, timers expiring later than one wheel
+ * revolution wait in their slot for the following revolutions. Starting and
+ * cancelling a timer are O(1), a tick only visits the timers of its slot.
+ *
+ * Timers expire on wheel ticks: never early, and at most one tick late.
+ * Periodic timers are re-armed on the tick timeline, without drift.
+ * Callbacks are called from the counter interrupt handler, and may start or
+ * cancel timers (including their own).
+ *
+ * The counter must be a 32-bit up counter (wrapping at UINT32_MAX).
+ */
+#define TIMER_WHEEL_SLOTS	64	/* must be a power of 2 */
+
+struct timer_wheel_timer {
+	struct timer_wheel_timer *next;
+	struct timer_wheel_timer *prev;
+	void (*callback)(struct timer_wheel_timer *timer, void *user_data);
+	void *user_data;
+	uint32_t expiry;	/* wheel tick */
+	uint32_t period;	/* wheel ticks, 0 for a one-shot timer */
+	bool pending;
+};
+
+struct timer_wheel {
+	os_counter_t *dev;
+	uint8_t chan_id;
+	uint32_t tick_ticks;	/* counter ticks per wheel tick */
+	uint32_t base;		/* counter value of the start of wheel tick now */
+	uint32_t now;		/* latest processed wheel tick */
+	uint32_t target;	/* wheel tick of the channel alarm */
+	unsigned int count;	/* pending timers */
+	bool running;		/* channel alarm armed */
+	struct os_counter_alarm_cfg alarm;
+	struct timer_wheel_timer *slot[TIMER_WHEEL_SLOTS];
+};
+
+int timer_wheel_init(struct timer_wheel *w, os_counter_t *dev, uint8_t chan_id, uint32_t resolution_us);
+void timer_wheel_exit(struct timer_wheel *w);
+void timer_wheel_timer_init(struct timer_wheel_timer *t,
+		void (*callback)(struct timer_wheel_timer *timer, void *user_data), void *user_data);
+int timer_wheel_timer_start(struct timer_wheel *w, struct timer_wheel_timer *t,
+		uint32_t delay_us, uint32_t period_us);
+void timer_wheel_timer_cancel(struct timer_wheel *w, struct timer_wheel_timer *t);
+
+#endif /* _TIMER_WHEEL_H_ */
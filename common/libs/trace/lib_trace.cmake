@@ -0,0 +1,10 @@
+# Description: lib providing an OS event tracer, recording only while armed (see common/os/trace.h)
+include_guard(GLOBAL)
+message("lib_trace component is included.")
+
+# Enables the OS hooks (IRQ dispatch, tick, task switch)
+target_compile_definitions(${MCUX_SDK_PROJECT_NAME} PRIVATE OS_TRACE)
+
+target_sources(${MCUX_SDK_PROJECT_NAME} PRIVATE
+    ${CMAKE_CURRENT_LIST_DIR}/trace.c
+)
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "os/section.h"
+#include "os/trace.h"
+
+#if defined(OS_ZEPHYR)
+#include <zephyr/kernel.h>
+#endif
+
+/*
+ * Events are recorded from any context (nested IRQs included), slots are
+ * claimed with an atomic increment of the head index. Events are only
+ * recorded while the tracer is armed (it starts disarmed), and recording stops
+ * when the ring is frozen, so that the reader gets a stable copy. An event
+ * being recorded by an IRQ nested at the time of the freeze may still land in
+ * the ring: the trace is best effort, but never blocks the recording contexts.
+ *
+ * The timestamps of the current IRQ entry (per nesting level) and of the
+ * latest task switch are kept apart from the ring, per core, and updated even
+ * while it is not recording, for latency breakdowns.
+ */
+#if defined(OS_ZEPHYR) && defined(CONFIG_SMP)
+#define OS_TRACE_CPUS	CONFIG_MP_MAX_NUM_CPUS
+#else
+#define OS_TRACE_CPUS	1
+#endif
+
+struct os_trace_cpu {
+	uint32_t irq_depth;
+	uint64_t irq_entry[OS_TRACE_IRQ_NEST_MAX];
+	uint64_t switch_in;
+};
+
+static struct {
+	uint32_t head; /* total number of events recorded since the last restart */
+	bool armed; /* recording */
+	struct os_trace_cpu cpu[OS_TRACE_CPUS];
+	struct os_trace_event ring[OS_TRACE_RING_SIZE];
+} trace OS_HOT_BSS;
+
+/* Called from IRQ handlers, or from tasks that can't migrate (pinned, or interrupts disabled) */
+static inline struct os_trace_cpu *os_trace_cpu(void)
+{
+#if OS_TRACE_CPUS > 1
+	return &trace.cpu[arch_curr_cpu()->id];
+#else
+	return &trace.cpu[0];
+#endif
+}
+
+static inline void OS_HOT_TEXT os_trace_record_ts(uint32_t type, uint32_t arg, uint64_t ts)
+{
+	struct os_trace_event *ev;
+	uint32_t idx;
+
+	if (!__atomic_load_n(&trace.armed, __ATOMIC_ACQUIRE))
+		return;
+
+	idx = __atomic_fetch_add(&trace.head, 1, __ATOMIC_RELAXED);
+
+	ev = &trace.ring[idx & (OS_TRACE_RING_SIZE - 1)];
+	ev->ts = ts;
+	ev->type = type;
+	ev->arg = arg;
+}
+
+void OS_HOT_TEXT os_trace_record(uint32_t type, uint32_t arg)
+{
+	os_trace_record_ts(type, arg, os_trace_timestamp());
+}
+
+/*
+ * Called with interrupts disabled, before the IRQ handler. Nested IRQs exit
+ * before their parent, so the nesting level is balanced when the parent
+ * reads or updates it.
+ */
+void OS_HOT_TEXT os_trace_irq_entry(uint32_t nr)
+{
+	struct os_trace_cpu *cpu = os_trace_cpu();
+	uint64_t ts = os_trace_timestamp();
+	uint32_t depth = cpu->irq_depth++;
+
+	if (depth < OS_TRACE_IRQ_NEST_MAX)
+		cpu->irq_entry[depth] = ts;
+
+	os_trace_record_ts(OS_TRACE_IRQ_ENTRY, nr, ts);
+}
+
+void OS_HOT_TEXT os_trace_irq_exit(uint32_t nr)
+{
+	os_trace_record(OS_TRACE_IRQ_EXIT, nr);
+
+	os_trace_cpu()->irq_depth--;
+}
+
+/* Entry timestamp of the IRQ being handled, 0 if unknown (to be called from an IRQ handler) */
+uint64_t OS_HOT_TEXT os_trace_irq_entry_ts(void)
+{
+	struct os_trace_cpu *cpu = os_trace_cpu();
+	uint32_t depth = cpu->irq_depth;
+
+	if (!depth || (depth > OS_TRACE_IRQ_NEST_MAX))
+		return 0;
+
+	return cpu->irq_entry[depth - 1];
+}
+
+/* Timestamp of the latest task switch on the current core */
+uint64_t OS_HOT_TEXT os_trace_switch_in_ts(void)
+{
+	return os_trace_cpu()->switch_in;
+}
+
+/* The first characters of the task name are enough to identify rt_latency tasks */
+void OS_HOT_TEXT os_trace_task_switched_in(const char *name)
+{
+	uint64_t ts = os_trace_timestamp();
+	uint32_t arg = 0;
+	unsigned int i;
+
+	os_trace_cpu()->switch_in = ts;
+
+	for (i = 0; (i < sizeof(arg)) && name && name[i]; i++)
+		arg |= (uint32_t)(uint8_t)name[i] << (8 * i);
+
+	os_trace_record_ts(OS_TRACE_TASK_SWITCH, arg, ts);
+}
+
+/* Stop recording. Returns false if the trace was already frozen, or not armed. */
+bool os_trace_freeze(void)
+{
+	bool expected = true;
+
+	return __atomic_compare_exchange_n(&trace.armed, &expected, false, false,
+					   __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+/* Number of events in the ring */
+unsigned int os_trace_count(void)
+{
+	uint32_t head = __atomic_load_n(&trace.head, __ATOMIC_ACQUIRE);
+
+	return head < OS_TRACE_RING_SIZE ? head : OS_TRACE_RING_SIZE;
+}
+
+/*
+ * Copy up to @count events of the frozen trace, starting at @index (0 being
+ * the oldest event). Returns the number of events copied.
+ */
+unsigned int os_trace_read(struct os_trace_event *events, unsigned int index, unsigned int count)
+{
+	uint32_t head = __atomic_load_n(&trace.head, __ATOMIC_ACQUIRE);
+	unsigned int total = os_trace_count();
+	uint32_t first = head - total;
+	unsigned int i;
+
+	for (i = 0; (i < count) && (index + i < total); i++)
+		events[i] = trace.ring[(first + index + i) & (OS_TRACE_RING_SIZE - 1)];
+
+	return i;
+}
+
+/* Empty the ring and (re)start recording */
+void os_trace_restart(void)
+{
+	__atomic_store_n(&trace.head, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&trace.armed, true, __ATOMIC_RELEASE);
+}
+
+#if defined(OS_ZEPHYR)
+/*
+ * CONFIG_TRACING_USER hooks. The tracing subsystem does not provide the IRQ
+ * number, and the system timer interrupt is only seen as an IRQ entry/exit.
+ */
+void sys_trace_isr_enter_user(int nested_interrupts)
+{
+	os_trace_irq_entry(OS_TRACE_IRQ_UNKNOWN);
+}
+
+void sys_trace_isr_exit_user(int nested_interrupts)
+{
+	os_trace_irq_exit(OS_TRACE_IRQ_UNKNOWN);
+}
+
+void sys_trace_thread_switched_in_user(void)
+{
+	os_trace_task_switched_in(k_thread_name_get(k_current_get()));
+}
+#endif
@@ -7,6 +7,7 @@
 #ifndef _COMMON_COUNTER_H_
 #define _COMMON_COUNTER_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef struct os_counter os_counter_t;
@@ -18,6 +19,8 @@ struct os_counter_alarm_cfg {
 	uint32_t flags;      /* absolute or relative */
 };
 
+#include "os/irq.h"
+
 #if defined(OS_ZEPHYR)
   #include "zephyr/os/counter.h"
 #elif defined(FSL_RTOS_FREE_RTOS)
@@ -36,4 +39,95 @@ int os_counter_set_channel_alarm(os_counter_t *dev, uint8_t chan_id,
           const struct os_counter_alarm_cfg *alarm_cfg);
 int os_counter_cancel_channel_alarm(os_counter_t *dev, uint8_t chan_id);
 
+/*
+ * Fixed-point ticks to ns conversion factors, for a counter running at @freq
+ * Hz: ns = (ticks * mult) >> shift, with the largest shift keeping mult in 64
+ * bits (conversion error below 1 ns over the 64-bit range of most counters).
+ */
+static inline void os_counter_ns_scale(uint32_t freq, uint64_t *mult, uint32_t *shift)
+{
+	unsigned __int128 m;
+	uint32_t s;
+
+	for (s = 63; s; s--) {
+		m = ((unsigned __int128)1000000000 << s) / freq;
+		if (m <= UINT64_MAX)
+			break;
+	}
+
+	*mult = (uint64_t)m;
+	*shift = s;
+}
+
+static inline uint64_t os_counter_ns_scaled(uint64_t ticks, uint64_t mult, uint32_t shift)
+{
+	return (uint64_t)(((unsigned __int128)ticks * mult) >> shift);
+}
+
+/*
+ * 64-bit timeline of a counter: monotonic across counter wraps, as long as it
+ * is read at least once per counter wrap period (about 3 minutes for a 32-bit
+ * counter at 24 MHz). Reads are serialized with interrupts disabled, so the
+ * clock can be shared by tasks and interrupt handlers.
+ */
+struct os_counter_clock {
+	os_counter_t *dev;
+	uint32_t top;
+	bool counting_up;
+	uint32_t last;		/* counter value at the latest read */
+	uint64_t ticks;		/* ticks elapsed since the clock init */
+	uint64_t mult;
+	uint32_t shift;
+};
+
+/* Start the timeline at 0, the counter must be running */
+static inline void os_counter_clock_init(struct os_counter_clock *clk, os_counter_t *dev)
+{
+	clk->dev = dev;
+	clk->top = os_counter_get_top_value(dev);
+	clk->counting_up = os_counter_is_counting_up(dev);
+	clk->ticks = 0;
+
+	os_counter_ns_scale(os_counter_us_to_ticks(dev, 1000000), &clk->mult, &clk->shift);
+
+	os_counter_get_value(dev, &clk->last);
+}
+
+static inline uint64_t os_counter_clock_read(struct os_counter_clock *clk)
+{
+	uint32_t cnt, from, to, delta;
+	unsigned int key;
+	uint64_t ticks;
+
+	key = os_irq_lock();
+
+	os_counter_get_value(clk->dev, &cnt);
+
+	if (clk->counting_up) {
+		from = clk->last;
+		to = cnt;
+	} else {
+		from = cnt;
+		to = clk->last;
+	}
+
+	/* top + 1 wraps to 0 for a full 32-bit counter, as does the subtraction */
+	delta = to - from;
+	if (to < from)
+		delta += clk->top + 1;
+
+	clk->last = cnt;
+	clk->ticks += delta;
+	ticks = clk->ticks;
+
+	os_irq_unlock(key);
+
+	return ticks;
+}
+
+static inline uint64_t os_counter_clock_ticks_to_ns(const struct os_counter_clock *clk, uint64_t ticks)
+{
+	return os_counter_ns_scaled(ticks, clk->mult, clk->shift);
+}
+
 #endif /* #ifndef _COMMON_COUNTER_H_ */
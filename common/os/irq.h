@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 NXP
+ * Copyright 2022-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,5 +23,8 @@ int os_irq_register(unsigned int irq, void (*func)(void *data),
 int os_irq_unregister(unsigned int irq);
 void os_irq_enable(unsigned int irq);
 void os_irq_disable(unsigned int irq);
+unsigned int os_irq_lock(void);
+void os_irq_unlock(unsigned int key);
+void os_irq_trigger_sgi(unsigned int sgi);
 
 #endif /* #ifndef _COMMON_IRQ_H_ */
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _COMMON_NOTIFY_H_
+#define _COMMON_NOTIFY_H_
+
+/*
+ * Lightweight, OS native, task wake-up primitive, bound to one waiting task
+ * (FreeRTOS: direct task notification, Zephyr: event object):
+ *
+ * os_notify_init()          called by the task that will wait
+ * os_notify_give()          wake the task up (task context)
+ * os_notify_give_from_isr() wake the task up (IRQ context)
+ * os_notify_take()          wait for the notification, 0 on success
+ *
+ * OS_NOTIFY_NAME names the underlying primitive.
+ */
+#define OS_NOTIFY_WAIT_FOREVER	0xffffffff
+
+#if defined(OS_ZEPHYR)
+  #include "zephyr/os/notify.h"
+#elif defined(FSL_RTOS_FREE_RTOS)
+  #include "freertos/os/notify.h"
+#endif
+
+#endif /* #ifndef _COMMON_NOTIFY_H_ */
@@ -0,0 +1,21 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _COMMON_SCHED_H_
+#define _COMMON_SCHED_H_
+
+/*
+ * OS native scheduler operations, not covered by the RTOS abstraction layer:
+ *
+ * os_sched_yield()          give the CPU to the next ready task of the same
+ *                           priority, if any
+ */
+#if defined(OS_ZEPHYR)
+  #include "zephyr/os/sched.h"
+#elif defined(FSL_RTOS_FREE_RTOS)
+  #include "freertos/os/sched.h"
+#endif
+
+#endif /* #ifndef _COMMON_SCHED_H_ */
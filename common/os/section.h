@@ -0,0 +1,42 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _COMMON_SECTION_H_
+#define _COMMON_SECTION_H_
+
+/*
+ * On-chip RAM (OCRAM) placement, out of reach of the DDR contention caused by
+ * the other cores. The FreeRTOS board linker scripts gather these sections in
+ * the OCRAM regions (copied/zeroed at startup). Zephyr does not support code
+ * and data relocation on Cortex-A: the attributes are no-ops.
+ *
+ * Only use OS_OCRAM_DATA for writable, initialized variables (const data would
+ * conflict with the section flags) and OS_OCRAM_BSS for zero-initialized ones.
+ */
+#if defined(FSL_RTOS_FREE_RTOS)
+#define OS_OCRAM_TEXT	__attribute__((section(".ocram_text")))
+#define OS_OCRAM_DATA	__attribute__((section(".ocram_data")))
+#define OS_OCRAM_BSS	__attribute__((section(".ocram_bss")))
+#else
+#define OS_OCRAM_TEXT
+#define OS_OCRAM_DATA
+#define OS_OCRAM_BSS
+#endif
+
+/*
+ * Interrupt dispatch and counter driver paths, moved to OCRAM when the
+ * application is built with OS_OCRAM_HOT_PATH defined.
+ */
+#if defined(OS_OCRAM_HOT_PATH)
+#define OS_HOT_TEXT	OS_OCRAM_TEXT
+#define OS_HOT_DATA	OS_OCRAM_DATA
+#define OS_HOT_BSS	OS_OCRAM_BSS
+#else
+#define OS_HOT_TEXT
+#define OS_HOT_DATA
+#define OS_HOT_BSS
+#endif
+
+#endif /* _COMMON_SECTION_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _COMMON_TRACE_H_
+#define _COMMON_TRACE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Event tracer: a ring of the most recent OS events (IRQ entry/exit, ticks,
+ * task switches, ...) that an application arms (os_trace_restart()) and
+ * freezes when it detects an anomaly, to get the context that led to it.
+ * Nothing is recorded in the ring while the tracer is disarmed.
+ *
+ * The tracer is implemented by common/libs/trace (lib_trace), which defines
+ * OS_TRACE. Without it, the OS hooks compile to nothing and the tracer never
+ * records.
+ */
+
+/* Number of events kept in the ring (must be a power of 2) */
+#define OS_TRACE_RING_SIZE	256
+
+/* Event types, sent as is to Linux: must match HRPN_TRACE_EV_xxx (hrpn_ctrl.h) */
+enum {
+	OS_TRACE_IRQ_ENTRY = 1,		/* arg: IRQ number, OS_TRACE_IRQ_UNKNOWN if not available */
+	OS_TRACE_IRQ_EXIT,		/* arg: IRQ number, OS_TRACE_IRQ_UNKNOWN if not available */
+	OS_TRACE_TICK,			/* arg: tick count */
+	OS_TRACE_TASK_SWITCH,		/* arg: first 4 characters of the task name */
+	OS_TRACE_CACHE_INVAL_ENTRY,
+	OS_TRACE_CACHE_INVAL_EXIT,
+	OS_TRACE_LATENCY_IRQ,		/* rt_latency alarm handler */
+	OS_TRACE_LATENCY_WAKEUP,	/* rt_latency task wake-up, arg: irq delay (ns) */
+	OS_TRACE_MAX,
+};
+
+#define OS_TRACE_IRQ_UNKNOWN	0xffffffff
+
+/* Maximum IRQ nesting level tracked for os_trace_irq_entry_ts() */
+#define OS_TRACE_IRQ_NEST_MAX	8
+
+/* Timestamps are ARM generic timer (virtual count) values */
+struct os_trace_event {
+	uint64_t ts;
+	uint32_t type;
+	uint32_t arg;
+};
+
+static inline uint64_t os_trace_timestamp(void)
+{
+	uint64_t cnt;
+
+	__asm volatile ("mrs %0, cntvct_el0" : "=r" (cnt));
+
+	return cnt;
+}
+
+/* Timestamp frequency (Hz) */
+static inline uint32_t os_trace_frequency(void)
+{
+	uint64_t freq;
+
+	__asm volatile ("mrs %0, cntfrq_el0" : "=r" (freq));
+
+	return (uint32_t)freq;
+}
+
+#if defined(OS_TRACE)
+void os_trace_record(uint32_t type, uint32_t arg);
+void os_trace_irq_entry(uint32_t nr);
+void os_trace_irq_exit(uint32_t nr);
+void os_trace_task_switched_in(const char *name);
+uint64_t os_trace_irq_entry_ts(void);
+uint64_t os_trace_switch_in_ts(void);
+bool os_trace_freeze(void);
+unsigned int os_trace_count(void);
+unsigned int os_trace_read(struct os_trace_event *events, unsigned int index, unsigned int count);
+void os_trace_restart(void);
+#else
+static inline void os_trace_record(uint32_t type, uint32_t arg) {}
+static inline void os_trace_irq_entry(uint32_t nr) {}
+static inline void os_trace_irq_exit(uint32_t nr) {}
+static inline void os_trace_task_switched_in(const char *name) {}
+static inline uint64_t os_trace_irq_entry_ts(void) { return 0; }
+static inline uint64_t os_trace_switch_in_ts(void) { return 0; }
+static inline bool os_trace_freeze(void) { return false; }
+static inline unsigned int os_trace_count(void) { return 0; }
+static inline unsigned int os_trace_read(struct os_trace_event *events, unsigned int index, unsigned int count) { return 0; }
+static inline void os_trace_restart(void) {}
+#endif
+
+#endif /* _COMMON_TRACE_H_ */
@@ -11,30 +11,39 @@
 
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x00930000
 
 #elif defined (CONFIG_BOARD_IMX8MN_EVK)
 
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x00930000
 
 #elif defined (CONFIG_BOARD_IMX8MM_EVK)
 
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x00930000
 
 #elif defined (CONFIG_BOARD_IMX93_EVK)
 
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x204B0000
 
 #elif defined(CONFIG_BOARD_IMX943_EVK)
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x204B0000
 
 #elif defined(CONFIG_BOARD_IMX95_EVK_15X15) || defined(CONFIG_BOARD_IMX95_EVK)
 #define	HYPERVISOR_COMM_BASE	0x80000000
 #define	PCI_MMIO_BASE		0xff000000
+#define	OCRAM_DATA_BASE		0x204B0000
 
 #endif
 
+/* OCRAM data region of the inmate, same as the FreeRTOS ocram_data region */
+#define	OCRAM_DATA_SIZE		0x00030000
+
 #endif /* _MEMORY_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022 NXP
+ * Copyright 2022, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,28 @@
 #ifndef _ZEPHYR_CPU_LOAD_H_
 #define _ZEPHYR_CPU_LOAD_H_
 
+#include <zephyr/kernel.h>
+
 static inline void os_cpu_load_stats(void)
 {
 }
 
+/* Busy and total cycles since boot, all cores, if thread usage is accounted */
+static inline int os_cpu_load_read(uint64_t *busy, uint64_t *total)
+{
+#ifdef CONFIG_SCHED_THREAD_USAGE_ALL
+	k_thread_runtime_stats_t stats;
+
+	if (k_thread_runtime_stats_all_get(&stats))
+		return -1;
+
+	*busy = stats.total_cycles;
+	*total = stats.total_cycles + stats.idle_cycles;
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
 #endif /* #ifndef _ZEPHYR_CPU_LOAD_H_ */
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 NXP
+ * Copyright 2022-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,11 @@
 #define _ZEPHYR_IRQ_H_
 
 #include <zephyr/kernel.h>
+#include <zephyr/arch/arm64/lib_helpers.h>
+#include <zephyr/drivers/interrupt_controller/gic.h>
+#if defined(CONFIG_SMP)
+#include <zephyr/sys/sys_io.h>
+#endif
 
 #define PRIORITY_SHIFT 4
 
@@ -41,4 +46,37 @@ static inline void os_irq_disable(unsigned int irq)
 	irq_disable(irq);
 }
 
+static inline unsigned int os_irq_lock(void)
+{
+	return irq_lock();
+}
+
+static inline void os_irq_unlock(unsigned int key)
+{
+	irq_unlock(key);
+}
+
+/* Raise software generated interrupt @sgi (0 to 15) on the current core */
+static inline void os_irq_trigger_sgi(unsigned int sgi)
+{
+	uint64_t mpidr = read_mpidr_el1();
+
+	gic_raise_sgi(sgi, mpidr, 1 << MPIDR_TO_CORE(mpidr));
+}
+
+#if defined(CONFIG_SMP)
+/* GICv3 distributor SPI routing registers */
+#define GICD_IROUTER_OFFSET	0x6000
+
+/*
+ * Route a shared peripheral interrupt to the calling core (GICv3 affinity
+ * routing). SPIs are routed to the boot core by default: the caller must be
+ * pinned to the target core.
+ */
+static inline void os_irq_route_to_current_cpu(unsigned int irq)
+{
+	sys_write64(MPIDR_TO_CORE(read_mpidr_el1()), GIC_DIST_BASE + GICD_IROUTER_OFFSET + 8 * irq);
+}
+#endif
+
 #endif /* #ifndef _ZEPHYR_IRQ_H_ */
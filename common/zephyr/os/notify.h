@@ -0,0 +1,57 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _ZEPHYR_NOTIFY_H_
+#define _ZEPHYR_NOTIFY_H_
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#define OS_NOTIFY_NAME	"event"
+
+#define OS_NOTIFY_EVENT	BIT(0)
+
+/* Requires CONFIG_EVENTS */
+typedef struct {
+	struct k_event event;
+} os_notify_t;
+
+static inline void os_notify_init(os_notify_t *notify)
+{
+	k_event_init(&notify->event);
+}
+
+static inline int os_notify_give(os_notify_t *notify)
+{
+	k_event_post(&notify->event, OS_NOTIFY_EVENT);
+
+	return 0;
+}
+
+/* The Zephyr IRQ exit path reschedules if need be */
+static inline int os_notify_give_from_isr(os_notify_t *notify, bool *yield)
+{
+	k_event_post(&notify->event, OS_NOTIFY_EVENT);
+
+	*yield = false;
+
+	return 0;
+}
+
+static inline int os_notify_take(os_notify_t *notify, uint32_t timeout_ms)
+{
+	k_timeout_t timeout = (timeout_ms == OS_NOTIFY_WAIT_FOREVER) ? K_FOREVER : K_MSEC(timeout_ms);
+
+	/* no reset on entry: a notification given before the wait must not be lost */
+	if (!k_event_wait(&notify->event, OS_NOTIFY_EVENT, false, timeout))
+		return -1;
+
+	k_event_clear(&notify->event, OS_NOTIFY_EVENT);
+
+	return 0;
+}
+
+#endif /* #ifndef _ZEPHYR_NOTIFY_H_ */
@@ -0,0 +1,17 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _ZEPHYR_SCHED_H_
+#define _ZEPHYR_SCHED_H_
+
+#include <zephyr/kernel.h>
+
+static inline void os_sched_yield(void)
+{
+	k_yield();
+}
+
+#endif /* #ifndef _ZEPHYR_SCHED_H_ */
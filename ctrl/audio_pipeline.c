@@ -12,6 +12,8 @@
 #include "hrpn_ctrl.h"
 #include "common.h"
 
+#define AUDIO_ROUTING_COMMANDS_MAX	64
+
 void audio_pipeline_usage(void)
 {
 	printf(
@@ -31,6 +33,9 @@ void audio_element_routing_usage(void)
 		"\t-e <element_id>   routing element id (default 0)\n"
 		"\t-i <input_id>     routing element input  (default 0)\n"
 		"\t-o <output_id>    routing element output (default 0)\n"
+		"\t                  -c and -d can be repeated (up to %d), each with the options set before it,\n"
+		"\t                  e.g. '-o 0 -i 2 -c -o 1 -i 3 -c': the commands are pipelined\n",
+		AUDIO_ROUTING_COMMANDS_MAX
 	);
 }
 
@@ -52,41 +57,79 @@ void audio_element_usage(void)
 	);
 }
 
-static int audio_element_routing_connect(int fd, unsigned int pipeline_id, unsigned int element_id, unsigned int output, unsigned int input)
+/* Routing commands of a command line, sent pipelined */
+struct audio_routing_commands {
+	union {
+		struct audio_cmd_element_routing_connect connect;
+		struct audio_cmd_element_routing_disconnect disconnect;
+	} cmd[AUDIO_ROUTING_COMMANDS_MAX];
+	struct audio_resp_element_routing resp[AUDIO_ROUTING_COMMANDS_MAX];
+	struct command_req req[AUDIO_ROUTING_COMMANDS_MAX];
+	unsigned int count;
+};
+
+static void audio_element_routing_req(struct audio_routing_commands *r, void *cmd, unsigned int len)
 {
-	struct audio_cmd_element_routing_connect connect;
-	struct audio_resp_element_routing resp;
-	unsigned int len;
+	struct command_req *req = &r->req[r->count];
 
-	connect.type = HRPN_CMD_TYPE_AUDIO_ELEMENT_ROUTING_CONNECT;
-	connect.pipeline.id = pipeline_id;
-	connect.element.type = 1;
-	connect.element.id = element_id;
-	connect.output = output;
-	connect.input = input;
-	len = sizeof(resp);
+	req->cmd = cmd;
+	req->cmd_len = len;
+	req->resp_type = HRPN_RESP_TYPE_AUDIO_ELEMENT_ROUTING;
+	req->resp = &r->resp[r->count];
+	req->resp_len = sizeof(r->resp[r->count]);
 
-	return command(fd, &connect, sizeof(connect), HRPN_RESP_TYPE_AUDIO_ELEMENT_ROUTING, &resp, &len, COMMAND_TIMEOUT);
+	r->count++;
 }
 
-static int audio_element_routing_disconnect(int fd, unsigned int pipeline_id, unsigned int element_id, unsigned int output)
+static int audio_element_routing_connect(struct audio_routing_commands *r, unsigned int pipeline_id, unsigned int element_id, unsigned int output, unsigned int input)
 {
-	struct audio_cmd_element_routing_disconnect disconnect;
-	struct audio_resp_element_routing resp;
-	unsigned int len;
+	struct audio_cmd_element_routing_connect *connect;
 
-	disconnect.type = HRPN_CMD_TYPE_AUDIO_ELEMENT_ROUTING_DISCONNECT;
-	disconnect.pipeline.id = pipeline_id;
-	disconnect.element.type = 1;
-	disconnect.element.id = element_id;
-	disconnect.output = output;
-	len = sizeof(resp);
+	if (r->count == AUDIO_ROUTING_COMMANDS_MAX) {
+		printf("Too many routing commands\n");
+		return -1;
+	}
+
+	connect = &r->cmd[r->count].connect;
+
+	connect->type = HRPN_CMD_TYPE_AUDIO_ELEMENT_ROUTING_CONNECT;
+	connect->pipeline.id = pipeline_id;
+	connect->element.type = 1;
+	connect->element.id = element_id;
+	connect->output = output;
+	connect->input = input;
+
+	audio_element_routing_req(r, connect, sizeof(*connect));
+
+	return 0;
+}
+
+static int audio_element_routing_disconnect(struct audio_routing_commands *r, unsigned int pipeline_id, unsigned int element_id, unsigned int output)
+{
+	struct audio_cmd_element_routing_disconnect *disconnect;
+
+	if (r->count == AUDIO_ROUTING_COMMANDS_MAX) {
+		printf("Too many routing commands\n");
+		return -1;
+	}
+
+	disconnect = &r->cmd[r->count].disconnect;
+
+	disconnect->type = HRPN_CMD_TYPE_AUDIO_ELEMENT_ROUTING_DISCONNECT;
+	disconnect->pipeline.id = pipeline_id;
+	disconnect->element.type = 1;
+	disconnect->element.id = element_id;
+	disconnect->output = output;
+
+	audio_element_routing_req(r, disconnect, sizeof(*disconnect));
 
-	return command(fd, &disconnect, sizeof(disconnect), HRPN_RESP_TYPE_AUDIO_ELEMENT_ROUTING, &resp, &len, COMMAND_TIMEOUT);
+	return 0;
 }
 
 int audio_element_routing_main(int argc, char *argv[], int fd)
 {
+	static struct audio_routing_commands r;
+	unsigned int i, failed = 0;
 	int option;
 	unsigned int pipeline_id = 0;
 	unsigned int element_id = 0;
@@ -94,6 +137,8 @@ int audio_element_routing_main(int argc, char *argv[], int fd)
 	unsigned int input = 0;
 	int rc = 0;
 
+	r.count = 0;
+
 	while ((option = getopt(argc, argv, "a:cde:i:o:v")) != -1) {
 		switch (option) {
 		case 'a':
@@ -106,12 +151,16 @@ int audio_element_routing_main(int argc, char *argv[], int fd)
 			break;
 
 		case 'c':
-			rc = audio_element_routing_connect(fd, pipeline_id, element_id, output, input);
+			rc = audio_element_routing_connect(&r, pipeline_id, element_id, output, input);
+			if (rc < 0)
+				goto out;
 
 			break;
 
 		case 'd':
-			rc = audio_element_routing_disconnect(fd, pipeline_id, element_id, output);
+			rc = audio_element_routing_disconnect(&r, pipeline_id, element_id, output);
+			if (rc < 0)
+				goto out;
 
 			break;
 
@@ -148,6 +197,24 @@ int audio_element_routing_main(int argc, char *argv[], int fd)
 		}
 	}
 
+	if (!r.count)
+		goto out;
+
+	rc = command_pipeline(fd, r.req, r.count, COMMAND_WINDOW, COMMAND_TIMEOUT);
+	if (rc == COMMAND_QUEUED) {
+		rc = 0;
+		goto out;
+	}
+
+	for (i = 0; i < r.count; i++)
+		if (r.req[i].rc < 0)
+			failed++;
+
+	if (r.count == 1)
+		printf("command %s\n", rc ? "failed" : "success");
+	else
+		printf("%u commands, %u failed\n", r.count, failed);
+
 out:
 	return rc;
 }
@@ -187,7 +254,8 @@ int audio_element_main(int argc, char *argv[], int fd)
 			break;
 
 		case 'd':
-			audio_pipeline_element_dump(fd, pipeline_id, element_type, element_id);
+			if (audio_pipeline_element_dump(fd, pipeline_id, element_type, element_id) < 0)
+				rc = -1;
 
 			break;
 
@@ -250,7 +318,8 @@ int audio_pipeline_main(int argc, char *argv[], int fd)
 			break;
 
 		case 'd':
-			audio_pipeline_dump(fd, pipeline_id);
+			if (audio_pipeline_dump(fd, pipeline_id) < 0)
+				rc = -1;
 
 			break;
 
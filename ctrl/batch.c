@@ -0,0 +1,256 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hrpn_ctrl.h"
+#include "common.h"
+#include "batch.h"
+
+#define BATCH_LINE_MAX		1024
+#define BATCH_ARGS_MAX		64
+#define BATCH_QUEUE_MAX		(2 * BATCH_ARGS_MAX)	/* room for a line after a flush */
+
+struct batch_cmd {
+	unsigned int line;
+	uint8_t cmd[COMMAND_MSG_MAX];
+	uint8_t resp[COMMAND_MSG_MAX];
+};
+
+struct batch {
+	const char *path;
+	int fd;
+	bool pipelined;
+	unsigned int line;		/* line being run */
+	unsigned int lines;		/* lines run */
+	unsigned int failed;		/* lines failed */
+
+	unsigned int count;		/* queued commands */
+	struct batch_cmd cmd[BATCH_QUEUE_MAX];
+	struct command_req req[BATCH_QUEUE_MAX];
+};
+
+static struct batch batch;
+
+static void batch_status(unsigned int line, int rc)
+{
+	printf("%s:%u: %s\n", batch.path, line, rc < 0 ? "failed" : "ok");
+
+	if (rc < 0)
+		batch.failed++;
+}
+
+/* Sends the queued commands, and prints the status of their lines */
+static void batch_flush(void)
+{
+	unsigned int i, line;
+	int rc;
+
+	if (!batch.count)
+		return;
+
+	command_pipeline(batch.fd, batch.req, batch.count, COMMAND_WINDOW, COMMAND_TIMEOUT);
+
+	for (i = 0; i < batch.count;) {
+		line = batch.cmd[i].line;
+		rc = 0;
+
+		for (; (i < batch.count) && (batch.cmd[i].line == line); i++)
+			if (batch.req[i].rc < 0)
+				rc = -1;
+
+		batch_status(line, rc);
+	}
+
+	batch.count = 0;
+}
+
+/* command_defer hook, the commands are sent by batch_flush() */
+static int batch_defer(struct command_req *req, unsigned int count)
+{
+	struct command_req *q;
+	unsigned int i;
+
+	if (batch.count + count > BATCH_QUEUE_MAX) {
+		printf("batch queue full\n");
+		return -1;
+	}
+
+	for (i = 0; i < count; i++) {
+		if ((req[i].cmd_len > COMMAND_MSG_MAX) || (req[i].resp_len > COMMAND_MSG_MAX)) {
+			printf("command too large\n");
+			return -1;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		q = &batch.req[batch.count];
+
+		batch.cmd[batch.count].line = batch.line;
+		memcpy(batch.cmd[batch.count].cmd, req[i].cmd, req[i].cmd_len);
+
+		*q = req[i];
+		q->cmd = batch.cmd[batch.count].cmd;
+		q->resp = batch.cmd[batch.count].resp;
+		q->rc = -1;
+
+		batch.count++;
+	}
+
+	return 0;
+}
+
+/* Splits a script line in arguments, returns their count (0 for an empty or comment line) */
+static int batch_args(char *buf, char *argv[])
+{
+	char *saveptr, *tok;
+	int argc = 0;
+
+	buf[strcspn(buf, "#\r\n")] = '\0';
+
+	for (tok = strtok_r(buf, " \t", &saveptr); tok; tok = strtok_r(NULL, " \t", &saveptr)) {
+		if (argc == BATCH_ARGS_MAX) {
+			printf("too many arguments\n");
+			return -1;
+		}
+
+		argv[argc++] = tok;
+	}
+
+	argv[argc] = NULL;
+
+	return argc;
+}
+
+/* Runs a script line, returns COMMAND_QUEUED if its commands were queued */
+static int batch_run(int argc, char *argv[])
+{
+	const struct cmd_handler *handler;
+	unsigned int start;
+	int rc;
+
+	handler = cmd_handler_find(argv[0]);
+	if (!handler) {
+		printf("unknown command: %s\n", argv[0]);
+		return -1;
+	}
+
+	/* full getopt reinitialization, for each line */
+	optind = 0;
+
+	if (!batch.pipelined || !handler->pipelined) {
+		/* previous commands first */
+		batch_flush();
+
+		rc = handler->main(argc, argv, batch.fd);
+
+		return rc ? -1 : 0;
+	}
+
+	if (batch.count > BATCH_QUEUE_MAX - BATCH_ARGS_MAX)
+		batch_flush();
+
+	start = batch.count;
+
+	command_defer = batch_defer;
+	rc = handler->main(argc, argv, batch.fd);
+	command_defer = NULL;
+
+	if (rc) {
+		batch.count = start;	/* line not run */
+		return -1;
+	}
+
+	return (batch.count > start) ? COMMAND_QUEUED : 0;
+}
+
+int batch_main(int argc, char *argv[], int fd)
+{
+	char buf[BATCH_LINE_MAX];
+	char *args[BATCH_ARGS_MAX + 1];
+	FILE *file = NULL;
+	int option, n;
+	int rc;
+
+	batch.fd = fd;
+
+	while ((option = getopt(argc, argv, "f:p")) != -1) {
+		switch (option) {
+		case 'f':
+			batch.path = optarg;
+			break;
+
+		case 'p':
+			batch.pipelined = true;
+			break;
+
+		default:
+			usage();
+			goto err;
+		}
+	}
+
+	if (!batch.path) {
+		usage();
+		goto err;
+	}
+
+	if (!strcmp(batch.path, "-")) {
+		file = stdin;
+	} else {
+		file = fopen(batch.path, "r");
+		if (!file) {
+			printf("%s: fopen(%s) failed\n", __func__, batch.path);
+			goto err;
+		}
+	}
+
+	while (fgets(buf, sizeof(buf), file)) {
+		batch.line++;
+
+		if (!strchr(buf, '\n') && !feof(file)) {
+			printf("line too long\n");
+			batch.lines++;
+			batch_status(batch.line, -1);
+
+			/* skip the rest of the line */
+			while (fgets(buf, sizeof(buf), file) && !strchr(buf, '\n'))
+				;
+
+			continue;
+		}
+
+		n = batch_args(buf, args);
+		if (!n)
+			continue;
+
+		batch.lines++;
+
+		if (n < 0) {
+			batch_status(batch.line, -1);
+			continue;
+		}
+
+		rc = batch_run(n, args);
+		if (rc != COMMAND_QUEUED)
+			batch_status(batch.line, rc);
+	}
+
+	batch_flush();
+
+	if (file != stdin)
+		fclose(file);
+
+	printf("%u lines, %u failed\n", batch.lines, batch.failed);
+
+	return batch.failed ? -1 : 0;
+
+err:
+	return -1;
+}
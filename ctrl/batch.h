@@ -0,0 +1,17 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _BATCH_H_
+#define _BATCH_H_
+
+/*
+ * Batch mode: runs the commands of a script (harpoon_ctrl -f <script> [-p]),
+ * one per line, on the control channel already open, and prints the status of
+ * each line. With -p, the commands of the handlers not using the responses are
+ * queued and sent pipelined before the next other command or at the end.
+ */
+int batch_main(int argc, char *argv[], int fd);
+
+#endif /* _BATCH_H_ */
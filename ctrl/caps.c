@@ -0,0 +1,358 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hrpn_ctrl.h"
+#include "common.h"
+#include "caps.h"
+
+enum {
+	CAPS_FORMAT_TEXT = 0,
+	CAPS_FORMAT_JSON,
+};
+
+static const struct {
+	uint32_t feature;
+	const char *name;
+} caps_feature_name[] = {
+	{ HRPN_CAPS_FEATURE_REQ_ID, "req_id" },
+	{ HRPN_CAPS_FEATURE_TELEMETRY, "telemetry" },
+	{ HRPN_CAPS_FEATURE_LATENCY, "latency" },
+	{ HRPN_CAPS_FEATURE_AUDIO, "audio" },
+	{ HRPN_CAPS_FEATURE_CAN, "can" },
+	{ HRPN_CAPS_FEATURE_ETHERNET, "ethernet" },
+};
+
+void caps_usage(void)
+{
+	printf(
+		"\nCaps options (capabilities of the running RTOS application, cached in %s):\n"
+		"\t-r             query the RTOS application again, instead of using the cached capabilities\n"
+		"\t-o <format>    output format: text (default) or json (single line)\n",
+		CAPS_CACHE_FILE
+	);
+}
+
+static bool caps_valid(struct hrpn_resp_caps *caps)
+{
+	unsigned int i;
+
+	if ((HRPN_TYPE(caps->type) != HRPN_RESP_TYPE_CAPS) || (caps->status != HRPN_RESP_STATUS_SUCCESS))
+		return false;
+
+	if ((caps->audio_config_count > HRPN_CAPS_AUDIO_CONFIGS_MAX) ||
+	    (caps->audio_period_count > HRPN_CAPS_AUDIO_PERIODS_MAX))
+		return false;
+
+	for (i = 0; i < caps->audio_config_count; i++)
+		if (caps->audio_config[i].rate_count > HRPN_CAPS_AUDIO_RATES_MAX)
+			return false;
+
+	return true;
+}
+
+int caps_cached(struct hrpn_resp_caps *caps)
+{
+	FILE *f;
+	int rc = -1;
+
+	f = fopen(CAPS_CACHE_FILE, "r");
+	if (!f)
+		goto out;
+
+	if (fread(caps, sizeof(*caps), 1, f) != 1)
+		goto close;
+
+	if (!caps_valid(caps))
+		goto close;
+
+	rc = 0;
+
+close:
+	fclose(f);
+
+out:
+	return rc;
+}
+
+/* written to a temporary file first, other readers never see a partial cache */
+static void caps_cache(struct hrpn_resp_caps *caps)
+{
+	char tmp[64];
+	size_t n;
+	FILE *f;
+
+	snprintf(tmp, sizeof(tmp), "%s.%d", CAPS_CACHE_FILE, getpid());
+
+	f = fopen(tmp, "w");
+	if (!f)
+		return;
+
+	n = fwrite(caps, sizeof(*caps), 1, f);
+	if (fclose(f) || (n != 1)) {
+		unlink(tmp);
+		return;
+	}
+
+	if (rename(tmp, CAPS_CACHE_FILE) < 0)
+		unlink(tmp);
+}
+
+static int caps_query(int fd, struct hrpn_resp_caps *caps)
+{
+	struct hrpn_cmd_caps cmd;
+	struct command_req req = {
+		.cmd = &cmd,
+		.cmd_len = sizeof(cmd),
+		.resp_type = HRPN_RESP_TYPE_CAPS,
+		.resp = caps,
+		.resp_len = sizeof(*caps),
+	};
+
+	cmd.type = HRPN_CMD_TYPE_CAPS;
+
+	/* no "command success" output, the capabilities are printed instead */
+	if (command_pipeline(fd, &req, 1, 1, COMMAND_TIMEOUT) < 0)
+		return -1;
+
+	/* fields missing from a shorter response are unsupported */
+	if (req.resp_len < sizeof(*caps))
+		memset((uint8_t *)caps + req.resp_len, 0, sizeof(*caps) - req.resp_len);
+
+	if (!caps_valid(caps))
+		return -1;
+
+	return 0;
+}
+
+int caps_get(int fd, struct hrpn_resp_caps *caps, bool refresh)
+{
+	if (!refresh && !caps_cached(caps))
+		return 0;
+
+	if (caps_query(fd, caps) < 0)
+		return -1;
+
+	caps_cache(caps);
+
+	return 0;
+}
+
+static bool caps_in(uint32_t val, const uint32_t *list, unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		if (list[i] == val)
+			return true;
+
+	return false;
+}
+
+int caps_audio_check(struct hrpn_resp_caps *caps, unsigned int id, unsigned int frequency,
+		     unsigned int period, unsigned int config_idx)
+{
+	struct hrpn_caps_audio_config *config;
+
+	if (!(caps->features & HRPN_CAPS_FEATURE_AUDIO)) {
+		printf("audio not supported by the RTOS application\n");
+		return -1;
+	}
+
+	if (config_idx >= caps->audio_config_count) {
+		printf("audio board configuration %u not supported\n", config_idx);
+		return -1;
+	}
+
+	config = &caps->audio_config[config_idx];
+
+	if ((id >= 32) || !(config->modes & (1U << id))) {
+		printf("audio mode %u not supported\n", id);
+		return -1;
+	}
+
+	if (frequency && !caps_in(frequency, config->rates, config->rate_count)) {
+		printf("audio frequency %u Hz not supported\n", frequency);
+		return -1;
+	}
+
+	if (period && !caps_in(period, caps->audio_periods, caps->audio_period_count)) {
+		printf("audio period %u frames not supported\n", period);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void caps_print_list(const char *sep, const uint32_t *list, unsigned int count)
+{
+	unsigned int i;
+
+	for (i = 0; i < count; i++)
+		printf("%s%u", i ? sep : "", list[i]);
+}
+
+static void caps_print_mask(const char *sep, uint32_t mask)
+{
+	unsigned int i;
+	bool first = true;
+
+	for (i = 0; i < 32; i++) {
+		if (!(mask & (1U << i)))
+			continue;
+
+		printf("%s%u", first ? "" : sep, i);
+		first = false;
+	}
+}
+
+static void caps_print_text(struct hrpn_resp_caps *caps)
+{
+	struct hrpn_caps_audio_config *config;
+	unsigned int i;
+
+	printf("RTOS application v%u.%u.%u\n", caps->version >> 16, (caps->version >> 8) & 0xff, caps->version & 0xff);
+
+	printf("features:");
+	for (i = 0; i < sizeof(caps_feature_name) / sizeof(caps_feature_name[0]); i++)
+		if (caps->features & caps_feature_name[i].feature)
+			printf(" %s", caps_feature_name[i].name);
+	printf("\n");
+
+	if (caps->features & HRPN_CAPS_FEATURE_LATENCY) {
+		printf("latency:\n");
+		printf("\ttest cases:   0-%u\n", caps->latency_test_cases - 1);
+		printf("\tloads:        %#x\n", caps->latency_loads);
+		printf("\tmodes:        0-%u\n", caps->latency_modes - 1);
+		printf("\tperiod:       %u-%u us\n", caps->latency_period_us_min, caps->latency_period_us_max);
+		printf("\tcpu mask:     %#x\n", caps->latency_cpu_mask);
+		printf("\tmemory load:  %u bytes per core max\n", caps->latency_mem_size_max);
+	}
+
+	if (caps->features & HRPN_CAPS_FEATURE_AUDIO) {
+		printf("audio:\n");
+
+		for (i = 0; i < caps->audio_config_count; i++) {
+			config = &caps->audio_config[i];
+
+			printf("\tconfig %u%s:\n", i, i == 1 ? " (audio HAT)" : "");
+			printf("\t\tmodes:  ");
+			caps_print_mask(" ", config->modes);
+			printf("\n\t\trates:  ");
+			caps_print_list(" ", config->rates, config->rate_count);
+			printf(" Hz\n");
+		}
+
+		printf("\tperiods:      ");
+		caps_print_list(" ", caps->audio_periods, caps->audio_period_count);
+		printf(" frames\n");
+	}
+
+	if (caps->features & HRPN_CAPS_FEATURE_CAN)
+		printf("can:\n\tmodes:        0-%u\n", caps->can_modes - 1);
+
+	if (caps->features & HRPN_CAPS_FEATURE_ETHERNET)
+		printf("ethernet:\n\tmodes:        0-%u\n", caps->ethernet_modes - 1);
+}
+
+static void caps_print_json(struct hrpn_resp_caps *caps)
+{
+	struct hrpn_caps_audio_config *config;
+	unsigned int i, n = 0;
+
+	printf("{\"version\":\"%u.%u.%u\",\"features\":[", caps->version >> 16, (caps->version >> 8) & 0xff, caps->version & 0xff);
+
+	for (i = 0; i < sizeof(caps_feature_name) / sizeof(caps_feature_name[0]); i++)
+		if (caps->features & caps_feature_name[i].feature)
+			printf("%s\"%s\"", n++ ? "," : "", caps_feature_name[i].name);
+	printf("]");
+
+	if (caps->features & HRPN_CAPS_FEATURE_LATENCY)
+		printf(",\"latency\":{\"test_cases\":%u,\"loads\":%u,\"modes\":%u,\"period_us_min\":%u,"
+			"\"period_us_max\":%u,\"cpu_mask\":%u,\"mem_size_max\":%u}",
+			caps->latency_test_cases, caps->latency_loads, caps->latency_modes,
+			caps->latency_period_us_min, caps->latency_period_us_max,
+			caps->latency_cpu_mask, caps->latency_mem_size_max);
+
+	if (caps->features & HRPN_CAPS_FEATURE_AUDIO) {
+		printf(",\"audio\":{\"configs\":[");
+
+		for (i = 0; i < caps->audio_config_count; i++) {
+			config = &caps->audio_config[i];
+
+			printf("%s{\"modes\":[", i ? "," : "");
+			caps_print_mask(",", config->modes);
+			printf("],\"rates\":[");
+			caps_print_list(",", config->rates, config->rate_count);
+			printf("]}");
+		}
+
+		printf("],\"periods\":[");
+		caps_print_list(",", caps->audio_periods, caps->audio_period_count);
+		printf("]}");
+	}
+
+	if (caps->features & HRPN_CAPS_FEATURE_CAN)
+		printf(",\"can\":{\"modes\":%u}", caps->can_modes);
+
+	if (caps->features & HRPN_CAPS_FEATURE_ETHERNET)
+		printf(",\"ethernet\":{\"modes\":%u}", caps->ethernet_modes);
+
+	printf("}\n");
+}
+
+int caps_main(int argc, char *argv[], int fd)
+{
+	struct hrpn_resp_caps caps;
+	unsigned int format = CAPS_FORMAT_TEXT;
+	bool refresh = false;
+	int option;
+	int rc = -1;
+
+	while ((option = getopt(argc, argv, "ro:v")) != -1) {
+		switch (option) {
+		case 'r':
+			refresh = true;
+			break;
+
+		case 'o':
+			if (!strcmp(optarg, "text")) {
+				format = CAPS_FORMAT_TEXT;
+			} else if (!strcmp(optarg, "json")) {
+				format = CAPS_FORMAT_JSON;
+			} else {
+				printf("Invalid format\n");
+				goto out;
+			}
+
+			break;
+
+		default:
+			common_main(option, optarg);
+			rc = (option == 'v') ? 0 : -1;
+			goto out;
+		}
+	}
+
+	if (caps_get(fd, &caps, refresh) < 0) {
+		printf("capabilities not available\n");
+		goto out;
+	}
+
+	if (format == CAPS_FORMAT_JSON)
+		caps_print_json(&caps);
+	else
+		caps_print_text(&caps);
+
+	rc = 0;
+
+out:
+	return rc;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _CAPS_H_
+#define _CAPS_H_
+
+#include <stdbool.h>
+
+#include "hrpn_ctrl.h"
+
+/*
+ * Capabilities of the running RTOS application, cached until the inmate cell
+ * is restarted (jh_harpoon.sh removes the file).
+ */
+#define CAPS_CACHE_FILE	"/run/harpoon_caps"
+
+/* Cached capabilities, queried (and cached) if none or @refresh */
+int caps_get(int fd, struct hrpn_resp_caps *caps, bool refresh);
+
+/* Cached capabilities only, returns -1 if none */
+int caps_cached(struct hrpn_resp_caps *caps);
+
+/* Checks an audio run configuration, parameters set to 0 take the RTOS default */
+int caps_audio_check(struct hrpn_resp_caps *caps, unsigned int id, unsigned int frequency,
+		     unsigned int period, unsigned int config_idx);
+
+int caps_main(int argc, char *argv[], int fd);
+void caps_usage(void);
+
+#endif /* _CAPS_H_ */
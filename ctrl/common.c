@@ -1,49 +1,227 @@
 /*
- * Copyright 2022-2023 NXP
+ * Copyright 2022-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
 
 #include "version.h"
 #include "hrpn_ctrl.h"
 #include "rpmsg.h"
 
 #include "common.h"
+#include "ctrl_daemon.h"
 
-extern const struct cmd_handler command_handler[7];
+extern const struct cmd_handler command_handler[9];
 
-int command(int fd, void *cmd, unsigned int cmd_len, unsigned int resp_type, void *resp, unsigned int *resp_len, unsigned int timeout_ms)
+int (*command_defer)(struct command_req *req, unsigned int count);
+
+const struct cmd_handler *cmd_handler_find(const char *name)
 {
-	struct hrpn_response *r;
-	int rc;
+	int i;
+
+	for (i = 0; i < sizeof(command_handler) / sizeof(struct cmd_handler); i++)
+		if (!strcmp(command_handler[i].name, name))
+			return &command_handler[i];
+
+	return NULL;
+}
+
+static uint64_t command_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Request ids, never 0, starting from a per-process value (late responses to a previous process) */
+static uint32_t command_req_id(void)
+{
+	static uint32_t req_id;
+
+	if (!req_id)
+		req_id = getpid();
+
+	req_id = (req_id % HRPN_REQ_ID_MAX) + 1;
+
+	return req_id;
+}
+
+/* Messages sent by the RTOS on its own, before or after the response to a command */
+bool command_unsolicited(uint32_t type)
+{
+	switch (HRPN_TYPE(type)) {
+	case HRPN_RESP_TYPE_LATENCY_SAMPLES:
+	case HRPN_RESP_TYPE_LATENCY_DONE:
+	case HRPN_RESP_TYPE_LATENCY_TRACE:
+	case HRPN_RESP_TYPE_LATENCY_STATS:
+	case HRPN_RESP_TYPE_LATENCY_HIST:
+	case HRPN_RESP_TYPE_TELEMETRY_DATA:
+		return !HRPN_REQ_ID(type);
+
+	default:
+		return false;
+	}
+}
+
+/*
+ * Pending command a response is for, NULL if none: the one with the same
+ * request id, or the oldest one for a response without request id (RTOS
+ * application not echoing them, commands are then handled in order).
+ */
+static struct command_req *command_match(struct command_req *req, unsigned int first, unsigned int sent, uint32_t type)
+{
+	uint32_t req_id = HRPN_REQ_ID(type);
+	unsigned int i;
+
+	if (!req_id)
+		return command_unsolicited(type) ? NULL : &req[first];
+
+	for (i = first; i < sent; i++)
+		if (req[i].pending && (req[i].req_id == req_id))
+			return &req[i];
+
+	return NULL;
+}
+
+static void command_done(struct command_req *q, void *msg, unsigned int len)
+{
+	struct hrpn_resp *r = msg;
+
+	q->pending = false;
 
-	rc = rpmsg_send(fd, cmd, cmd_len);
-	if (!rc) {
-		if (rpmsg_recv(fd, resp, resp_len, (int)timeout_ms) < 0) {
-			printf("command timeout\n");
-			goto exit;
+	if (len > q->resp_len)
+		len = q->resp_len;
+
+	/* callers see the response type only */
+	memcpy(q->resp, msg, len);
+	((struct hrpn_resp *)q->resp)->type = HRPN_TYPE(r->type);
+	q->resp_len = len;
+
+	if (HRPN_TYPE(r->type) != q->resp_type) {
+		q->rc = -1;
+		printf("command response mismatch: %x\n", HRPN_TYPE(r->type));
+	} else if (r->status != HRPN_RESP_STATUS_SUCCESS) {
+		q->rc = -1;
+		printf("command failed\n");
+	} else {
+		q->rc = 0;
+	}
+}
+
+/*
+ * Pipelined commands: sends the @count commands of @req keeping up to
+ * @window of them in flight, each tagged with a request id, and matches the
+ * responses (in any order) by request id. Unsolicited messages received
+ * meanwhile are dropped. Returns -1 if any command failed (see each .rc),
+ * COMMAND_QUEUED if batch mode queued the commands (responses not available).
+ */
+int command_pipeline(int fd, struct command_req *req, unsigned int count, unsigned int window, unsigned int timeout_ms)
+{
+	uint8_t msg[COMMAND_MSG_MAX];
+	struct hrpn_resp *r = (struct hrpn_resp *)msg;
+	struct command_req *q;
+	struct hrpn_cmd *c;
+	unsigned int first = 0, sent = 0, pending = 0, failed = 0;
+	unsigned int len;
+	uint32_t type;
+	uint64_t now;
+
+	if (command_defer)
+		return command_defer(req, count) < 0 ? -1 : COMMAND_QUEUED;
+
+	while (first < count) {
+		while ((sent < count) && (pending < window)) {
+			q = &req[sent++];
+			c = q->cmd;
+
+			q->req_id = command_req_id();
+			q->pending = false;
+			q->rc = -1;
+
+			type = c->type;
+			c->type = HRPN_TYPE_REQ(type, q->req_id);
+
+			if (rpmsg_send(fd, q->cmd, q->cmd_len) < 0) {
+				printf("command send error\n");
+				failed++;
+			} else {
+				q->pending = true;
+				q->deadline_ms = command_time_ms() + timeout_ms;
+				pending++;
+			}
+
+			c->type = type;
 		}
 
-		r = resp;
+		/* oldest pending command, first to time out */
+		while ((first < sent) && !req[first].pending)
+			first++;
+
+		if (!pending)
+			continue;
+
+		now = command_time_ms();
+
+		len = sizeof(msg);
+		if (rpmsg_recv(fd, msg, &len, req[first].deadline_ms > now ? req[first].deadline_ms - now : 0) < 0) {
+			if (command_time_ms() >= req[first].deadline_ms) {
+				printf("command timeout\n");
+				req[first].pending = false;
+				pending--;
+				failed++;
+			}
 
-		if (r->u.resp.type != resp_type) {
-			rc = -1;
-			printf("command response mismatch: %x\n", r->u.resp.type);
-		} else if (r->u.resp.status != HRPN_RESP_STATUS_SUCCESS) {
-			rc = -1;
-			printf("command failed\n");
-		} else {
-			printf("command success\n");
+			continue;
 		}
-	} else {
-		printf("command send error\n");
+
+		if (len < sizeof(*r))
+			continue;
+
+		q = command_match(req, first, sent, r->type);
+		if (!q) {
+			if (!command_unsolicited(r->type))
+				printf("unexpected response: %x\n", r->type);
+
+			continue;
+		}
+
+		command_done(q, msg, len);
+		pending--;
+		if (q->rc < 0)
+			failed++;
 	}
 
-exit:
+	return failed ? -1 : 0;
+}
+
+int command(int fd, void *cmd, unsigned int cmd_len, unsigned int resp_type, void *resp, unsigned int *resp_len, unsigned int timeout_ms)
+{
+	struct command_req req = {
+		.cmd = cmd,
+		.cmd_len = cmd_len,
+		.resp_type = resp_type,
+		.resp = resp,
+		.resp_len = *resp_len,
+	};
+	int rc;
+
+	rc = command_pipeline(fd, &req, 1, 1, timeout_ms);
+	if (rc == COMMAND_QUEUED)
+		return 0;
+
+	if (!rc)
+		printf("command success\n");
+
+	*resp_len = req.resp_len;
+
 	return rc;
 }
 
@@ -80,6 +258,8 @@ void usage(void)
 		printf("%s|", command_handler[i].name);
 
 	printf( "%s] [options]\n", command_handler[i].name);
+	printf( "harpoon_ctrl -f <script> [-p]\n");
+	printf( "harpoon_ctrl --daemon\n");
 
 	printf( "\nOptions:\n");
 
@@ -88,6 +268,19 @@ void usage(void)
 
 	printf( "\nCommon options:\n"
 		"\t-v             print version\n");
+
+	printf( "\nBatch mode:\n"
+		"\t-f <script>    run the commands of a script file (- for stdin), one per line without the\n"
+		"\t               harpoon_ctrl prefix (e.g. \"routing -e 0 -o 0 -i 2 -c\"), '#' starting a comment.\n"
+		"\t               The commands share the control channel, the status of each line is printed\n"
+		"\t-p             pipeline the pipeline, element, routing, can and ethernet commands: they are\n"
+		"\t               sent together, in order, before the next other command or at the end of the\n"
+		"\t               script, and their line status is printed then\n");
+
+	printf( "\nDaemon:\n"
+		"\t--daemon       keep the RPMsg control channel open and serve the commands of local clients over\n"
+		"\t               the %s socket, one at a time (runs in the foreground). harpoon_ctrl\n"
+		"\t               commands use it when it is running\n", CTRL_DAEMON_SOCKET);
 }
 
 void common_main(int option, char *optarg)
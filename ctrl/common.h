@@ -1,12 +1,18 @@
 /*
- * Copyright 2022-2024 NXP
+ * Copyright 2022-2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #ifndef _COMMON_H_
 #define _COMMON_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #define COMMAND_TIMEOUT	5000	/* 5 sec */
+#define COMMAND_WINDOW	16	/* pipelined commands in flight */
+#define COMMAND_MSG_MAX	512	/* RPMsg buffer size */
+#define COMMAND_QUEUED	1	/* command queued by batch mode, sent later */
 #define MAC_ADDRESS_DEFAULT	{0x00, 0xBB, 0xCC, 0xDD, 0xEE, 0x14}
 #define DEFAULT_PERIOD 100000
 #define DEFAULT_NUM_IO_DEV 1
@@ -18,8 +24,29 @@ struct cmd_handler {
 	const char *name;
 	int (* main)(int argc, char *argv[], int fd);
 	void (* usage)(void);
+	bool pipelined;		/* command responses not used, can be queued in batch mode */
 };
 
+/* Pipelined command, see command_pipeline() */
+struct command_req {
+	void *cmd;		/* struct hrpn_cmd first */
+	unsigned int cmd_len;
+	unsigned int resp_type;
+	void *resp;
+	unsigned int resp_len;	/* response buffer size, then response length */
+	int rc;			/* 0: success */
+
+	uint32_t req_id;
+	bool pending;
+	uint64_t deadline_ms;
+};
+
+/* Batch mode: queues the commands instead of sending them, see batch.c */
+extern int (*command_defer)(struct command_req *req, unsigned int count);
+
+const struct cmd_handler *cmd_handler_find(const char *name);
+int command_pipeline(int fd, struct command_req *req, unsigned int count, unsigned int window, unsigned int timeout_ms);
+bool command_unsolicited(uint32_t type);
 int command(int fd, void *cmd, unsigned int cmd_len, unsigned int resp_type, void *resp, unsigned int *resp_len, unsigned int timeout_ms);
 int strtoul_check(const char *nptr, char **endptr, int base, unsigned int *val);
 int read_mac_address(char *buf, uint8_t *mac);
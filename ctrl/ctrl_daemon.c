@@ -0,0 +1,409 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "hrpn_ctrl.h"
+#include "rpmsg.h"
+#include "common.h"
+#include "ctrl_daemon.h"
+
+#define CTRL_DAEMON_CLIENTS_MAX		16
+#define CTRL_DAEMON_REQ_MAX		32	/* commands in flight on the RPMsg channel */
+#define CTRL_DAEMON_SEND_TIMEOUT_MS	1000	/* client not reading its messages */
+
+/* Command in flight, sent with a daemon request id, answered with the client one */
+struct ctrl_daemon_req {
+	int client;		/* -1: free slot */
+	uint32_t req_id;	/* on the RPMsg channel */
+	uint32_t client_req_id;
+	uint64_t deadline_ms;
+};
+
+struct ctrl_daemon {
+	int rpmsg_fd;
+	int listen_fd;
+	int client[CTRL_DAEMON_CLIENTS_MAX];	/* -1: free slot */
+	int current;		/* client receiving the unsolicited RTOS messages, -1: none */
+	int next;		/* first client polled for a command (round robin) */
+	struct ctrl_daemon_req req[CTRL_DAEMON_REQ_MAX];
+	unsigned int pending;	/* commands in flight */
+	uint32_t req_id;	/* latest request id */
+	uint8_t msg[COMMAND_MSG_MAX];
+};
+
+static volatile sig_atomic_t ctrl_daemon_stop_request;
+
+static void ctrl_daemon_signal_handler(int signum)
+{
+	ctrl_daemon_stop_request = 1;
+}
+
+static uint64_t ctrl_daemon_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Drops the commands in flight that timed out, returns the milliseconds before the next timeout (-1: none) */
+static int ctrl_daemon_expire(struct ctrl_daemon *d)
+{
+	uint64_t now = ctrl_daemon_time_ms();
+	uint64_t next = UINT64_MAX;
+	int i;
+
+	for (i = 0; i < CTRL_DAEMON_REQ_MAX; i++) {
+		if (d->req[i].client < 0)
+			continue;
+
+		if (d->req[i].deadline_ms <= now) {
+			printf("command timeout\n");
+			d->req[i].client = -1;
+			d->pending--;
+		} else if (d->req[i].deadline_ms < next) {
+			next = d->req[i].deadline_ms;
+		}
+	}
+
+	return next == UINT64_MAX ? -1 : (int)(next - now);
+}
+
+static void ctrl_daemon_client_close(struct ctrl_daemon *d, int i)
+{
+	close(d->client[i]);
+	d->client[i] = -1;
+
+	/* responses to its commands in flight are still waited for, then dropped */
+	if (d->current == i)
+		d->current = -1;
+}
+
+static void ctrl_daemon_accept(struct ctrl_daemon *d)
+{
+	struct timeval tv = {
+		.tv_sec = CTRL_DAEMON_SEND_TIMEOUT_MS / 1000,
+		.tv_usec = (CTRL_DAEMON_SEND_TIMEOUT_MS % 1000) * 1000,
+	};
+	int fd, i;
+
+	fd = accept4(d->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+	if (fd < 0) {
+		perror("accept4()");
+		return;
+	}
+
+	for (i = 0; i < CTRL_DAEMON_CLIENTS_MAX; i++)
+		if (d->client[i] < 0)
+			break;
+
+	if (i == CTRL_DAEMON_CLIENTS_MAX) {
+		printf("too many clients\n");
+		close(fd);
+		return;
+	}
+
+	if (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) < 0)
+		perror("setsockopt()");
+
+	d->client[i] = fd;
+}
+
+/* Forwards one client command to the RTOS, with a daemon request id (a request slot must be free) */
+static void ctrl_daemon_command(struct ctrl_daemon *d, int i)
+{
+	struct hrpn_cmd *cmd = (struct hrpn_cmd *)d->msg;
+	struct ctrl_daemon_req *req;
+	ssize_t len;
+	int j;
+
+	len = recv(d->client[i], d->msg, sizeof(d->msg), MSG_DONTWAIT | MSG_TRUNC);
+	if (len < 0) {
+		if ((errno == EAGAIN) || (errno == EINTR))
+			return;
+
+		ctrl_daemon_client_close(d, i);
+		return;
+	}
+
+	/* orderly shutdown */
+	if (!len) {
+		ctrl_daemon_client_close(d, i);
+		return;
+	}
+
+	if ((len > sizeof(d->msg)) || (len < sizeof(*cmd))) {
+		printf("invalid command (%zd bytes) dropped\n", len);
+		return;
+	}
+
+	for (j = 0; j < CTRL_DAEMON_REQ_MAX; j++)
+		if (d->req[j].client < 0)
+			break;
+
+	req = &d->req[j];
+	req->client = i;
+	req->client_req_id = HRPN_REQ_ID(cmd->type);
+	req->req_id = d->req_id = (d->req_id % HRPN_REQ_ID_MAX) + 1;
+	req->deadline_ms = ctrl_daemon_time_ms() + COMMAND_TIMEOUT;
+
+	d->current = i;
+
+	cmd->type = HRPN_TYPE_REQ(cmd->type, req->req_id);
+
+	if (rpmsg_send(d->rpmsg_fd, d->msg, len) < 0) {
+		printf("command send error\n");
+		req->client = -1;
+		return;
+	}
+
+	d->pending++;
+}
+
+/*
+ * Command in flight a response is for, NULL if none: the one with the same
+ * request id, or the oldest one for a response without request id (RTOS
+ * application not echoing them, commands are then handled in order).
+ */
+static struct ctrl_daemon_req *ctrl_daemon_match(struct ctrl_daemon *d, uint32_t type)
+{
+	struct ctrl_daemon_req *req = NULL;
+	uint32_t req_id = HRPN_REQ_ID(type);
+	int i;
+
+	for (i = 0; i < CTRL_DAEMON_REQ_MAX; i++) {
+		if (d->req[i].client < 0)
+			continue;
+
+		if (req_id) {
+			if (d->req[i].req_id == req_id)
+				return &d->req[i];
+		} else if (!req || (d->req[i].deadline_ms < req->deadline_ms)) {
+			req = &d->req[i];
+		}
+	}
+
+	return req;
+}
+
+/*
+ * Forwards one RTOS message: a response to the client of the command, with
+ * its own request id, an unsolicited message to the client that sent the
+ * latest command.
+ */
+static void ctrl_daemon_response(struct ctrl_daemon *d)
+{
+	struct hrpn_resp *resp = (struct hrpn_resp *)d->msg;
+	struct ctrl_daemon_req *req;
+	unsigned int len = sizeof(d->msg);
+	int client;
+
+	if (rpmsg_recv(d->rpmsg_fd, d->msg, &len, 0) < 0 || (len < sizeof(*resp)))
+		return;
+
+	if (command_unsolicited(resp->type)) {
+		client = d->current;
+	} else {
+		/* late response to a command that timed out */
+		req = ctrl_daemon_match(d, resp->type);
+		if (!req)
+			return;
+
+		client = req->client;
+		resp->type = HRPN_TYPE_REQ(resp->type, req->client_req_id);
+
+		req->client = -1;
+		d->pending--;
+	}
+
+	if ((client < 0) || (d->client[client] < 0))
+		return;
+
+	if (send(d->client[client], d->msg, len, MSG_NOSIGNAL) != len) {
+		printf("client not reading, message type %x dropped\n", resp->type);
+
+		if (errno == EPIPE)
+			ctrl_daemon_client_close(d, client);
+	}
+}
+
+static int ctrl_daemon_listen(const char *path)
+{
+	struct sockaddr_un addr = {0,};
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		printf("socket path too long: %s\n", path);
+		goto err;
+	}
+
+	fd = ctrl_daemon_connect();
+	if (fd >= 0) {
+		printf("control daemon already running\n");
+		close(fd);
+		goto err;
+	}
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("socket()");
+		goto err;
+	}
+
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	/* stale socket of a previous daemon */
+	unlink(path);
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printf("failed to bind %s: %s\n", path, strerror(errno));
+		goto err_close;
+	}
+
+	if (listen(fd, CTRL_DAEMON_CLIENTS_MAX) < 0) {
+		perror("listen()");
+		goto err_unlink;
+	}
+
+	return fd;
+
+err_unlink:
+	unlink(path);
+
+err_close:
+	close(fd);
+
+err:
+	return -1;
+}
+
+int ctrl_daemon_main(uint32_t dst)
+{
+	struct pollfd pfd[CTRL_DAEMON_CLIENTS_MAX + 2];
+	struct sigaction sa = {0,};
+	struct ctrl_daemon d;
+	int i, j, rc = -1;
+
+	for (i = 0; i < CTRL_DAEMON_CLIENTS_MAX; i++)
+		d.client[i] = -1;
+
+	for (i = 0; i < CTRL_DAEMON_REQ_MAX; i++)
+		d.req[i].client = -1;
+
+	d.current = -1;
+	d.next = 0;
+	d.pending = 0;
+	d.req_id = 0;
+
+	sa.sa_handler = ctrl_daemon_signal_handler;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	d.listen_fd = ctrl_daemon_listen(CTRL_DAEMON_SOCKET);
+	if (d.listen_fd < 0)
+		goto err;
+
+	d.rpmsg_fd = rpmsg_init(dst);
+	if (d.rpmsg_fd < 0)
+		goto err_rpmsg;
+
+	printf("serving %s\n", CTRL_DAEMON_SOCKET);
+
+	while (!ctrl_daemon_stop_request) {
+		pfd[0].fd = d.rpmsg_fd;
+		pfd[0].events = POLLIN;
+		pfd[1].fd = d.listen_fd;
+		pfd[1].events = POLLIN;
+
+		/* with all request slots in use, only client hang-ups are reported */
+		for (i = 0; i < CTRL_DAEMON_CLIENTS_MAX; i++) {
+			pfd[i + 2].fd = d.client[i];
+			pfd[i + 2].events = (d.pending < CTRL_DAEMON_REQ_MAX) ? POLLIN : 0;
+			pfd[i + 2].revents = 0;
+		}
+
+		if (poll(pfd, CTRL_DAEMON_CLIENTS_MAX + 2, ctrl_daemon_expire(&d)) < 0) {
+			if (errno == EINTR)
+				continue;
+
+			perror("poll()");
+			goto out;
+		}
+
+		if (pfd[0].revents & POLLIN)
+			ctrl_daemon_response(&d);
+
+		if (pfd[1].revents & POLLIN)
+			ctrl_daemon_accept(&d);
+
+		/* one command per client and poll round, clients served in turn */
+		for (j = 0; j < CTRL_DAEMON_CLIENTS_MAX; j++) {
+			i = (d.next + j) % CTRL_DAEMON_CLIENTS_MAX;
+
+			if ((d.client[i] < 0) || (pfd[i + 2].fd != d.client[i]) || !pfd[i + 2].revents)
+				continue;
+
+			if ((d.pending == CTRL_DAEMON_REQ_MAX) || !(pfd[i + 2].revents & POLLIN)) {
+				if (pfd[i + 2].revents & (POLLHUP | POLLERR))
+					ctrl_daemon_client_close(&d, i);
+
+				continue;
+			}
+
+			ctrl_daemon_command(&d, i);
+		}
+
+		d.next = (d.next + 1) % CTRL_DAEMON_CLIENTS_MAX;
+	}
+
+	rc = 0;
+
+out:
+	for (i = 0; i < CTRL_DAEMON_CLIENTS_MAX; i++)
+		if (d.client[i] >= 0)
+			close(d.client[i]);
+
+	rpmsg_deinit(d.rpmsg_fd);
+
+err_rpmsg:
+	close(d.listen_fd);
+	unlink(CTRL_DAEMON_SOCKET);
+
+err:
+	return rc;
+}
+
+int ctrl_daemon_connect(void)
+{
+	struct sockaddr_un addr = {0,};
+	int fd;
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return -1;
+
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, CTRL_DAEMON_SOCKET);
+
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _CTRL_DAEMON_H_
+#define _CTRL_DAEMON_H_
+
+#include <stdint.h>
+
+#define CTRL_DAEMON_SOCKET	"/run/harpoon_ctrl.sock"
+
+/*
+ * Control daemon: keeps the RPMsg control endpoint open and serves local
+ * clients over a Unix sequenced-packet socket, one hrpn_ctrl.h message per
+ * packet, exactly as exchanged on the RPMsg device (a client can use the
+ * socket in place of /dev/rpmsgN).
+ *
+ * The commands of all clients share the RPMsg channel, several of them in
+ * flight: each is sent with a daemon request id, and its response goes back
+ * to its client with the client request id (HRPN_REQ_ID()). Unsolicited
+ * messages (raw samples, statistics, end of run) go to the client that sent
+ * the latest command.
+ */
+int ctrl_daemon_main(uint32_t dst);
+
+/* Connects to a running control daemon, returns -1 if none */
+int ctrl_daemon_connect(void);
+
+#endif /* _CTRL_DAEMON_H_ */
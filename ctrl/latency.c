@@ -0,0 +1,1295 @@
+/*
+ * Copyright 2021-2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+
+#include "hrpn_ctrl.h"
+#include "rpmsg.h"
+#include "common.h"
+#include "latency_baseline.h"
+#include "latency_ipc.h"
+#include "linux_load.h"
+
+#define LATENCY_CAPTURE_MAGIC		"HRPNLAT"
+#define LATENCY_CAPTURE_VERSION		1
+#define LATENCY_CAPTURE_POLL_MS		100
+
+/*
+ * Capture file layout: one header, followed by struct hrpn_latency_sample
+ * records (native endianness, counter ticks) in capture order.
+ */
+struct latency_capture_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t frequency;	/* counter frequency (Hz) */
+};
+
+struct latency_capture {
+	FILE *file;
+	bool header_done;
+	uint32_t next_seq;
+	uint32_t lost_batches;
+	uint32_t dropped;
+	unsigned long long samples;
+};
+
+/* Outlier trace being reassembled */
+struct latency_trace {
+	struct hrpn_trace_event *events;
+	uint32_t seq;
+	uint32_t total;
+	uint32_t received;
+	unsigned int count;	/* traces printed */
+};
+
+/* Upper bound of the trace size, to validate messages */
+#define LATENCY_TRACE_EVENTS_TOTAL_MAX	65536
+
+static const char *latency_trace_event_name[HRPN_TRACE_EV_MAX] = {
+	[HRPN_TRACE_EV_IRQ_ENTRY] = "irq entry",
+	[HRPN_TRACE_EV_IRQ_EXIT] = "irq exit",
+	[HRPN_TRACE_EV_TICK] = "tick",
+	[HRPN_TRACE_EV_TASK_SWITCH] = "task switch",
+	[HRPN_TRACE_EV_CACHE_INVAL_ENTRY] = "cache inval entry",
+	[HRPN_TRACE_EV_CACHE_INVAL_EXIT] = "cache inval exit",
+	[HRPN_TRACE_EV_LATENCY_IRQ] = "latency irq",
+	[HRPN_TRACE_EV_LATENCY_WAKEUP] = "latency wake-up",
+};
+
+/* Campaign runs */
+#define LATENCY_CAMPAIGN_DURATION_S	10	/* default run duration */
+#define LATENCY_CAMPAIGN_ARGS_MAX	64
+#define LATENCY_CAMPAIGN_LINE_MAX	1024
+#define LATENCY_CAMPAIGN_OPTIONS	"+r:qPKWT:L:l:p:i:I:S:M:b:d:c:C:w:"
+
+#define LATENCY_PERIOD_US_DEFAULT	100
+#define LATENCY_MEM_SIZE_DEFAULT	(64 * 1024)
+
+enum {
+	LATENCY_OPT_CAMPAIGN = 0x100,
+	LATENCY_OPT_BASELINE_SAVE,
+	LATENCY_OPT_BASELINE,
+	LATENCY_OPT_SOAK_READ,
+};
+
+struct latency_campaign {
+	int fd;
+	FILE *file;		/* report, NULL if none */
+	bool json;		/* JSON report, CSV otherwise */
+	struct latency_baseline baseline;
+	bool baseline_save;
+	bool baseline_compare;
+	unsigned int duration_s;	/* run duration, if not set by the run options */
+	unsigned int runs;
+	unsigned int failed;
+	unsigned int records;
+};
+
+/* Command line options of a test case run */
+struct latency_opts {
+	struct hrpn_cmd_latency_run run;
+	bool is_run_cmd;
+	bool has_load;
+	bool has_mem_load;
+	const char *capture_path;
+	const char *load_profile;
+};
+
+const char *latency_metric_name[HRPN_LATENCY_METRIC_MAX] = {
+	[HRPN_LATENCY_METRIC_IRQ_DELAY] = "irq_delay",
+	[HRPN_LATENCY_METRIC_IRQ_TO_SCHED] = "irq_to_sched",
+	[HRPN_LATENCY_METRIC_SCHED_SWITCH] = "sched_switch",
+	[HRPN_LATENCY_METRIC_SCHED_PREEMPT] = "sched_preempt",
+	[HRPN_LATENCY_METRIC_SCHED_YIELD] = "sched_yield",
+	[HRPN_LATENCY_METRIC_SCHED_MUTEX_PI] = "sched_mutex_pi",
+};
+
+static const char *latency_mem_pattern_name[HRPN_LATENCY_MEM_PATTERN_MAX] = {
+	[HRPN_LATENCY_MEM_READ_WRITE] = "rw",
+	[HRPN_LATENCY_MEM_READ] = "r",
+	[HRPN_LATENCY_MEM_WRITE] = "w",
+	[HRPN_LATENCY_MEM_RANDOM] = "rand",
+};
+
+static const struct option latency_long_options[] = {
+	{ "campaign", required_argument, NULL, LATENCY_OPT_CAMPAIGN },
+	{ "baseline-save", required_argument, NULL, LATENCY_OPT_BASELINE_SAVE },
+	{ "baseline", required_argument, NULL, LATENCY_OPT_BASELINE },
+	{ "soak-read", required_argument, NULL, LATENCY_OPT_SOAK_READ },
+	{ NULL, 0, NULL, 0 },
+};
+
+static volatile sig_atomic_t latency_stop_request;
+
+void latency_usage(void)
+{
+	printf(
+		"\nLatency options:\n"
+		"\t-r <id>        run latency test case id (0: custom test case, load set with -l)\n"
+		"\t-l <mask>      custom test case load mask:\n"
+		"\t               0x02 - IRQ load\n"
+		"\t               0x04 - CPU load\n"
+		"\t               0x08 - semaphore load in the CPU load task\n"
+		"\t               0x10 - cache invalidation\n"
+		"\t               0x20 - Linux load\n"
+		"\t               0x40 - OCRAM (alternate DDR and OCRAM copies of the measurement code, reports the gain)\n"
+		"\t               0x80 - memory interference (buffer streaming, set with -M)\n"
+		"\t-p <us>        latency alarm period (default 100 us)\n"
+		"\t-i <us>        IRQ load handler duration (default 10 us)\n"
+		"\t-I <us>        IRQ load period (default: once, just before each latency alarm)\n"
+		"\t-b <bits>      histogram resolution, from 2 (coarse) to 7 (default, < 1.6%% error)\n"
+		"\t-d <seconds>   test duration (default: until stopped)\n"
+		"\t-q             quiet testing (Do not dump stats regularly, but only once on test case stop)\n"
+		"\t-P             periodic mode: alarms on an absolute t0 + n * period timeline (reports wake-up jitter,\n"
+		"\t               accumulated drift and missed deadlines), instead of re-arming one period after each wake-up\n"
+		"\t-K             scheduling benchmark, instead of the irq latency: RTOS costs of task switch, preemption,\n"
+		"\t               yield and mutex hand-over with priority inheritance, measured task to task without any\n"
+		"\t               alarm (no IRQ load, capture, tracing, wake-up matrix, storm, soak mode, OCRAM or SMP)\n"
+		"\t-R <file>      with -r, capture raw samples (programmed, IRQ and wake-up counter ticks) to a binary file,\n"
+		"\t               the test case is stopped on Ctrl-C\n"
+		"\t-W             wake-up matrix: rotate the IRQ to task wake-up over semaphore, message queue and\n"
+		"\t               native notification (FreeRTOS task notification, Zephyr event), and add task to task\n"
+		"\t               wake-ups (same primitives plus mutex), with one histogram per primitive\n"
+		"\t-c <mask>      cores running a benchmark task, each with its own counters and statistics, plus\n"
+		"\t               aggregated statistics (Zephyr SMP builds, default: first core)\n"
+		"\t-C <mask>      cores running the CPU load and cache invalidation tasks (Zephyr SMP builds, default:\n"
+		"\t               benchmark cores), the IRQ load always runs on the benchmark cores\n"
+		"\t-w <seconds>   soak mode: keep the irq delay statistics (min, avg, max and percentiles) of each window of\n"
+		"\t               this duration, for the latest 4320 windows (72 h of 1 min windows, 1440 windows on the\n"
+		"\t               i.MX 95 and i.MX 943 Zephyr cells), read with --soak-read\n"
+		"\t--soak-read <file>\n"
+		"\t               read the soak mode windows to a CSV file (-: standard output), while the test case runs\n"
+		"\t               or after it ended, with the start of each window (seconds since the test case start,\n"
+		"\t               and generic timer count) and its actual duration\n"
+		"\t-T <us>        with -r, print the RTOS events (IRQs, ticks, task switches, cache invalidations) that\n"
+		"\t               preceded each irq delay above this threshold, the test case is stopped on Ctrl-C\n"
+		"\t               (RTOS application built with the event tracer, see README)\n"
+		"\t-S <period_us>:<duration_us>[:<prio>[:<nest>]]\n"
+		"\t               interrupt storm source (up to %d, option repeated): software interrupt every\n"
+		"\t               <period_us>, with a <duration_us> handler, at RTOS interrupt priority <prio> (9: highest\n"
+		"\t               to 14: lowest, default: latency alarm priority), raising <nest> nested interrupts, each\n"
+		"\t               one priority level higher. Storm and baseline alternate by windows of iterations, the\n"
+		"\t               irq delay shift is reported (not with the IRQ load)\n"
+		"\t-M <size>[:<stride>[:<pattern>]]\n"
+		"\t               memory interference load footprint per load core (K or M suffix, default 64K), access\n"
+		"\t               stride in bytes (multiple of 4, default 64) and pattern: rw (read-modify-write, default),\n"
+		"\t               r (read), w (write) or rand (random read), e.g. '-r 0 -l 0x80 -M 512K:64:rand'. The\n"
+		"\t               maximum footprint depends on the build (at least 16K)\n"
+		"\t-m <count>     IPC round trip benchmark: <count> pings per payload size (16 to 256 bytes) on the raw\n"
+		"\t               rpmsg path, then (up to 50) on the control path, with the one-way delays\n"
+		"\t--campaign <spec>\n"
+		"\t               run the test cases of a spec file one after the other, and write their statistics\n"
+		"\t               (count, min, avg, max and percentiles, received from the RTOS) to the -o report file\n"
+		"\t               (JSON with a .json extension, CSV otherwise). Spec file: one run per line, with the\n"
+		"\t               above run options (-r required, no -R), comma separated values of -r, -p, -l and -M\n"
+		"\t               are swept, e.g. '-r 0 -l 0x2,0x4 -p 100,500' or '-r 0 -l 0x80 -M 16K,128K,512K' (latency\n"
+		"\t               as a function of the memory load footprint). Runs without -d last the command line -d\n"
+		"\t               duration (default %d s)\n"
+		"\t-o <file>      campaign report file\n"
+		"\t--baseline-save <name>\n"
+		"\t               save the campaign latency histograms as a baseline for this board (a name with a '/'\n"
+		"\t               is a file path, otherwise stored in /var/lib/harpoon/baselines), once all runs succeeded\n"
+		"\t--baseline <name>\n"
+		"\t               compare the campaign to a baseline of the same runs: the tails (p99 to p99.999) regress\n"
+		"\t               if the share of samples above the baseline values increases significantly (one-sided\n"
+		"\t               two-proportion z-test, p < 0.001, and more than 25%%), the command then fails, as it does\n"
+		"\t               if a metric could not be compared (missing from the baseline, or too few samples)\n"
+		"\t-s             stop running test case\n",
+		HRPN_LATENCY_IRQ_STORM_SOURCES_MAX, LATENCY_CAMPAIGN_DURATION_S
+	);
+
+	linux_load_usage();
+}
+
+static void latency_signal_handler(int signum)
+{
+	latency_stop_request = 1;
+}
+
+static int latency_capture_write(struct latency_capture *cap, struct hrpn_resp_latency_samples *msg, unsigned int len)
+{
+	struct latency_capture_header header;
+
+	if ((len < offsetof(struct hrpn_resp_latency_samples, samples)) ||
+	    (msg->count > HRPN_LATENCY_SAMPLES_MAX) ||
+	    (len < offsetof(struct hrpn_resp_latency_samples, samples) + msg->count * sizeof(struct hrpn_latency_sample))) {
+		printf("invalid samples message (len: %u)\n", len);
+		return -1;
+	}
+
+	if (!cap->header_done) {
+		memset(&header, 0, sizeof(header));
+		strncpy(header.magic, LATENCY_CAPTURE_MAGIC, sizeof(header.magic));
+		header.version = LATENCY_CAPTURE_VERSION;
+		header.frequency = msg->frequency;
+
+		if (fwrite(&header, sizeof(header), 1, cap->file) != 1)
+			goto err_write;
+
+		cap->header_done = true;
+		cap->next_seq = msg->seq;
+	}
+
+	cap->lost_batches += msg->seq - cap->next_seq;
+	cap->next_seq = msg->seq + 1;
+	cap->dropped = msg->dropped;
+
+	if (fwrite(msg->samples, sizeof(struct hrpn_latency_sample), msg->count, cap->file) != msg->count)
+		goto err_write;
+
+	cap->samples += msg->count;
+
+	return 0;
+
+err_write:
+	perror("fwrite()");
+	return -1;
+}
+
+/* Times relative to the last event, the wake-up that measured the outlier */
+static void latency_trace_print(struct latency_trace *trace, uint32_t value, uint32_t frequency)
+{
+	struct hrpn_trace_event *ev;
+	uint64_t last = trace->events[trace->total - 1].ts;
+	char name[5];
+	uint32_t i;
+
+	printf("outlier #%u: irq delay %u ns, %u events (time in us, relative to the outlier wake-up)\n",
+	       trace->seq, value, trace->total);
+
+	for (i = 0; i < trace->total; i++) {
+		ev = &trace->events[i];
+
+		printf("  %12.3f  ", frequency ? (double)(int64_t)(ev->ts - last) * 1000000 / frequency : 0.);
+
+		if ((ev->type < HRPN_TRACE_EV_MAX) && latency_trace_event_name[ev->type])
+			printf("%-18s", latency_trace_event_name[ev->type]);
+		else
+			printf("event %-12u", ev->type);
+
+		switch (ev->type) {
+		case HRPN_TRACE_EV_IRQ_ENTRY:
+		case HRPN_TRACE_EV_IRQ_EXIT:
+			if (ev->arg != HRPN_TRACE_IRQ_UNKNOWN)
+				printf(" %u", ev->arg);
+			break;
+
+		case HRPN_TRACE_EV_TICK:
+			printf(" %u", ev->arg);
+			break;
+
+		case HRPN_TRACE_EV_TASK_SWITCH:
+			memcpy(name, &ev->arg, 4);
+			name[4] = '\0';
+			printf(" %s", name);
+			break;
+
+		case HRPN_TRACE_EV_LATENCY_WAKEUP:
+			printf(" irq delay %u ns", ev->arg);
+			break;
+
+		default:
+			break;
+		}
+
+		printf("\n");
+	}
+
+	trace->count++;
+}
+
+static int latency_trace_store(struct latency_trace *trace, struct hrpn_resp_latency_trace *msg, unsigned int len)
+{
+	if ((len < offsetof(struct hrpn_resp_latency_trace, events)) ||
+	    (msg->count > HRPN_LATENCY_TRACE_EVENTS_MAX) ||
+	    (len < offsetof(struct hrpn_resp_latency_trace, events) + msg->count * sizeof(struct hrpn_trace_event)) ||
+	    !msg->total || (msg->total > LATENCY_TRACE_EVENTS_TOTAL_MAX) ||
+	    (msg->index + msg->count > msg->total)) {
+		printf("invalid trace message (len: %u)\n", len);
+		return -1;
+	}
+
+	if (!msg->index) {
+		free(trace->events);
+
+		trace->events = calloc(msg->total, sizeof(struct hrpn_trace_event));
+		if (!trace->events) {
+			printf("trace allocation failed\n");
+			return -1;
+		}
+
+		trace->seq = msg->seq;
+		trace->total = msg->total;
+		trace->received = 0;
+	}
+
+	/* batches of a trace are sent in order, drop anything else */
+	if (!trace->events || (msg->seq != trace->seq) || (msg->total != trace->total) ||
+	    (msg->index != trace->received)) {
+		printf("trace message out of sequence\n");
+		return -1;
+	}
+
+	memcpy(&trace->events[msg->index], msg->events, msg->count * sizeof(struct hrpn_trace_event));
+	trace->received += msg->count;
+
+	if (trace->received == trace->total) {
+		latency_trace_print(trace, msg->value, msg->frequency);
+
+		free(trace->events);
+		trace->events = NULL;
+	}
+
+	return 0;
+}
+
+static int latency_stats_store(struct latency_stats *stats, struct hrpn_resp_latency_stats *msg, unsigned int len)
+{
+	if ((len != sizeof(*msg)) || (msg->metric >= HRPN_LATENCY_METRIC_MAX)) {
+		printf("invalid statistics message (len: %u)\n", len);
+		return -1;
+	}
+
+	if (stats->count == sizeof(stats->entry) / sizeof(stats->entry[0])) {
+		printf("too many statistics messages\n");
+		return -1;
+	}
+
+	memset(&stats->entry[stats->count], 0, sizeof(stats->entry[0]));
+	stats->entry[stats->count++].stats = *msg;
+
+	return 0;
+}
+
+/* Histogram of the latest statistics message, the buckets of a histogram are sent in order */
+static int latency_hist_store(struct latency_stats *stats, struct hrpn_resp_latency_hist *msg, unsigned int len)
+{
+	struct latency_stats_entry *e;
+	uint32_t i, index;
+
+	if ((len != sizeof(*msg)) || (msg->count > HRPN_LATENCY_HIST_BUCKETS_MAX) ||
+	    (msg->index + msg->count > msg->total) ||
+	    (msg->sub_bits < HDR_HIST_SUB_BITS_MIN) || (msg->sub_bits > HDR_HIST_SUB_BITS_MAX)) {
+		printf("invalid histogram message (len: %u)\n", len);
+		return -1;
+	}
+
+	e = stats->count ? &stats->entry[stats->count - 1] : NULL;
+
+	if (!e || (e->stats.core != msg->core) || (e->stats.metric != msg->metric) ||
+	    (msg->index != e->hist_received)) {
+		printf("histogram message out of sequence\n");
+		return -1;
+	}
+
+	if (!msg->index)
+		hdr_hist_init(&e->hist, latency_metric_name[e->stats.metric], msg->sub_bits);
+	else if (msg->sub_bits != e->hist.sub_bits)
+		return -1;
+
+	for (i = 0; i < msg->count; i++) {
+		index = msg->buckets[i].index;
+		if (index >= HDR_HIST_BUCKETS(msg->sub_bits))
+			return -1;
+
+		e->hist.count[index] = msg->buckets[i].count;
+		e->hist.total += msg->buckets[i].count;
+	}
+
+	e->hist_received += msg->count;
+
+	if (e->hist_received == msg->total) {
+		e->hist.min = e->stats.min;
+		e->hist.max = e->stats.max;
+		e->hist.sum = (uint64_t)e->stats.mean * e->stats.count;
+		e->hist_valid = e->hist.total == e->stats.count;
+	}
+
+	return 0;
+}
+
+/*
+ * Wait for the end of the test case: duration elapsed or stop requested
+ * (Ctrl-C), in which case the test case is stopped. In capture mode, sample
+ * batches are stored meanwhile; the RTOS flushes the remaining samples before
+ * answering the stop command, so keep storing batches until the latency
+ * response is received. Outlier traces are printed as they come, end of run
+ * statistics are stored in @stats (if not NULL).
+ */
+static int latency_wait(int fd, const char *path, struct latency_stats *stats)
+{
+	struct hrpn_cmd_latency_stop stop;
+	struct hrpn_response resp;
+	struct latency_capture cap = {0,};
+	struct latency_trace trace = {0,};
+	struct sigaction sa;
+	unsigned int len;
+	int rc = -1;
+
+	if (path) {
+		cap.file = fopen(path, "wb");
+		if (!cap.file) {
+			printf("failed to open %s: %s\n", path, strerror(errno));
+			goto stop;
+		}
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = latency_signal_handler;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	if (path)
+		printf("capturing samples to %s, press Ctrl-C to stop\n", path);
+	else
+		printf("test case running, press Ctrl-C to stop\n");
+
+	while (!latency_stop_request) {
+		len = sizeof(resp);
+		if (rpmsg_recv(fd, &resp, &len, LATENCY_CAPTURE_POLL_MS) < 0)
+			continue;
+
+		if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_SAMPLES) {
+			if (cap.file && (latency_capture_write(&cap, &resp.u.latency_samples, len) < 0))
+				break;
+		} else if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_TRACE) {
+			latency_trace_store(&trace, &resp.u.latency_trace, len);
+		} else if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_STATS) {
+			if (stats)
+				latency_stats_store(stats, &resp.u.latency_stats, len);
+		} else if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_HIST) {
+			if (stats)
+				latency_hist_store(stats, &resp.u.latency_hist, len);
+		} else if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_DONE) {
+			/* test duration elapsed, all samples were sent before */
+			printf("test case completed\n");
+			rc = 0;
+			goto out;
+		}
+	}
+
+stop:
+	stop.type = HRPN_CMD_TYPE_LATENCY_STOP;
+
+	if (rpmsg_send(fd, &stop, sizeof(stop)) < 0) {
+		printf("command send error\n");
+		goto out;
+	}
+
+	while (1) {
+		len = sizeof(resp);
+		if (rpmsg_recv(fd, &resp, &len, COMMAND_TIMEOUT) < 0) {
+			printf("command timeout\n");
+			break;
+		}
+
+		if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_SAMPLES) {
+			if (cap.file)
+				latency_capture_write(&cap, &resp.u.latency_samples, len);
+
+			continue;
+		}
+
+		if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_TRACE) {
+			latency_trace_store(&trace, &resp.u.latency_trace, len);
+			continue;
+		}
+
+		if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_STATS) {
+			if (stats)
+				latency_stats_store(stats, &resp.u.latency_stats, len);
+
+			continue;
+		}
+
+		if (resp.u.resp.type == HRPN_RESP_TYPE_LATENCY_HIST) {
+			if (stats)
+				latency_hist_store(stats, &resp.u.latency_hist, len);
+
+			continue;
+		}
+
+		if (resp.u.resp.type != HRPN_RESP_TYPE_LATENCY) {
+			printf("command response mismatch: %x\n", resp.u.resp.type);
+		} else if (resp.u.resp.status != HRPN_RESP_STATUS_SUCCESS) {
+			printf("command failed\n");
+		} else {
+			printf("command success\n");
+			rc = (!path || cap.file) ? 0 : -1;
+		}
+
+		break;
+	}
+
+out:
+	if (cap.file) {
+		if (fclose(cap.file))
+			perror("fclose()");
+
+		printf("%llu samples captured, %u dropped (capture ring full), %u batches lost\n",
+		       cap.samples, cap.dropped, cap.lost_batches);
+	}
+
+	if (trace.count)
+		printf("%u outlier traces received\n", trace.count);
+
+	free(trace.events);
+
+	return rc;
+}
+
+static int latency_run(int fd, struct hrpn_cmd_latency_run *run)
+{
+	struct hrpn_response resp;
+	unsigned int len;
+
+	run->type = HRPN_CMD_TYPE_LATENCY_RUN;
+
+	len = sizeof(resp);
+
+	return command(fd, run, sizeof(*run), HRPN_RESP_TYPE_LATENCY, &resp, &len, COMMAND_TIMEOUT);
+}
+
+/* <period_us>:<duration_us>[:<prio>[:<nest>]] */
+static int latency_irq_source_parse(const char *arg, struct hrpn_latency_irq_source *src)
+{
+	char c;
+	int rc;
+
+	src->prio = 0;
+	src->nest = 0;
+
+	rc = sscanf(arg, "%u:%u:%u:%u%c", &src->period_us, &src->duration_us, &src->prio, &src->nest, &c);
+	if ((rc < 2) || (rc > 4))
+		return -1;
+
+	return 0;
+}
+
+/* <size>[K|M][:<stride>[:<pattern>]], @arg is left unchanged (campaign sweeps parse it again) */
+static int latency_mem_parse(const char *arg, struct hrpn_cmd_latency_run *run)
+{
+	unsigned long size, stride = 0;
+	char *end;
+	unsigned int i;
+
+	size = strtoul(arg, &end, 0);
+	if (end == arg)
+		return -1;
+
+	if ((*end == 'K') || (*end == 'k')) {
+		size *= 1024;
+		end++;
+	} else if ((*end == 'M') || (*end == 'm')) {
+		size *= 1024 * 1024;
+		end++;
+	}
+
+	run->mem_pattern = HRPN_LATENCY_MEM_READ_WRITE;
+
+	if (*end == ':') {
+		arg = end + 1;
+		stride = strtoul(arg, &end, 0);
+		if ((end == arg) || !stride)
+			return -1;
+
+		if (*end == ':') {
+			for (i = 0; i < HRPN_LATENCY_MEM_PATTERN_MAX; i++)
+				if (!strcmp(end + 1, latency_mem_pattern_name[i]))
+					break;
+
+			if (i == HRPN_LATENCY_MEM_PATTERN_MAX)
+				return -1;
+
+			run->mem_pattern = i;
+			end += strlen(end);
+		}
+	}
+
+	if (*end || !size || (size > UINT32_MAX) || (stride > UINT32_MAX))
+		return -1;
+
+	run->mem_size = size;
+	run->mem_stride = stride;
+
+	return 0;
+}
+
+/* Soak mode ring, from the oldest window still recorded, to a CSV file ("-": standard output) */
+static int latency_soak_read(int fd, const char *path)
+{
+	struct hrpn_cmd_latency_soak_read cmd;
+	struct hrpn_response resp;
+	struct hrpn_resp_latency_soak *soak = &resp.u.latency_soak;
+	struct hrpn_latency_soak_entry *e;
+	FILE *file = stdout;
+	uint32_t seq = 0, windows = 0, i;
+	unsigned int len;
+	int rc = -1;
+
+	if (strcmp(path, "-")) {
+		file = fopen(path, "w");
+		if (!file) {
+			printf("failed to open %s: %s\n", path, strerror(errno));
+			return -1;
+		}
+	}
+
+	fprintf(file, "time_s,timestamp,duration_ms,count,min_ns,avg_ns,max_ns,p50_ns,p99_ns,p99_99_ns,irq_to_sched_max_ns,late_alarm_sched\n");
+
+	cmd.type = HRPN_CMD_TYPE_LATENCY_SOAK_READ;
+
+	do {
+		cmd.seq = seq;
+
+		if (rpmsg_send(fd, &cmd, sizeof(cmd)) < 0) {
+			printf("command send error\n");
+			goto out;
+		}
+
+		/* skip the unsolicited messages of a running test case */
+		do {
+			len = sizeof(resp);
+			if (rpmsg_recv(fd, &resp, &len, COMMAND_TIMEOUT) < 0) {
+				printf("command timeout\n");
+				goto out;
+			}
+		} while (resp.u.resp.type != HRPN_RESP_TYPE_LATENCY_SOAK);
+
+		if ((resp.u.resp.status != HRPN_RESP_STATUS_SUCCESS) || (len != sizeof(*soak)) ||
+		    (soak->count > HRPN_LATENCY_SOAK_ENTRIES_MAX)) {
+			printf("command failed\n");
+			goto out;
+		}
+
+		if (!soak->window_s) {
+			printf("no soak mode test case ran (-w)\n");
+			goto out;
+		}
+
+		if (soak->seq > seq)
+			printf("%u windows overwritten (ring full)\n", soak->seq - seq);
+
+		for (i = 0; i < soak->count; i++) {
+			e = &soak->entries[i];
+
+			/* window start, since the test case start, and as a generic timer count (shared with Linux) */
+			fprintf(file, "%.3f,%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+				soak->frequency ? (double)(e->start - soak->start) / soak->frequency : 0.,
+				(unsigned long long)e->start, e->duration_ms, e->count,
+				e->min, e->mean, e->max, e->p50, e->p99, e->p99_99,
+				e->irq_to_sched_max, e->late_alarm_sched);
+		}
+
+		windows += soak->count;
+		seq = soak->seq + soak->count;
+	} while (soak->count && (seq < soak->total));
+
+	printf("%u windows of %u s read, %u missed\n", windows, soak->window_s, soak->missed);
+	rc = 0;
+
+out:
+	if ((file != stdout) && fclose(file)) {
+		perror("fclose()");
+		rc = -1;
+	}
+
+	return rc;
+}
+
+static int latency_stop(int fd)
+{
+	struct hrpn_cmd_latency_stop stop;
+	struct hrpn_response resp;
+	unsigned int len;
+
+	stop.type = HRPN_CMD_TYPE_LATENCY_STOP;
+
+	len = sizeof(resp);
+
+	return command(fd, &stop, sizeof(stop), HRPN_RESP_TYPE_LATENCY, &resp, &len, COMMAND_TIMEOUT);
+}
+
+/*
+ * Test case run options, shared by the command line and the campaign runs.
+ * Returns 1 if @option is not a run option.
+ */
+static int latency_run_option(struct latency_opts *opts, int option, char *arg)
+{
+	struct hrpn_cmd_latency_run *run = &opts->run;
+
+	switch (option) {
+	case 'r':
+		if (strtoul_check(arg, NULL, 0, &run->id) < 0) {
+			printf("Invalid id\n");
+			return -1;
+		}
+
+		opts->is_run_cmd = true;
+		break;
+
+	case 'q':
+		run->quiet = true;
+		break;
+
+	case 'P':
+		run->mode = HRPN_LATENCY_MODE_PERIODIC;
+		break;
+
+	case 'K':
+		run->mode = HRPN_LATENCY_MODE_SCHED;
+		break;
+
+	case 'W':
+		run->wakeup_matrix = true;
+		break;
+
+	case 'R':
+		opts->capture_path = arg;
+		break;
+
+	case 'T':
+		if ((strtoul_check(arg, NULL, 0, &run->trace_threshold_us) < 0) || !run->trace_threshold_us) {
+			printf("Invalid trace threshold\n");
+			return -1;
+		}
+
+		break;
+
+	case 'L':
+		if (strlen(arg) >= HRPN_LATENCY_LINUX_LOAD_LEN) {
+			printf("Linux load profile too long (max %d characters)\n",
+			       HRPN_LATENCY_LINUX_LOAD_LEN - 1);
+			return -1;
+		}
+
+		opts->load_profile = arg;
+		strcpy(run->linux_load, arg);
+		break;
+
+	case 'l':
+		if (strtoul_check(arg, NULL, 0, &run->load) < 0) {
+			printf("Invalid load mask\n");
+			return -1;
+		}
+
+		opts->has_load = true;
+		break;
+
+	case 'p':
+		if (strtoul_check(arg, NULL, 0, &run->period_us) < 0) {
+			printf("Invalid period\n");
+			return -1;
+		}
+
+		break;
+
+	case 'i':
+		if (strtoul_check(arg, NULL, 0, &run->irq_load_duration_us) < 0) {
+			printf("Invalid IRQ load duration\n");
+			return -1;
+		}
+
+		break;
+
+	case 'I':
+		if (strtoul_check(arg, NULL, 0, &run->irq_load_period_us) < 0) {
+			printf("Invalid IRQ load period\n");
+			return -1;
+		}
+
+		break;
+
+	case 'S':
+		if ((run->irq_storm_count >= HRPN_LATENCY_IRQ_STORM_SOURCES_MAX) ||
+		    (latency_irq_source_parse(arg, &run->irq_storm[run->irq_storm_count]) < 0)) {
+			printf("Invalid interrupt storm source\n");
+			return -1;
+		}
+
+		run->irq_storm_count++;
+		break;
+
+	case 'M':
+		if (latency_mem_parse(arg, run) < 0) {
+			printf("Invalid memory load\n");
+			return -1;
+		}
+
+		opts->has_mem_load = true;
+		break;
+
+	case 'b':
+		if (strtoul_check(arg, NULL, 0, &run->hist_sub_bits) < 0) {
+			printf("Invalid histogram resolution\n");
+			return -1;
+		}
+
+		break;
+
+	case 'd':
+		if (strtoul_check(arg, NULL, 0, &run->duration_s) < 0) {
+			printf("Invalid duration\n");
+			return -1;
+		}
+
+		break;
+
+	case 'c':
+		if ((strtoul_check(arg, NULL, 0, &run->cpu_mask) < 0) || !run->cpu_mask) {
+			printf("Invalid benchmark core mask\n");
+			return -1;
+		}
+
+		break;
+
+	case 'C':
+		if ((strtoul_check(arg, NULL, 0, &run->load_cpu_mask) < 0) || !run->load_cpu_mask) {
+			printf("Invalid load core mask\n");
+			return -1;
+		}
+
+		break;
+
+	case 'w':
+		if ((strtoul_check(arg, NULL, 0, &run->soak_window_s) < 0) || !run->soak_window_s) {
+			printf("Invalid soak window\n");
+			return -1;
+		}
+
+		break;
+
+	default:
+		return 1;
+	}
+
+	return 0;
+}
+
+static int latency_run_check(struct latency_opts *opts)
+{
+	if ((opts->capture_path || opts->load_profile || opts->run.trace_threshold_us) && !opts->is_run_cmd) {
+		printf("Capture, outlier tracing and Linux load require a test case to run (-r)\n");
+		return -1;
+	}
+
+	if (opts->is_run_cmd && (opts->has_load != (opts->run.id == HRPN_LATENCY_TEST_CASE_CUSTOM))) {
+		printf("Load mask (-l) must be set for, and only for, the custom test case (-r 0)\n");
+		return -1;
+	}
+
+	if (opts->has_mem_load && !(opts->run.load & HRPN_LATENCY_LOAD_MEM)) {
+		printf("Memory load (-M) requires the memory interference load (-l 0x80)\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void latency_report_string(struct latency_campaign *c, const char *str)
+{
+	fputc('"', c->file);
+
+	for (; *str; str++) {
+		if ((*str == '"') || (c->json && (*str == '\\')))
+			fputc(c->json ? '\\' : '"', c->file);
+
+		fputc(*str, c->file);
+	}
+
+	fputc('"', c->file);
+}
+
+static void latency_report_write(struct latency_campaign *c, const char *args,
+		struct hrpn_cmd_latency_run *run, struct latency_stats *stats)
+{
+	struct hrpn_resp_latency_stats *st;
+	unsigned int mem_footprint = 0;
+	unsigned int i;
+
+	if (!c->file)
+		return;
+
+	if ((run->id == HRPN_LATENCY_TEST_CASE_CUSTOM) && (run->load & HRPN_LATENCY_LOAD_MEM))
+		mem_footprint = run->mem_size ? run->mem_size : LATENCY_MEM_SIZE_DEFAULT;
+
+	for (i = 0; i < stats->count; i++) {
+		st = &stats->entry[i].stats;
+
+		if (c->json) {
+			fprintf(c->file, "%s\n  {\"run\": %u, \"args\": ", c->records ? "," : "", c->runs);
+			latency_report_string(c, args);
+			fprintf(c->file, ", \"test_case\": %u, \"period_us\": %u, \"mem_footprint\": %u, \"duration_s\": %u, "
+				"\"core\": %u, \"metric\": \"%s\", \"count\": %llu, \"min_ns\": %u, \"avg_ns\": %u, \"max_ns\": %u, "
+				"\"p50_ns\": %u, \"p99_ns\": %u, \"p99_9_ns\": %u, \"p99_99_ns\": %u, \"p99_999_ns\": %u, "
+				"\"p99_9999_ns\": %u, \"late_alarm_sched\": %u}",
+				run->id, run->period_us ? run->period_us : LATENCY_PERIOD_US_DEFAULT, mem_footprint, run->duration_s,
+				st->core, latency_metric_name[st->metric], (unsigned long long)st->count,
+				st->min, st->mean, st->max, st->p50, st->p99, st->p99_9, st->p99_99,
+				st->p99_999, st->p99_9999, st->late_alarm_sched);
+		} else {
+			fprintf(c->file, "%u,", c->runs);
+			latency_report_string(c, args);
+			fprintf(c->file, ",%u,%u,%u,%u,%u,%s,%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+				run->id, run->period_us ? run->period_us : LATENCY_PERIOD_US_DEFAULT, mem_footprint, run->duration_s,
+				st->core, latency_metric_name[st->metric], (unsigned long long)st->count,
+				st->min, st->mean, st->max, st->p50, st->p99, st->p99_9, st->p99_99,
+				st->p99_999, st->p99_9999, st->late_alarm_sched);
+		}
+
+		c->records++;
+	}
+
+	fflush(c->file);
+}
+
+/* One campaign run, @argv holding the run options (argv[0] unused, like getopt) */
+static int latency_campaign_run(struct latency_campaign *c, int argc, char *argv[])
+{
+	struct latency_opts opts = {0,};
+	struct latency_stats stats = {0,};
+	char args[LATENCY_CAMPAIGN_LINE_MAX];
+	unsigned int len = 0;
+	int option, i;
+	int rc = -1;
+
+	for (i = 1; i < argc; i++)
+		len += snprintf(args + len, len < sizeof(args) ? sizeof(args) - len : 0, "%s%s",
+				i > 1 ? " " : "", argv[i]);
+
+	c->runs++;
+	printf("campaign run %u: %s\n", c->runs, args);
+
+	opts.run.mode = HRPN_LATENCY_MODE_RELATIVE;
+
+	/* full getopt reinitialization, for each run */
+	optind = 0;
+	while ((option = getopt(argc, argv, LATENCY_CAMPAIGN_OPTIONS)) != -1) {
+		if (latency_run_option(&opts, option, optarg))
+			goto err;
+	}
+
+	if ((optind < argc) || !opts.is_run_cmd || (latency_run_check(&opts) < 0)) {
+		printf("Invalid campaign run (a test case and run options are required)\n");
+		goto err;
+	}
+
+	if (!opts.run.duration_s)
+		opts.run.duration_s = c->duration_s;
+
+	opts.run.stats_report = true;
+
+	if (opts.load_profile && (linux_load_start(opts.load_profile) < 0))
+		goto err;
+
+	rc = latency_run(c->fd, &opts.run);
+	if (!rc)
+		rc = latency_wait(c->fd, NULL, &stats);
+
+	if (opts.load_profile)
+		linux_load_stop();
+
+	if (rc < 0)
+		goto err;
+
+	if (!stats.count)
+		printf("no statistics received\n");
+
+	latency_report_write(c, args, &opts.run, &stats);
+
+	if (c->baseline_save && (latency_baseline_save(&c->baseline, args, &stats) < 0))
+		goto err;
+
+	if (c->baseline_compare)
+		latency_baseline_compare(&c->baseline, args, &stats);
+
+	return 0;
+
+err:
+	c->failed++;
+	return -1;
+}
+
+/*
+ * Run options with a comma separated list of values (test case, period, load
+ * mask and memory load) are swept: one run per combination of values.
+ */
+static void latency_campaign_expand(struct latency_campaign *c, int argc, char *argv[], int from)
+{
+	char *orig, *list, *value, *saveptr;
+	int i;
+
+	for (i = from; i < argc - 1; i++) {
+		if ((!strcmp(argv[i], "-r") || !strcmp(argv[i], "-p") || !strcmp(argv[i], "-l") ||
+		     !strcmp(argv[i], "-M")) &&
+		    strchr(argv[i + 1], ','))
+			break;
+	}
+
+	if (i >= argc - 1) {
+		latency_campaign_run(c, argc, argv);
+		return;
+	}
+
+	orig = argv[i + 1];
+
+	list = strdup(orig);
+	if (!list) {
+		printf("campaign: allocation failed\n");
+		c->failed++;
+		return;
+	}
+
+	for (value = strtok_r(list, ",", &saveptr); value && !latency_stop_request;
+	     value = strtok_r(NULL, ",", &saveptr)) {
+		argv[i + 1] = value;
+		latency_campaign_expand(c, argc, argv, i + 2);
+	}
+
+	argv[i + 1] = orig;
+	free(list);
+}
+
+/*
+ * Campaign: runs the test cases of a spec file one after the other, each for
+ * a given duration, and writes their end of run statistics (received from
+ * the RTOS over RPMsg) to a CSV or JSON (.json file extension) report. The
+ * run histograms can be saved as a named baseline, or compared to one.
+ *
+ * Spec file: one run per line, with the run options of the command line
+ * (-r is required), empty lines and lines starting with '#' are ignored.
+ */
+static int latency_campaign(int fd, const char *spec, const char *report, unsigned int duration_s,
+		const char *baseline_save, const char *baseline)
+{
+	struct latency_campaign c = {0,};
+	char *argv[LATENCY_CAMPAIGN_ARGS_MAX + 1];
+	char line[LATENCY_CAMPAIGN_LINE_MAX];
+	unsigned int line_nb = 0;
+	const char *ext;
+	FILE *file;
+	char *tok, *saveptr;
+	int argc;
+	int rc = -1;
+
+	c.fd = fd;
+	c.duration_s = duration_s ? duration_s : LATENCY_CAMPAIGN_DURATION_S;
+
+	file = fopen(spec, "r");
+	if (!file) {
+		printf("failed to open %s: %s\n", spec, strerror(errno));
+		goto err;
+	}
+
+	if (baseline_save) {
+		c.baseline_save = true;
+		if (latency_baseline_save_open(&c.baseline, baseline_save) < 0)
+			goto err_baseline;
+	} else if (baseline) {
+		c.baseline_compare = true;
+		if (latency_baseline_load(&c.baseline, baseline) < 0)
+			goto err_baseline;
+	}
+
+	if (report) {
+		c.file = fopen(report, "w");
+		if (!c.file) {
+			printf("failed to open %s: %s\n", report, strerror(errno));
+			goto err_report;
+		}
+
+		ext = strrchr(report, '.');
+		c.json = ext && !strcmp(ext, ".json");
+
+		if (c.json)
+			fprintf(c.file, "[");
+		else
+			fprintf(c.file, "run,args,test_case,period_us,mem_footprint,duration_s,core,metric,count,min_ns,avg_ns,max_ns,"
+				"p50_ns,p99_ns,p99_9_ns,p99_99_ns,p99_999_ns,p99_9999_ns,late_alarm_sched\n");
+	}
+
+	while (!latency_stop_request && fgets(line, sizeof(line), file)) {
+		line_nb++;
+
+		argv[0] = "campaign";
+		argc = 1;
+
+		for (tok = strtok_r(line, " \t\r\n", &saveptr); tok; tok = strtok_r(NULL, " \t\r\n", &saveptr)) {
+			if (argc == LATENCY_CAMPAIGN_ARGS_MAX) {
+				printf("%s:%u: too many arguments\n", spec, line_nb);
+				break;
+			}
+
+			argv[argc++] = tok;
+		}
+
+		if ((argc == 1) || (argv[1][0] == '#'))
+			continue;
+
+		if (tok) {
+			c.failed++;
+			continue;
+		}
+
+		argv[argc] = NULL;
+
+		latency_campaign_expand(&c, argc, argv, 1);
+	}
+
+	printf("campaign %s: %u runs, %u failed\n",
+	       latency_stop_request ? "interrupted" : "completed", c.runs, c.failed);
+
+	rc = (c.failed || latency_stop_request) ? -1 : 0;
+
+	if (c.file) {
+		if (c.json)
+			fprintf(c.file, "\n]\n");
+
+		if (fclose(c.file))
+			perror("fclose()");
+
+		printf("%u records written to %s\n", c.records, report);
+	}
+
+	/* a regression fails the campaign, to gate system updates */
+	if (c.baseline_compare && (latency_baseline_compare_done(&c.baseline) < 0))
+		rc = -1;
+
+err_report:
+	/* an incomplete campaign does not replace the baseline */
+	if (c.baseline_save && (latency_baseline_save_close(&c.baseline, !rc) < 0))
+		rc = -1;
+
+err_baseline:
+	latency_baseline_free(&c.baseline);
+	fclose(file);
+
+err:
+	return rc;
+}
+
+int latency_main(int argc, char *argv[], int fd)
+{
+	struct latency_opts opts = {0,};
+	int option, err;
+	int rc = 0;
+	const char *campaign_spec = NULL;
+	const char *report_path = NULL;
+	const char *baseline_save = NULL;
+	const char *baseline = NULL;
+	const char *soak_path = NULL;
+	unsigned int ipc_count = 0;
+
+	opts.run.mode = HRPN_LATENCY_MODE_RELATIVE;
+
+	while ((option = getopt_long(argc, argv, "r:qPKWR:T:L:l:p:i:I:S:M:b:d:c:C:w:m:o:sv",
+				     latency_long_options, NULL)) != -1) {
+		/* test case run options */
+		err = latency_run_option(&opts, option, optarg);
+		if (err < 0) {
+			rc = -1;
+			goto out;
+		} else if (!err) {
+			continue;
+		}
+
+		/* common options */
+		switch (option) {
+		case 'm':
+			if ((strtoul_check(optarg, NULL, 0, &ipc_count) < 0) || !ipc_count) {
+				printf("Invalid ping count\n");
+				rc = -1;
+				goto out;
+			}
+
+			break;
+
+		case LATENCY_OPT_CAMPAIGN:
+			campaign_spec = optarg;
+			break;
+
+		case LATENCY_OPT_BASELINE_SAVE:
+			baseline_save = optarg;
+			break;
+
+		case LATENCY_OPT_BASELINE:
+			baseline = optarg;
+			break;
+
+		case LATENCY_OPT_SOAK_READ:
+			soak_path = optarg;
+			break;
+
+		case 'o':
+			report_path = optarg;
+			break;
+
+		case 's':
+			rc = latency_stop(fd);
+			break;
+
+		default:
+			common_main(option, optarg);
+			break;
+		}
+	}
+
+	if ((baseline_save || baseline) && !campaign_spec) {
+		printf("Baselines are saved and compared by campaigns (--campaign)\n");
+		rc = -1;
+		goto out;
+	}
+
+	if (campaign_spec) {
+		if (opts.is_run_cmd || !(report_path || baseline_save || baseline) || (baseline_save && baseline)) {
+			printf("A campaign requires a report file (-o) and/or a baseline to save or compare to\n"
+			       "(one of --baseline-save and --baseline), and no test case (-r)\n");
+			rc = -1;
+			goto out;
+		}
+
+		rc = latency_campaign(fd, campaign_spec, report_path, opts.run.duration_s, baseline_save, baseline);
+		goto out;
+	}
+
+	if (latency_run_check(&opts) < 0) {
+		rc = -1;
+		goto out;
+	}
+
+	if (opts.is_run_cmd) {
+		opts.run.capture = opts.capture_path != NULL;
+
+		/* the load runs for the whole test case, started first */
+		if (opts.load_profile && (linux_load_start(opts.load_profile) < 0)) {
+			rc = -1;
+			goto out;
+		}
+
+		rc = latency_run(fd, &opts.run);
+		if (!rc && (opts.capture_path || opts.load_profile || opts.run.trace_threshold_us))
+			rc = latency_wait(fd, opts.capture_path, NULL);
+
+		if (opts.load_profile)
+			linux_load_stop();
+	}
+
+	if (!rc && soak_path)
+		rc = latency_soak_read(fd, soak_path);
+
+	if (!rc && ipc_count)
+		rc = latency_ipc(fd, ipc_count);
+
+out:
+	return rc;
+}
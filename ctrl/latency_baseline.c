@@ -0,0 +1,430 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/stat.h>
+
+#include "latency_baseline.h"
+
+#define LATENCY_BASELINE_DIR		"/var/lib/harpoon/baselines"
+#define LATENCY_BASELINE_MAGIC		"harpoon-latency-baseline"
+#define LATENCY_BASELINE_VERSION	1
+#define LATENCY_BASELINE_MODEL		"/proc/device-tree/model"
+
+/*
+ * Tail comparison: for each tail percentile of the baseline, the share of
+ * samples above its value (exceedances) in the new run is compared to the
+ * baseline one with a one-sided two-proportion z-test. A tail regresses if
+ * the increase is significant (p < 0.001) and above the margin, so that
+ * negligible differences over large sample counts are not reported.
+ * Percentiles with too few expected exceedances to be tested are skipped.
+ */
+#define LATENCY_BASELINE_Z_CRIT		3.09
+#define LATENCY_BASELINE_MARGIN		0.25	/* exceedance rate increase tolerated */
+#define LATENCY_BASELINE_EXCEED_MIN	10.0	/* expected exceedances, in both runs */
+
+static const struct {
+	const char *name;
+	uint32_t ppm;
+} latency_baseline_tail[] = {
+	{ "p99", HDR_HIST_PPM_P99 },
+	{ "p99.9", HDR_HIST_PPM_P99_9 },
+	{ "p99.99", HDR_HIST_PPM_P99_99 },
+	{ "p99.999", HDR_HIST_PPM_P99_999 },
+};
+
+/* Histogram of a run of the baseline being compared to */
+struct latency_baseline_hist {
+	struct latency_baseline_hist *next;
+	char *args;
+	uint32_t core;
+	uint32_t metric;
+	struct hdr_hist hist;
+};
+
+static void latency_baseline_board(char *board, size_t size)
+{
+	FILE *file;
+	size_t len = 0;
+
+	file = fopen(LATENCY_BASELINE_MODEL, "r");
+	if (file) {
+		len = fread(board, 1, size - 1, file);
+		fclose(file);
+	}
+
+	board[len] = '\0';
+
+	/* device tree strings are null terminated, keep a single line */
+	board[strcspn(board, "\n")] = '\0';
+	if (!board[0])
+		strcpy(board, "unknown");
+}
+
+/* A name with a '/' is a path, other names are stored in the baselines directory */
+static char *latency_baseline_path(const char *name, bool create_dir)
+{
+	char *path;
+
+	if (strchr(name, '/'))
+		return strdup(name);
+
+	if (create_dir) {
+		mkdir("/var/lib/harpoon", 0755);
+		mkdir(LATENCY_BASELINE_DIR, 0755);
+	}
+
+	if (asprintf(&path, "%s/%s.baseline", LATENCY_BASELINE_DIR, name) < 0)
+		return NULL;
+
+	return path;
+}
+
+/* Saved to a temporary file, only replacing the previous baseline once the campaign succeeded */
+int latency_baseline_save_open(struct latency_baseline *b, const char *name)
+{
+	b->path = latency_baseline_path(name, true);
+	if (!b->path || (asprintf(&b->tmp_path, "%s.tmp", b->path) < 0)) {
+		printf("baseline: allocation failed\n");
+		b->tmp_path = NULL;
+		return -1;
+	}
+
+	b->file = fopen(b->tmp_path, "w");
+	if (!b->file) {
+		printf("failed to open %s: %s\n", b->tmp_path, strerror(errno));
+		return -1;
+	}
+
+	latency_baseline_board(b->board, sizeof(b->board));
+
+	fprintf(b->file, "%s %d\nboard %s\n", LATENCY_BASELINE_MAGIC, LATENCY_BASELINE_VERSION, b->board);
+
+	return 0;
+}
+
+/*
+ * File layout, one run line followed by one line per histogram:
+ *   run <run options>
+ *   hist <core> <metric> <sub_bits> <min> <max> <non-empty buckets> <index>:<count>...
+ */
+int latency_baseline_save(struct latency_baseline *b, const char *args, struct latency_stats *stats)
+{
+	struct latency_stats_entry *e;
+	unsigned int i, j, buckets;
+
+	fprintf(b->file, "run %s\n", args);
+
+	for (i = 0; i < stats->count; i++) {
+		e = &stats->entry[i];
+
+		if (!e->hist_valid) {
+			printf("baseline: core %u %s histogram incomplete, not saved\n",
+			       e->stats.core, latency_metric_name[e->stats.metric]);
+			continue;
+		}
+
+		buckets = 0;
+		for (j = 0; j < HDR_HIST_BUCKETS(e->hist.sub_bits); j++)
+			if (e->hist.count[j])
+				buckets++;
+
+		fprintf(b->file, "hist %u %u %u %u %u %u", e->stats.core, e->stats.metric,
+			e->hist.sub_bits, e->hist.min, e->hist.max, buckets);
+
+		for (j = 0; j < HDR_HIST_BUCKETS(e->hist.sub_bits); j++)
+			if (e->hist.count[j])
+				fprintf(b->file, " %u:%u", j, e->hist.count[j]);
+
+		fprintf(b->file, "\n");
+	}
+
+	if (ferror(b->file)) {
+		printf("baseline: write error\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int latency_baseline_save_close(struct latency_baseline *b, bool commit)
+{
+	int rc = 0;
+
+	if (!b->file)
+		return -1;
+
+	if (fclose(b->file)) {
+		perror("fclose()");
+		commit = false;
+		rc = -1;
+	}
+
+	b->file = NULL;
+
+	if (commit) {
+		if (rename(b->tmp_path, b->path) < 0) {
+			printf("failed to rename %s: %s\n", b->tmp_path, strerror(errno));
+			rc = -1;
+		} else {
+			printf("baseline saved to %s (board: %s)\n", b->path, b->board);
+		}
+	} else {
+		unlink(b->tmp_path);
+		printf("baseline not saved\n");
+	}
+
+	return rc;
+}
+
+static int latency_baseline_hist_parse(struct latency_baseline_hist *bh, char *line)
+{
+	unsigned int sub_bits, min, max, buckets, index, count, i;
+	char *tok, *saveptr;
+	int n;
+
+	if (sscanf(line, "hist %u %u %u %u %u %u%n", &bh->core, &bh->metric, &sub_bits,
+		   &min, &max, &buckets, &n) != 6)
+		return -1;
+
+	if ((bh->metric >= HRPN_LATENCY_METRIC_MAX) || (hdr_hist_init(&bh->hist, NULL, sub_bits) < 0))
+		return -1;
+
+	for (i = 0, tok = strtok_r(line + n, " \n", &saveptr); tok; i++, tok = strtok_r(NULL, " \n", &saveptr)) {
+		if ((sscanf(tok, "%u:%u", &index, &count) != 2) || (index >= HDR_HIST_BUCKETS(sub_bits)))
+			return -1;
+
+		bh->hist.count[index] = count;
+		bh->hist.total += count;
+	}
+
+	if (i != buckets)
+		return -1;
+
+	bh->hist.min = min;
+	bh->hist.max = max;
+
+	return 0;
+}
+
+int latency_baseline_load(struct latency_baseline *b, const char *name)
+{
+	struct latency_baseline_hist *bh, **tail = &b->hists;
+	char board[sizeof(b->board)];
+	char *line = NULL, *args = NULL;
+	unsigned int line_nb = 0;
+	size_t size = 0;
+	int version;
+	FILE *file;
+	int rc = -1;
+
+	b->path = latency_baseline_path(name, false);
+	if (!b->path) {
+		printf("baseline: allocation failed\n");
+		return -1;
+	}
+
+	file = fopen(b->path, "r");
+	if (!file) {
+		printf("failed to open %s: %s\n", b->path, strerror(errno));
+		return -1;
+	}
+
+	while (getline(&line, &size, file) > 0) {
+		line_nb++;
+
+		if (line_nb == 1) {
+			if ((sscanf(line, LATENCY_BASELINE_MAGIC " %d", &version) != 1) ||
+			    (version != LATENCY_BASELINE_VERSION))
+				goto err_parse;
+		} else if (!strncmp(line, "board ", 6)) {
+			strncpy(b->board, line + 6, sizeof(b->board) - 1);
+			b->board[strcspn(b->board, "\n")] = '\0';
+		} else if (!strncmp(line, "run ", 4)) {
+			free(args);
+			args = strdup(line + 4);
+			if (!args)
+				goto err_parse;
+
+			args[strcspn(args, "\n")] = '\0';
+		} else if (!strncmp(line, "hist ", 5)) {
+			bh = calloc(1, sizeof(*bh));
+			if (!bh)
+				goto err_parse;
+
+			*tail = bh;
+			tail = &bh->next;
+
+			if (!args || (latency_baseline_hist_parse(bh, line) < 0))
+				goto err_parse;
+
+			bh->args = strdup(args);
+			if (!bh->args)
+				goto err_parse;
+		} else {
+			goto err_parse;
+		}
+	}
+
+	latency_baseline_board(board, sizeof(board));
+	if (strcmp(board, b->board)) {
+		printf("baseline %s recorded on another board (%s)\n", b->path, b->board);
+		goto err;
+	}
+
+	printf("comparing to baseline %s (board: %s)\n", b->path, b->board);
+	rc = 0;
+	goto out;
+
+err_parse:
+	printf("%s:%u: invalid baseline\n", b->path, line_nb);
+err:
+	latency_baseline_free(b);
+out:
+	free(args);
+	free(line);
+	fclose(file);
+
+	return rc;
+}
+
+/* Samples in the buckets above the one of @value */
+static uint64_t latency_baseline_above(const struct hdr_hist *h, uint32_t value)
+{
+	unsigned int i = hdr_hist_index(h, value) + 1;
+	uint64_t count = 0;
+
+	for (; i < HDR_HIST_BUCKETS(h->sub_bits); i++)
+		count += h->count[i];
+
+	return count;
+}
+
+/*
+ * Returns the number of tail percentiles that regressed, -1 if none could be
+ * compared
+ */
+static int latency_baseline_tail_compare(const struct hdr_hist *base, const struct hdr_hist *h)
+{
+	uint64_t k1, k2, n1 = base->total, n2 = h->total;
+	double p1, p2, p, se, z, rate;
+	unsigned int i, compared = 0;
+	int regressions = 0;
+	uint32_t value;
+	bool regression;
+
+	for (i = 0; i < sizeof(latency_baseline_tail) / sizeof(latency_baseline_tail[0]); i++) {
+		rate = (1000000 - latency_baseline_tail[i].ppm) / 1000000.;
+
+		if ((n1 * rate < LATENCY_BASELINE_EXCEED_MIN) || (n2 * rate < LATENCY_BASELINE_EXCEED_MIN)) {
+			printf("    %-8s not compared: not enough samples above it (%llu and %llu samples)\n",
+			       latency_baseline_tail[i].name, (unsigned long long)n1, (unsigned long long)n2);
+			continue;
+		}
+
+		value = hdr_hist_value_at_ppm(base, latency_baseline_tail[i].ppm);
+		k1 = latency_baseline_above(base, value);
+		k2 = latency_baseline_above(h, value);
+
+		p1 = (double)k1 / n1;
+		p2 = (double)k2 / n2;
+		p = (double)(k1 + k2) / (n1 + n2);
+		se = sqrt(p * (1 - p) * (1. / n1 + 1. / n2));
+		z = se > 0 ? (p2 - p1) / se : 0;
+
+		regression = (z > LATENCY_BASELINE_Z_CRIT) && (p2 > p1 * (1 + LATENCY_BASELINE_MARGIN));
+		if (regression)
+			regressions++;
+
+		printf("    %-8s %8u ns: above %.4f%% -> %.4f%% (z %.2f, new %s %u ns)%s\n",
+		       latency_baseline_tail[i].name, value, p1 * 100, p2 * 100, z,
+		       latency_baseline_tail[i].name, hdr_hist_value_at_ppm(h, latency_baseline_tail[i].ppm),
+		       regression ? " REGRESSION" : "");
+
+		compared++;
+	}
+
+	printf("    max %u ns -> %u ns\n", base->max, h->max);
+
+	return compared ? regressions : -1;
+}
+
+void latency_baseline_compare(struct latency_baseline *b, const char *args, struct latency_stats *stats)
+{
+	struct latency_stats_entry *e;
+	struct latency_baseline_hist *bh;
+	unsigned int i;
+	int regressions;
+
+	for (i = 0; i < stats->count; i++) {
+		e = &stats->entry[i];
+
+		for (bh = b->hists; bh; bh = bh->next)
+			if (!strcmp(bh->args, args) && (bh->core == e->stats.core) &&
+			    (bh->metric == e->stats.metric))
+				break;
+
+		printf("  core %u %s:\n", e->stats.core, latency_metric_name[e->stats.metric]);
+
+		if (!bh || !e->hist_valid || (bh->hist.sub_bits != e->hist.sub_bits)) {
+			printf("    %s\n", !bh ? "not in the baseline" :
+			       !e->hist_valid ? "histogram incomplete" : "histogram resolution differs from the baseline");
+			b->missing++;
+			continue;
+		}
+
+		regressions = latency_baseline_tail_compare(&bh->hist, &e->hist);
+		if (regressions < 0) {
+			b->missing++;
+			continue;
+		}
+
+		if (regressions)
+			b->regressions++;
+
+		b->compared++;
+	}
+}
+
+/*
+ * Returns -1 if any metric regressed or could not be compared: a campaign
+ * that does not cover its baseline does not pass
+ */
+int latency_baseline_compare_done(struct latency_baseline *b)
+{
+	printf("baseline comparison: %u metrics compared, %u regressed, %u not compared\n",
+	       b->compared, b->regressions, b->missing);
+
+	if (!b->compared)
+		printf("baseline comparison failed: no metric compared\n");
+	else if (b->missing)
+		printf("baseline comparison failed: %u metrics not compared\n", b->missing);
+
+	return (b->regressions || b->missing || !b->compared) ? -1 : 0;
+}
+
+void latency_baseline_free(struct latency_baseline *b)
+{
+	struct latency_baseline_hist *bh;
+
+	while (b->hists) {
+		bh = b->hists;
+		b->hists = bh->next;
+		free(bh->args);
+		free(bh);
+	}
+
+	free(b->path);
+	free(b->tmp_path);
+	b->path = NULL;
+	b->tmp_path = NULL;
+}
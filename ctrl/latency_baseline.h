@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _LATENCY_BASELINE_H_
+#define _LATENCY_BASELINE_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "hdr_hist.h"
+#include "hrpn_ctrl.h"
+
+#define LATENCY_STATS_CORES_MAX		8
+
+/* End of run statistics of a benchmark core metric, and its histogram */
+struct latency_stats_entry {
+	struct hrpn_resp_latency_stats stats;
+	struct hdr_hist hist;
+	uint32_t hist_received;	/* non-empty buckets received */
+	bool hist_valid;	/* histogram complete */
+};
+
+/* End of run statistics of a test case, received from the RTOS */
+struct latency_stats {
+	unsigned int count;
+	struct latency_stats_entry entry[LATENCY_STATS_CORES_MAX * HRPN_LATENCY_METRIC_MAX];
+};
+
+struct latency_baseline_hist;
+
+/*
+ * Latency regression baseline: the histograms of the runs of a campaign,
+ * saved under a name for the current board, then compared to the ones of a
+ * later campaign with the same runs.
+ */
+struct latency_baseline {
+	FILE *file;		/* baseline being saved */
+	char *path;
+	char *tmp_path;
+	char board[128];
+	struct latency_baseline_hist *hists;	/* baseline being compared to */
+	unsigned int compared;
+	unsigned int missing;
+	unsigned int regressions;
+};
+
+extern const char *latency_metric_name[HRPN_LATENCY_METRIC_MAX];
+
+int latency_baseline_save_open(struct latency_baseline *b, const char *name);
+int latency_baseline_save(struct latency_baseline *b, const char *args, struct latency_stats *stats);
+int latency_baseline_save_close(struct latency_baseline *b, bool commit);
+int latency_baseline_load(struct latency_baseline *b, const char *name);
+void latency_baseline_compare(struct latency_baseline *b, const char *args, struct latency_stats *stats);
+int latency_baseline_compare_done(struct latency_baseline *b);
+void latency_baseline_free(struct latency_baseline *b);
+
+#endif /* _LATENCY_BASELINE_H_ */
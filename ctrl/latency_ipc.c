@@ -0,0 +1,209 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hdr_hist.h"
+#include "hrpn_ctrl.h"
+#include "rpmsg.h"
+#include "common.h"
+#include "latency_ipc.h"
+
+#define LATENCY_IPC_TIMEOUT_MS		1000
+
+/* The control task polls its endpoint every 100 ms */
+#define LATENCY_IPC_CTRL_COUNT_MAX	50
+
+/*
+ * One-way delays are differences of ARM generic timer counts taken on both
+ * sides: the counter is shared by all cores, and the virtual offset is 0 for
+ * Linux and the RTOS.
+ */
+enum {
+	LATENCY_IPC_DOORBELL,		/* Linux send to RTOS mailbox interrupt */
+	LATENCY_IPC_TO_RTOS,		/* Linux send to RTOS task reception */
+	LATENCY_IPC_TO_LINUX,		/* RTOS task send to Linux reception */
+	LATENCY_IPC_ROUND_TRIP,
+	LATENCY_IPC_HIST_MAX,
+};
+
+static const char *latency_ipc_hist_name[LATENCY_IPC_HIST_MAX] = {
+	[LATENCY_IPC_DOORBELL] = "Linux -> RTOS doorbell",
+	[LATENCY_IPC_TO_RTOS] = "Linux -> RTOS task",
+	[LATENCY_IPC_TO_LINUX] = "RTOS task -> Linux",
+	[LATENCY_IPC_ROUND_TRIP] = "round trip",
+};
+
+static const unsigned int latency_ipc_payload_sizes[] = { 16, 64, 128, 256 };
+
+static struct hdr_hist latency_ipc_hist[LATENCY_IPC_HIST_MAX];
+
+static inline uint64_t latency_ipc_timestamp(void)
+{
+	uint64_t cnt = 0;
+
+#if defined(__aarch64__)
+	__asm volatile ("isb; mrs %0, cntvct_el0" : "=r" (cnt) : : "memory");
+#endif
+
+	return cnt;
+}
+
+/* Timestamp frequency (Hz), 0 if not supported */
+static uint64_t latency_ipc_frequency(void)
+{
+	uint64_t freq = 0;
+
+#if defined(__aarch64__)
+	__asm volatile ("mrs %0, cntfrq_el0" : "=r" (freq));
+#endif
+
+	return freq;
+}
+
+static void latency_ipc_update(struct hdr_hist *h, uint64_t start, uint64_t end, uint64_t freq)
+{
+	if (end < start)
+		return;
+
+	hdr_hist_update(h, ((end - start) * 1000000000ULL) / freq);
+}
+
+/* Send a ping and wait for its pong, stale pongs (from timed out pings) are dropped */
+static int latency_ipc_ping(int fd, struct hrpn_cmd_latency_ping *ping,
+		struct hrpn_resp_latency_pong *pong, uint64_t *ts_recv)
+{
+	unsigned int len;
+
+	ping->ts_send = latency_ipc_timestamp();
+
+	if (rpmsg_send(fd, ping, offsetof(struct hrpn_cmd_latency_ping, payload) + ping->len) < 0) {
+		printf("ping send error\n");
+		return -1;
+	}
+
+	do {
+		len = sizeof(*pong);
+		if (rpmsg_recv(fd, pong, &len, LATENCY_IPC_TIMEOUT_MS) < 0) {
+			printf("ping %u timeout\n", ping->seq);
+			return -1;
+		}
+
+		*ts_recv = latency_ipc_timestamp();
+
+		if ((len < offsetof(struct hrpn_resp_latency_pong, payload)) ||
+		    (pong->type != HRPN_RESP_TYPE_LATENCY_PONG) ||
+		    (pong->status != HRPN_RESP_STATUS_SUCCESS)) {
+			printf("invalid pong (len: %u)\n", len);
+			return -1;
+		}
+	} while (pong->seq != ping->seq);
+
+	if ((pong->len != ping->len) ||
+	    (len != offsetof(struct hrpn_resp_latency_pong, payload) + pong->len) ||
+	    memcmp(pong->payload, ping->payload, ping->len)) {
+		printf("pong %u payload mismatch\n", pong->seq);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void latency_ipc_print(const char *path, unsigned int size)
+{
+	struct hdr_hist *h;
+	int i;
+
+	printf("%s, %u bytes payload:\n", path, size);
+
+	for (i = 0; i < LATENCY_IPC_HIST_MAX; i++) {
+		h = &latency_ipc_hist[i];
+
+		if (!h->total) {
+			printf("  %-24s: n/a\n", h->name);
+			continue;
+		}
+
+		printf("  %-24s: min %u p50 %u p99 %u p99.9 %u max %u ns (%llu samples)\n", h->name,
+		       h->min, hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P50),
+		       hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99),
+		       hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_9),
+		       h->max, (unsigned long long)h->total);
+	}
+}
+
+static int latency_ipc_run(int fd, const char *path, unsigned int count, uint64_t freq)
+{
+	struct hrpn_cmd_latency_ping ping;
+	struct hrpn_resp_latency_pong pong;
+	uint64_t ts_recv;
+	unsigned int i, n, seq = 0;
+	int rc = 0;
+
+	ping.type = HRPN_CMD_TYPE_LATENCY_PING;
+
+	for (i = 0; i < sizeof(latency_ipc_payload_sizes) / sizeof(latency_ipc_payload_sizes[0]); i++) {
+		ping.len = latency_ipc_payload_sizes[i];
+		memset(ping.payload, i + 1, ping.len);
+
+		for (n = 0; n < LATENCY_IPC_HIST_MAX; n++)
+			hdr_hist_reset(&latency_ipc_hist[n]);
+
+		for (n = 0; n < count; n++) {
+			ping.seq = ++seq;
+
+			rc = latency_ipc_ping(fd, &ping, &pong, &ts_recv);
+			if (rc < 0)
+				goto out;
+
+			/* the mailbox timestamp is the latest one, it may predate this ping */
+			if ((pong.ts_mbox >= ping.ts_send) && (pong.ts_mbox <= pong.ts_recv))
+				latency_ipc_update(&latency_ipc_hist[LATENCY_IPC_DOORBELL], ping.ts_send, pong.ts_mbox, freq);
+
+			latency_ipc_update(&latency_ipc_hist[LATENCY_IPC_TO_RTOS], ping.ts_send, pong.ts_recv, freq);
+			latency_ipc_update(&latency_ipc_hist[LATENCY_IPC_TO_LINUX], pong.ts_send, ts_recv, freq);
+			latency_ipc_update(&latency_ipc_hist[LATENCY_IPC_ROUND_TRIP], ping.ts_send, ts_recv, freq);
+		}
+
+		latency_ipc_print(path, ping.len);
+	}
+
+out:
+	return rc;
+}
+
+int latency_ipc(int fd, unsigned int count)
+{
+	uint64_t freq = latency_ipc_frequency();
+	int ipc_fd;
+	int i, rc;
+
+	if (!freq) {
+		printf("IPC benchmark requires the ARM generic timer\n");
+		return -1;
+	}
+
+	for (i = 0; i < LATENCY_IPC_HIST_MAX; i++)
+		hdr_hist_init(&latency_ipc_hist[i], latency_ipc_hist_name[i], HDR_HIST_SUB_BITS);
+
+	ipc_fd = rpmsg_init(HRPN_LATENCY_IPC_EPT);
+	if (ipc_fd < 0)
+		return -1;
+
+	rc = latency_ipc_run(ipc_fd, "rpmsg path", count, freq);
+
+	rpmsg_deinit(ipc_fd);
+
+	if (rc < 0)
+		return rc;
+
+	if (count > LATENCY_IPC_CTRL_COUNT_MAX)
+		count = LATENCY_IPC_CTRL_COUNT_MAX;
+
+	return latency_ipc_run(fd, "control path", count, freq);
+}
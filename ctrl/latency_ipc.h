@@ -0,0 +1,17 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _LATENCY_IPC_H_
+#define _LATENCY_IPC_H_
+
+/*
+ * Linux <-> RTOS IPC round trip benchmark: pings of increasing payload size
+ * echoed by the rt_latency application, first on the IPC endpoint (raw
+ * rpmsg path, answered by a dedicated RTOS task), then on the control
+ * endpoint @fd (control path, answered by the polling control task).
+ */
+int latency_ipc(int fd, unsigned int count);
+
+#endif /* _LATENCY_IPC_H_ */
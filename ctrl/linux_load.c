@@ -0,0 +1,383 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "common.h"
+#include "linux_load.h"
+
+#define LINUX_LOAD_THREADS_MAX		64
+#define LINUX_LOAD_SLOT_NS		10000000ULL	/* duty cycle period: 10 ms */
+
+#define LINUX_LOAD_MEM_SIZE		(64 << 20)	/* well above any L2/L3 cache */
+#define LINUX_LOAD_MEM_CHUNK		(256 << 10)
+#define LINUX_LOAD_CACHE_SIZE_DEFAULT	(512 << 10)
+#define LINUX_LOAD_CACHE_LINE		64
+#define LINUX_LOAD_SYSCALL_BURST	64
+#define LINUX_LOAD_IRQ_SLEEP_NS		10000		/* one hrtimer interrupt per sleep */
+
+#define NSEC_PER_SEC			1000000000ULL
+
+enum {
+	LINUX_LOAD_MEM = 0,	/* DDR bandwidth: streaming copies */
+	LINUX_LOAD_CACHE,	/* L2 thrashing: writes over twice the L2 size */
+	LINUX_LOAD_SYSCALL,	/* syscall storm */
+	LINUX_LOAD_IRQ,		/* timer interrupt storm */
+	LINUX_LOAD_MAX,
+};
+
+static const char *linux_load_name[LINUX_LOAD_MAX] = {
+	[LINUX_LOAD_MEM] = "mem",
+	[LINUX_LOAD_CACHE] = "cache",
+	[LINUX_LOAD_SYSCALL] = "syscall",
+	[LINUX_LOAD_IRQ] = "irq",
+};
+
+struct linux_load_thread {
+	pthread_t thread;
+	unsigned int cpu;
+	unsigned int type;
+	unsigned int intensity;	/* duty cycle (%) */
+	uint8_t *buf;
+	size_t size;
+	size_t offset;
+	unsigned long long ops;
+};
+
+static struct linux_load {
+	volatile bool stop;
+	unsigned int count;
+	struct timespec start;
+	struct linux_load_thread thread[LINUX_LOAD_THREADS_MAX];
+} linux_load;
+
+void linux_load_usage(void)
+{
+	printf(
+		"\t-L <profile>   run a Linux load for the test case duration, profile is a comma separated list of\n"
+		"\t               <cpu|all>=<stressor>[+<stressor>...][@<intensity>], e.g. 1=mem,2=cache+irq@50,3=syscall\n"
+		"\t               mem     - memory bandwidth (streaming copies)\n"
+		"\t               cache   - L2 cache thrashing (shared with the RTOS core)\n"
+		"\t               syscall - syscall storm\n"
+		"\t               irq     - timer interrupt storm\n"
+		"\t               intensity: duty cycle in percent (default 100)\n"
+		"\t               The profile is sent to the RTOS and logged with the test case results\n"
+	);
+}
+
+static uint64_t linux_load_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+static size_t linux_load_l2_size(void)
+{
+	long size = -1;
+	FILE *f;
+
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+	if (size > 0)
+		return size;
+
+	f = fopen("/sys/devices/system/cpu/cpu0/cache/index2/size", "r");
+	if (f) {
+		if (fscanf(f, "%ldK", &size) == 1)
+			size *= 1024;
+		else
+			size = -1;
+
+		fclose(f);
+	}
+
+	return size > 0 ? size : LINUX_LOAD_CACHE_SIZE_DEFAULT;
+}
+
+static void linux_load_op(struct linux_load_thread *t)
+{
+	struct timespec ts;
+	size_t i;
+
+	switch (t->type) {
+	case LINUX_LOAD_MEM:
+		/* copy the first half of the buffer to the second half, chunk by chunk */
+		memcpy(t->buf + t->size / 2 + t->offset, t->buf + t->offset, LINUX_LOAD_MEM_CHUNK);
+		t->offset = (t->offset + LINUX_LOAD_MEM_CHUNK) % (t->size / 2);
+		break;
+
+	case LINUX_LOAD_CACHE:
+		for (i = 0; i < t->size; i += LINUX_LOAD_CACHE_LINE)
+			t->buf[i]++;
+
+		break;
+
+	case LINUX_LOAD_SYSCALL:
+		for (i = 0; i < LINUX_LOAD_SYSCALL_BURST; i++)
+			syscall(SYS_getppid);
+
+		break;
+
+	case LINUX_LOAD_IRQ:
+		ts.tv_sec = 0;
+		ts.tv_nsec = LINUX_LOAD_IRQ_SLEEP_NS;
+		clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+		break;
+
+	default:
+		break;
+	}
+
+	t->ops++;
+}
+
+static void *linux_load_thread(void *arg)
+{
+	struct linux_load_thread *t = arg;
+	uint64_t slot_start, busy_end;
+	struct timespec ts;
+
+	slot_start = linux_load_now();
+
+	while (!linux_load.stop) {
+		busy_end = slot_start + LINUX_LOAD_SLOT_NS * t->intensity / 100;
+
+		do {
+			linux_load_op(t);
+		} while ((linux_load_now() < busy_end) && !linux_load.stop);
+
+		slot_start += LINUX_LOAD_SLOT_NS;
+
+		if (t->intensity < 100) {
+			ts.tv_sec = slot_start / NSEC_PER_SEC;
+			ts.tv_nsec = slot_start % NSEC_PER_SEC;
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+		} else {
+			slot_start = linux_load_now();
+		}
+	}
+
+	return NULL;
+}
+
+static int linux_load_add(unsigned int cpu, unsigned int type, unsigned int intensity)
+{
+	struct linux_load_thread *t;
+
+	if (linux_load.count >= LINUX_LOAD_THREADS_MAX) {
+		printf("too many Linux load threads (max %d)\n", LINUX_LOAD_THREADS_MAX);
+		return -1;
+	}
+
+	t = &linux_load.thread[linux_load.count];
+	memset(t, 0, sizeof(*t));
+	t->cpu = cpu;
+	t->type = type;
+	t->intensity = intensity;
+
+	if (type == LINUX_LOAD_MEM)
+		t->size = LINUX_LOAD_MEM_SIZE;
+	else if (type == LINUX_LOAD_CACHE)
+		t->size = 2 * linux_load_l2_size();
+
+	if (t->size) {
+		t->buf = malloc(t->size);
+		if (!t->buf) {
+			printf("Linux load buffer allocation failed\n");
+			return -1;
+		}
+
+		/* fault all pages in before the test case starts */
+		memset(t->buf, 0x5a, t->size);
+	}
+
+	linux_load.count++;
+
+	return 0;
+}
+
+/* Parse one <cpu|all>=<stressor>[+<stressor>...][@<intensity>] entry */
+static int linux_load_parse_entry(char *entry, cpu_set_t *online)
+{
+	char *cpus, *stressors, *stressor, *intensity_str, *saveptr;
+	unsigned int cpu, type, intensity = 100;
+	cpu_set_t set;
+
+	cpus = entry;
+	stressors = strchr(entry, '=');
+	if (!stressors)
+		goto err;
+
+	*stressors++ = '\0';
+
+	intensity_str = strchr(stressors, '@');
+	if (intensity_str) {
+		*intensity_str++ = '\0';
+
+		if ((strtoul_check(intensity_str, NULL, 0, &intensity) < 0) ||
+		    !intensity || (intensity > 100))
+			goto err;
+	}
+
+	CPU_ZERO(&set);
+	if (!strcmp(cpus, "all")) {
+		set = *online;
+	} else {
+		if ((strtoul_check(cpus, NULL, 0, &cpu) < 0) || (cpu >= CPU_SETSIZE) ||
+		    !CPU_ISSET(cpu, online)) {
+			printf("CPU %s not available to Linux\n", cpus);
+			goto err;
+		}
+
+		CPU_SET(cpu, &set);
+	}
+
+	for (stressor = strtok_r(stressors, "+", &saveptr); stressor;
+	     stressor = strtok_r(NULL, "+", &saveptr)) {
+		for (type = 0; type < LINUX_LOAD_MAX; type++)
+			if (!strcmp(stressor, linux_load_name[type]))
+				break;
+
+		if (type == LINUX_LOAD_MAX) {
+			printf("Unknown stressor: %s\n", stressor);
+			goto err;
+		}
+
+		for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &set) && (linux_load_add(cpu, type, intensity) < 0))
+				return -1;
+	}
+
+	return 0;
+
+err:
+	printf("Invalid Linux load profile entry\n");
+	return -1;
+}
+
+static void linux_load_free(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < linux_load.count; i++)
+		free(linux_load.thread[i].buf);
+
+	linux_load.count = 0;
+}
+
+int linux_load_start(const char *profile)
+{
+	struct linux_load_thread *t;
+	char *spec, *entry, *saveptr;
+	pthread_attr_t attr;
+	cpu_set_t online, set;
+	unsigned int i;
+	int err;
+
+	memset(&linux_load, 0, sizeof(linux_load));
+
+	if (sched_getaffinity(0, sizeof(online), &online) < 0) {
+		perror("sched_getaffinity()");
+		return -1;
+	}
+
+	spec = strdup(profile);
+	if (!spec)
+		return -1;
+
+	for (entry = strtok_r(spec, ",", &saveptr); entry; entry = strtok_r(NULL, ",", &saveptr))
+		if (linux_load_parse_entry(entry, &online) < 0)
+			goto err;
+
+	if (!linux_load.count) {
+		printf("Empty Linux load profile\n");
+		goto err;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &linux_load.start);
+
+	for (i = 0; i < linux_load.count; i++) {
+		t = &linux_load.thread[i];
+
+		CPU_ZERO(&set);
+		CPU_SET(t->cpu, &set);
+
+		pthread_attr_init(&attr);
+		pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+
+		err = pthread_create(&t->thread, &attr, linux_load_thread, t);
+		pthread_attr_destroy(&attr);
+		if (err) {
+			printf("Linux load thread creation failed: %s\n", strerror(err));
+			goto err_thread;
+		}
+	}
+
+	printf("Linux load started: %s\n", profile);
+
+	free(spec);
+
+	return 0;
+
+err_thread:
+	linux_load.stop = true;
+	while (i--)
+		pthread_join(linux_load.thread[i].thread, NULL);
+
+err:
+	linux_load_free();
+	free(spec);
+
+	return -1;
+}
+
+void linux_load_stop(void)
+{
+	struct linux_load_thread *t;
+	struct timespec end;
+	double elapsed;
+	unsigned int i;
+
+	if (!linux_load.count)
+		return;
+
+	linux_load.stop = true;
+
+	for (i = 0; i < linux_load.count; i++)
+		pthread_join(linux_load.thread[i].thread, NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	elapsed = (end.tv_sec - linux_load.start.tv_sec) +
+		  (end.tv_nsec - linux_load.start.tv_nsec) / 1e9;
+
+	printf("Linux load stopped after %.1f s\n", elapsed);
+
+	for (i = 0; i < linux_load.count; i++) {
+		t = &linux_load.thread[i];
+
+		printf("  cpu %u %-7s @%3u%%: %llu ops", t->cpu, linux_load_name[t->type], t->intensity, t->ops);
+		if (t->type == LINUX_LOAD_MEM && elapsed > 0)
+			printf(" (%.0f MB/s copied)", t->ops * (double)LINUX_LOAD_MEM_CHUNK / elapsed / (1 << 20));
+
+		printf("\n");
+	}
+
+	linux_load_free();
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _LINUX_LOAD_H_
+#define _LINUX_LOAD_H_
+
+/*
+ * Built-in Linux load generator, started and stopped around an RTOS test
+ * case. A load profile is a comma separated list of:
+ *
+ *   <cpu|all>=<stressor>[+<stressor>...][@<intensity>]
+ *
+ * stressor: mem, cache, syscall or irq
+ * intensity: duty cycle in percent (default 100)
+ */
+int linux_load_start(const char *profile);
+void linux_load_stop(void);
+void linux_load_usage(void);
+
+#endif /* _LINUX_LOAD_H_ */
@@ -13,6 +13,9 @@
 #include "hrpn_ctrl.h"
 #include "rpmsg.h"
 #include "common.h"
+#include "ctrl_daemon.h"
+#include "batch.h"
+#include "caps.h"
 
 int audio_element_routing_main(int argc, char *argv[], int fd);
 int audio_element_main(int argc, char *argv[], int fd);
@@ -26,15 +29,11 @@ int ethernet_main(int argc, char *argv[], int fd);
 void can_usage(void);
 void ethernet_usage(void);
 
-static void latency_usage(void)
-{
-	printf(
-		"\nLatency options:\n"
-		"\t-r <id>        run latency test case id\n"
-		"\t-q             quiet testing (Do not dump stats regularly, but only once on test case stop)\n"
-		"\t-s             stop running test case\n"
-	);
-}
+int latency_main(int argc, char *argv[], int fd);
+void latency_usage(void);
+
+int monitor_main(int argc, char *argv[], int fd);
+void monitor_usage(void);
 
 static void audio_usage(void)
 {
@@ -65,6 +64,32 @@ static void audio_usage(void)
 	);
 }
 
+/*
+ * Board configuration for the audio modes. The actions are idempotent, so a
+ * batch script running several audio commands only forks the configure script
+ * when the action changes.
+ */
+static int audio_configure(const char *action)
+{
+	static const char *configured;
+	char cmd[128];
+
+	if (configured && !strcmp(configured, action))
+		return 0;
+
+	configured = NULL;
+
+	snprintf(cmd, sizeof(cmd), "/usr/share/harpoon/scripts/harpoon_configure.sh audio %s", action);
+	if (system(cmd) != 0) {
+		printf("configure script failed.\n");
+		return -1;
+	}
+
+	configured = action;
+
+	return 0;
+}
+
 static int audio_run(int fd, unsigned int id, unsigned int frequency, unsigned int period, uint8_t *hw_addr, bool use_audio_hat)
 {
 	struct audio_cmd_run run = {0,};
@@ -99,6 +124,7 @@ static int audio_stop(int fd)
 
 static int audio_main(int argc, char *argv[], int fd)
 {
+	struct hrpn_resp_caps caps;
 	int option;
 	unsigned int id;
 	int rc = 0;
@@ -153,8 +179,7 @@ static int audio_main(int argc, char *argv[], int fd)
 
 		case 's':
 			rc = audio_stop(fd);
-			if (system("/usr/share/harpoon/scripts/harpoon_configure.sh audio stop") != 0) {
-				printf("configure script failed.\n");
+			if (audio_configure("stop") < 0) {
 				rc = -1;
 				goto out;
 			}
@@ -167,15 +192,20 @@ static int audio_main(int argc, char *argv[], int fd)
 		}
 	}
 
-	if (use_audio_hat && is_run_cmd) {
-		if (system("/usr/share/harpoon/scripts/harpoon_configure.sh audio start_audio_hat") != 0) {
-			printf("configure script failed.\n");
+	/*
+	 * Rejected without a round trip when the capabilities are known (cached
+	 * capabilities of another application, with a manually restarted inmate,
+	 * are ignored).
+	 */
+	if (is_run_cmd && !caps_cached(&caps) && (caps.features & HRPN_CAPS_FEATURE_AUDIO)) {
+		if (caps_audio_check(&caps, id, frequency, period, use_audio_hat ? 1 : 0) < 0) {
 			rc = -1;
 			goto out;
 		}
-	} else if (is_run_cmd) {
-		if (system("/usr/share/harpoon/scripts/harpoon_configure.sh audio start") != 0) {
-			printf("configure script failed.\n");
+	}
+
+	if (is_run_cmd) {
+		if (audio_configure(use_audio_hat ? "start_audio_hat" : "start") < 0) {
 			rc = -1;
 			goto out;
 		}
@@ -189,90 +219,24 @@ out:
 	return rc;
 }
 
-static int latency_run(int fd, unsigned int id, bool quiet)
-{
-	struct hrpn_cmd_latency_run run;
-	struct hrpn_response resp;
-	unsigned int len;
-
-	run.type = HRPN_CMD_TYPE_LATENCY_RUN;
-	run.id = id;
-	run.quiet = quiet;
-
-	len = sizeof(resp);
-
-	return command(fd, &run, sizeof(run), HRPN_RESP_TYPE_LATENCY, &resp, &len, COMMAND_TIMEOUT);
-}
-
-static int latency_stop(int fd)
-{
-	struct hrpn_cmd_latency_stop stop;
-	struct hrpn_response resp;
-	unsigned int len;
-
-	stop.type = HRPN_CMD_TYPE_LATENCY_STOP;
-
-	len = sizeof(resp);
-
-	return command(fd, &stop, sizeof(stop), HRPN_RESP_TYPE_LATENCY, &resp, &len, COMMAND_TIMEOUT);
-}
-
-static int latency_main(int argc, char *argv[], int fd)
-{
-	int option;
-	unsigned int id;
-	int rc = 0;
-	bool is_run_cmd = false, is_quiet = false;
-
-	while ((option = getopt(argc, argv, "r:qsv")) != -1) {
-		/* common options */
-		switch (option) {
-		case 'r':
-			if (strtoul_check(optarg, NULL, 0, &id) < 0) {
-				printf("Invalid id\n");
-				rc = -1;
-				goto out;
-			}
-
-			is_run_cmd = true;
-
-			break;
-
-		case 'q':
-			is_quiet = true;
-			break;
-
-		case 's':
-			rc = latency_stop(fd);
-			break;
-
-		default:
-			common_main(option, optarg);
-			break;
-		}
-	}
+const struct cmd_handler command_handler[] = {
+	{ "audio", audio_main, audio_usage, false },
+	{ "latency", latency_main, latency_usage, false },
+	{ "pipeline", audio_pipeline_main, audio_pipeline_usage, true },
+	{ "element", audio_element_main, audio_element_usage, true },
+	{ "routing", audio_element_routing_main, audio_element_routing_usage, true },
 
-	if (is_run_cmd)
-		rc = latency_run(fd, id, is_quiet);
+	{ "can", can_main, can_usage, true },
+	{ "ethernet", ethernet_main, ethernet_usage, true },
 
-out:
-	return rc;
-}
-
-const struct cmd_handler command_handler[] = {
-	{ "audio", audio_main, audio_usage },
-	{ "latency", latency_main, latency_usage },
-	{ "pipeline", audio_pipeline_main, audio_pipeline_usage },
-	{ "element", audio_element_main, audio_element_usage },
-	{ "routing", audio_element_routing_main, audio_element_routing_usage },
-
-	{ "can", can_main, can_usage },
-	{ "ethernet", ethernet_main, ethernet_usage },
+	{ "monitor", monitor_main, monitor_usage, false },
+	{ "caps", caps_main, caps_usage, false },
 };
 
 int main(int argc, char *argv[])
 {
-	int fd, i;
+	const struct cmd_handler *handler;
+	int fd;
 	int rc = 0;
 	unsigned int dst = 30;
 
@@ -281,15 +245,26 @@ int main(int argc, char *argv[])
 		goto err;
 	}
 
-	fd = rpmsg_init(dst);
+	if (!strcmp(argv[1], "--daemon"))
+		return ctrl_daemon_main(dst);
+
+	/* use the control daemon channel if one runs, the RPMsg device otherwise */
+	fd = ctrl_daemon_connect();
+	if (fd < 0)
+		fd = rpmsg_init(dst);
 	if (fd < 0)
 		goto err_rpmsg;
 
-	for (i = 0; i < sizeof(command_handler) / sizeof(struct cmd_handler); i++)
-		if (!strcmp(command_handler[i].name, argv[1])) {
-			rc = command_handler[i].main(argc - 1, argv + 1, fd);
-			goto exit;
-		}
+	if (!strcmp(argv[1], "-f")) {
+		rc = batch_main(argc, argv, fd);
+		goto exit;
+	}
+
+	handler = cmd_handler_find(argv[1]);
+	if (handler) {
+		rc = handler->main(argc - 1, argv + 1, fd);
+		goto exit;
+	}
 
 	usage();
 
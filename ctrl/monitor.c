@@ -0,0 +1,392 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+
+#include "hrpn_ctrl.h"
+#include "rpmsg.h"
+#include "common.h"
+
+#define MONITOR_PERIOD_MS	1000
+#define MONITOR_POLL_MS		100
+#define MONITOR_VALUES_MAX	1024	/* values of a snapshot */
+
+enum {
+	MONITOR_FORMAT_TABLE = 0,
+	MONITOR_FORMAT_CSV,
+	MONITOR_FORMAT_JSON,
+};
+
+static const char *monitor_source_name[HRPN_TELEMETRY_SOURCE_MAX] = {
+	[HRPN_TELEMETRY_SOURCE_SYSTEM] = "system",
+	[HRPN_TELEMETRY_SOURCE_LATENCY] = "latency",
+	[HRPN_TELEMETRY_SOURCE_CAN] = "can",
+};
+
+static const char *monitor_system_name[HRPN_TELEMETRY_SYSTEM_MAX] = {
+	[HRPN_TELEMETRY_SYSTEM_CPU_LOAD] = "cpu_load",
+	[HRPN_TELEMETRY_SYSTEM_HEAP_USED] = "heap_used",
+	[HRPN_TELEMETRY_SYSTEM_HEAP_FREE] = "heap_free",
+	[HRPN_TELEMETRY_SYSTEM_HEAP_MIN_FREE] = "heap_min_free",
+};
+
+static const char *monitor_latency_name[HRPN_TELEMETRY_LATENCY_MAX] = {
+	[HRPN_TELEMETRY_LATENCY_COUNT] = "count",
+	[HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MIN] = "irq_delay_min",
+	[HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MEAN] = "irq_delay_mean",
+	[HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MAX] = "irq_delay_max",
+	[HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MIN] = "irq_to_sched_min",
+	[HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MEAN] = "irq_to_sched_mean",
+	[HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MAX] = "irq_to_sched_max",
+	[HRPN_TELEMETRY_LATENCY_LATE_ALARM_SCHED] = "late_alarm_sched",
+};
+
+static const char *monitor_can_name[HRPN_TELEMETRY_CAN_MAX] = {
+	[HRPN_TELEMETRY_CAN_BITRATE] = "bitrate",
+	[HRPN_TELEMETRY_CAN_GLOBAL_IRQ] = "global_irq",
+	[HRPN_TELEMETRY_CAN_TX_IRQ] = "tx_irq",
+	[HRPN_TELEMETRY_CAN_TX] = "tx",
+	[HRPN_TELEMETRY_CAN_TX_BUSY] = "tx_busy",
+	[HRPN_TELEMETRY_CAN_TX_FAIL] = "tx_fail",
+	[HRPN_TELEMETRY_CAN_RX_IRQ] = "rx_irq",
+	[HRPN_TELEMETRY_CAN_RX] = "rx",
+	[HRPN_TELEMETRY_CAN_RX_OVERFLOW] = "rx_overflow",
+	[HRPN_TELEMETRY_CAN_RX_FAIL] = "rx_fail",
+};
+
+static const struct {
+	const char **name;
+	unsigned int count;
+} monitor_counter[HRPN_TELEMETRY_SOURCE_MAX] = {
+	[HRPN_TELEMETRY_SOURCE_SYSTEM] = { monitor_system_name, HRPN_TELEMETRY_SYSTEM_MAX },
+	[HRPN_TELEMETRY_SOURCE_LATENCY] = { monitor_latency_name, HRPN_TELEMETRY_LATENCY_MAX },
+	[HRPN_TELEMETRY_SOURCE_CAN] = { monitor_can_name, HRPN_TELEMETRY_CAN_MAX },
+};
+
+/* Counters of a snapshot, possibly received in several messages */
+struct monitor_snapshot {
+	uint32_t seq;
+	uint32_t time_ms;
+	unsigned int count;
+	struct hrpn_telemetry_value values[MONITOR_VALUES_MAX];
+};
+
+struct monitor {
+	unsigned int format;
+	struct monitor_snapshot snapshot[2];	/* current, previous */
+	struct monitor_snapshot *cur;
+	struct monitor_snapshot *prev;
+	unsigned int snapshots;
+};
+
+static volatile sig_atomic_t monitor_stop_request;
+
+void monitor_usage(void)
+{
+	printf(
+		"\nMonitor options (telemetry pushed by the RTOS application):\n"
+		"\t-p <period>    telemetry period (in ms, %u to %u, default %u)\n"
+		"\t-o <format>    output format: table (live view, default), csv (one line per counter) or\n"
+		"\t               json (one line per snapshot)\n"
+		"\t-n <count>     stop after count snapshots (default: until Ctrl-C)\n",
+		HRPN_TELEMETRY_PERIOD_MIN_MS, HRPN_TELEMETRY_PERIOD_MAX_MS, MONITOR_PERIOD_MS
+	);
+}
+
+static void monitor_signal_handler(int signum)
+{
+	monitor_stop_request = 1;
+}
+
+static const char *monitor_source(uint8_t source, char *buf, size_t len)
+{
+	if ((source < HRPN_TELEMETRY_SOURCE_MAX) && monitor_source_name[source])
+		return monitor_source_name[source];
+
+	snprintf(buf, len, "source%u", source);
+
+	return buf;
+}
+
+static const char *monitor_counter_name(uint8_t source, uint16_t id, char *buf, size_t len)
+{
+	if ((source < HRPN_TELEMETRY_SOURCE_MAX) && (id < monitor_counter[source].count) &&
+	    monitor_counter[source].name[id])
+		return monitor_counter[source].name[id];
+
+	snprintf(buf, len, "counter%u", id);
+
+	return buf;
+}
+
+static struct hrpn_telemetry_value *monitor_find(struct monitor_snapshot *s, struct hrpn_telemetry_value *v)
+{
+	unsigned int i;
+
+	for (i = 0; i < s->count; i++)
+		if ((s->values[i].source == v->source) && (s->values[i].instance == v->instance) &&
+		    (s->values[i].id == v->id))
+			return &s->values[i];
+
+	return NULL;
+}
+
+static void monitor_print_table(struct monitor *m)
+{
+	struct hrpn_telemetry_value *v, *prev;
+	char source[16], counter[16];
+	unsigned int i;
+
+	/* clear the terminal, live view */
+	printf("\033[H\033[2J");
+	printf("snapshot %u, RTOS time %u.%03u s\n\n", m->cur->seq, m->cur->time_ms / 1000, m->cur->time_ms % 1000);
+	printf("%-10s %-8s %-20s %12s %12s\n", "source", "instance", "counter", "value", "delta");
+
+	for (i = 0; i < m->cur->count; i++) {
+		v = &m->cur->values[i];
+		prev = m->prev->seq ? monitor_find(m->prev, v) : NULL;
+
+		printf("%-10s ", monitor_source(v->source, source, sizeof(source)));
+
+		if (v->instance == HRPN_TELEMETRY_INSTANCE_NONE)
+			printf("%-8s ", "-");
+		else
+			printf("%-8u ", v->instance);
+
+		printf("%-20s %12u ", monitor_counter_name(v->source, v->id, counter, sizeof(counter)), v->value);
+
+		/* counters wrap around */
+		if (prev)
+			printf("%12d\n", (int32_t)(v->value - prev->value));
+		else
+			printf("%12s\n", "-");
+	}
+}
+
+static void monitor_print_csv(struct monitor *m)
+{
+	struct hrpn_telemetry_value *v;
+	char source[16], counter[16];
+	unsigned int i;
+
+	if (m->snapshots == 1)
+		printf("seq,time_ms,source,instance,counter,value\n");
+
+	for (i = 0; i < m->cur->count; i++) {
+		v = &m->cur->values[i];
+
+		printf("%u,%u,%s,", m->cur->seq, m->cur->time_ms, monitor_source(v->source, source, sizeof(source)));
+
+		if (v->instance != HRPN_TELEMETRY_INSTANCE_NONE)
+			printf("%u", v->instance);
+
+		printf(",%s,%u\n", monitor_counter_name(v->source, v->id, counter, sizeof(counter)), v->value);
+	}
+}
+
+static void monitor_print_json(struct monitor *m)
+{
+	struct hrpn_telemetry_value *v;
+	char source[16], counter[16];
+	unsigned int i;
+
+	printf("{\"seq\": %u, \"time_ms\": %u, \"values\": [", m->cur->seq, m->cur->time_ms);
+
+	for (i = 0; i < m->cur->count; i++) {
+		v = &m->cur->values[i];
+
+		printf("%s{\"source\": \"%s\", \"instance\": ", i ? ", " : "",
+		       monitor_source(v->source, source, sizeof(source)));
+
+		if (v->instance == HRPN_TELEMETRY_INSTANCE_NONE)
+			printf("null");
+		else
+			printf("%u", v->instance);
+
+		printf(", \"counter\": \"%s\", \"value\": %u}",
+		       monitor_counter_name(v->source, v->id, counter, sizeof(counter)), v->value);
+	}
+
+	printf("]}\n");
+}
+
+static void monitor_snapshot_done(struct monitor *m)
+{
+	struct monitor_snapshot *s;
+
+	m->snapshots++;
+
+	switch (m->format) {
+	case MONITOR_FORMAT_TABLE:
+		monitor_print_table(m);
+		break;
+
+	case MONITOR_FORMAT_CSV:
+		monitor_print_csv(m);
+		break;
+
+	case MONITOR_FORMAT_JSON:
+		monitor_print_json(m);
+		break;
+	}
+
+	fflush(stdout);
+
+	s = m->prev;
+	m->prev = m->cur;
+	m->cur = s;
+	m->cur->seq = 0;
+	m->cur->count = 0;
+}
+
+static void monitor_data(struct monitor *m, struct hrpn_resp_telemetry_data *msg, unsigned int len)
+{
+	unsigned int i;
+
+	if ((len < offsetof(struct hrpn_resp_telemetry_data, values)) ||
+	    (msg->count > HRPN_TELEMETRY_VALUES_MAX) ||
+	    (len < offsetof(struct hrpn_resp_telemetry_data, values) + msg->count * sizeof(struct hrpn_telemetry_value))) {
+		printf("invalid telemetry message (len: %u)\n", len);
+		return;
+	}
+
+	/* messages of a previous snapshot lost, start over */
+	if (msg->seq != m->cur->seq) {
+		m->cur->seq = msg->seq;
+		m->cur->time_ms = msg->time_ms;
+		m->cur->count = 0;
+	}
+
+	for (i = 0; (i < msg->count) && (m->cur->count < MONITOR_VALUES_MAX); i++)
+		m->cur->values[m->cur->count++] = msg->values[i];
+
+	if (msg->flags & HRPN_TELEMETRY_LAST)
+		monitor_snapshot_done(m);
+}
+
+static int monitor_period(int fd, unsigned int period_ms)
+{
+	struct hrpn_cmd_telemetry cmd;
+	struct hrpn_resp_telemetry resp;
+	struct command_req req = {
+		.cmd = &cmd,
+		.cmd_len = sizeof(cmd),
+		.resp_type = HRPN_RESP_TYPE_TELEMETRY,
+		.resp = &resp,
+		.resp_len = sizeof(resp),
+	};
+
+	cmd.type = HRPN_CMD_TYPE_TELEMETRY;
+	cmd.period_ms = period_ms;
+
+	/* no "command success" output, which would go in the CSV/JSON stream */
+	return command_pipeline(fd, &req, 1, 1, COMMAND_TIMEOUT);
+}
+
+int monitor_main(int argc, char *argv[], int fd)
+{
+	static struct monitor m;
+	struct hrpn_response resp;
+	unsigned int period_ms = MONITOR_PERIOD_MS;
+	unsigned int count = 0;
+	struct sigaction sa;
+	unsigned int len;
+	int option;
+	int tfd;
+	int rc = -1;
+
+	m.format = MONITOR_FORMAT_TABLE;
+
+	while ((option = getopt(argc, argv, "p:o:n:v")) != -1) {
+		switch (option) {
+		case 'p':
+			if ((strtoul_check(optarg, NULL, 0, &period_ms) < 0) ||
+			    (period_ms < HRPN_TELEMETRY_PERIOD_MIN_MS) || (period_ms > HRPN_TELEMETRY_PERIOD_MAX_MS)) {
+				printf("Invalid period\n");
+				goto out;
+			}
+
+			break;
+
+		case 'o':
+			if (!strcmp(optarg, "table")) {
+				m.format = MONITOR_FORMAT_TABLE;
+			} else if (!strcmp(optarg, "csv")) {
+				m.format = MONITOR_FORMAT_CSV;
+			} else if (!strcmp(optarg, "json")) {
+				m.format = MONITOR_FORMAT_JSON;
+			} else {
+				printf("Invalid format\n");
+				goto out;
+			}
+
+			break;
+
+		case 'n':
+			if (strtoul_check(optarg, NULL, 0, &count) < 0) {
+				printf("Invalid count\n");
+				goto out;
+			}
+
+			break;
+
+		default:
+			common_main(option, optarg);
+			rc = (option == 'v') ? 0 : -1;
+			goto out;
+		}
+	}
+
+	m.cur = &m.snapshot[0];
+	m.prev = &m.snapshot[1];
+	m.cur->seq = 0;
+	m.prev->seq = 0;
+	m.snapshots = 0;
+
+	/* dedicated endpoint, the control channel stays available to other commands */
+	tfd = rpmsg_init(HRPN_TELEMETRY_EPT);
+	if (tfd < 0) {
+		printf("telemetry endpoint not available\n");
+		goto out;
+	}
+
+	if (monitor_period(tfd, period_ms) < 0) {
+		printf("telemetry start failed\n");
+		goto deinit;
+	}
+
+	monitor_stop_request = 0;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = monitor_signal_handler;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	while (!monitor_stop_request && (!count || (m.snapshots < count))) {
+		len = sizeof(resp);
+		if (rpmsg_recv(tfd, &resp, &len, MONITOR_POLL_MS) < 0)
+			continue;
+
+		if ((len >= sizeof(struct hrpn_resp)) && (HRPN_TYPE(resp.u.resp.type) == HRPN_RESP_TYPE_TELEMETRY_DATA))
+			monitor_data(&m, &resp.u.telemetry_data, len);
+	}
+
+	rc = 0;
+
+	if (monitor_period(tfd, 0) < 0)
+		printf("telemetry stop failed\n");
+
+deinit:
+	rpmsg_deinit(tfd);
+
+out:
+	return rc;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright 2022-2023 NXP
+ * Copyright 2022-2023, 2025 NXP
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,29 +16,6 @@
 
 #include "rpmsg.h"
 
-static ssize_t readn(int fd, void *buf, size_t len)
-{
-	size_t nr_left;
-	ssize_t nr_read;
-	char *pos;
-
-	nr_left = len;
-	pos = buf;
-	while (nr_left > 0) {
-		nr_read = read(fd, pos, nr_left);
-		if (nr_read <= 0)
-			if (!nr_read || errno == EAGAIN)
-				break;
-			else
-				return nr_read;
-
-		nr_left -= nr_read;
-		pos += nr_read;
-	}
-
-	return (len - nr_left);
-}
-
 static ssize_t writen(int fd, const void *buf, size_t len)
 {
 	size_t nr_left;
@@ -83,12 +60,14 @@ int rpmsg_recv(int fd, void *data, unsigned int *len, int timeout)
 	pfd.events = POLLIN;
 
 	if (poll(&pfd, 1, timeout) < 0) {
-		perror("poll()");
+		if (errno != EINTR)
+			perror("poll()");
 		goto out;
 	}
 
 	if (pfd.revents & POLLIN) {
-		ret = readn(fd, data, *len);
+		/* one read() returns exactly one RPMsg message, never concatenate them */
+		ret = read(fd, data, *len);
 		if (ret >= 0) {
 			*len = ret;
 			err = 0;
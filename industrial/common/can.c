@@ -14,6 +14,7 @@
 
 #include "os/counter.h"
 #include "os/irq.h"
+#include "timer_wheel.h"
 #include <string.h>
 
 /*******************************************************************************
@@ -39,10 +40,16 @@
 #define MAX_NODES					2
 #define MAX_MESSAGE_BUFFERS			4
 #define PROCESS_ALARM_PERIOD_US		1200U
+#define TIMER_WHEEL_RESOLUTION_US	200U
+#define TIMER_WHEEL_CHANNEL			0
 #define MEGA						1000000U
 
 extern os_counter_t *os_counter;
 
+/* Software timers of the application, multiplexed on a single counter channel */
+static struct timer_wheel timer_wheel;
+static bool timer_wheel_initialized;
+
 enum {
 	TEST_4_MB = 0,
 };
@@ -103,7 +110,7 @@ struct can_ctx {
 	uint8_t node;
 	uint8_t test_type;
 
-	struct os_counter_alarm_cfg alarm_cfg;
+	struct timer_wheel_timer tx_timer;
 	uint32_t alarm_err;
 
 	bool use_canfd;
@@ -172,33 +179,37 @@ static void can_irq_handler(void *data)
 		ctx->event_send(ctx->event_data, EVENT_TYPE_IRQ, 0);
 }
 
-static void alarm_handler(os_counter_t *dev, uint8_t chan_id,
-			  uint32_t irq_counter,
-			  void *user_data)
+static void alarm_handler(struct timer_wheel_timer *timer, void *user_data)
 {
 	struct can_ctx *ctx = user_data;
 
 	if (ctx->event_send)
 		ctx->event_send(ctx->event_data, EVENT_TYPE_TIMER, 0);
-
 }
 
-static int alarm_trigger(struct can_ctx *ctx, uint32_t us)
+static int alarm_start(struct can_ctx *ctx, uint32_t period_us)
 {
-	int err = 0;
-	uint64_t ticks = os_counter_us_to_ticks(os_counter, us);
+	int err;
+
+	if (!timer_wheel_initialized) {
+		err = timer_wheel_init(&timer_wheel, os_counter, TIMER_WHEEL_CHANNEL, TIMER_WHEEL_RESOLUTION_US);
+		if (err < 0)
+			goto err;
+
+		timer_wheel_initialized = true;
+	}
 
-	ctx->alarm_cfg.ticks = ticks;
-	ctx->alarm_cfg.flags = 0;
-	ctx->alarm_cfg.user_data = ctx;
-	ctx->alarm_cfg.callback = alarm_handler;
+	timer_wheel_timer_init(&ctx->tx_timer, alarm_handler, ctx);
 
-	err = os_counter_set_channel_alarm(os_counter, 0, &ctx->alarm_cfg);
+	err = timer_wheel_timer_start(&timer_wheel, &ctx->tx_timer, period_us, period_us);
+	if (err < 0)
+		goto err;
 
+	return 0;
+
+err:
 	/* Counter set alarm failed */
-	if (err < 0) {
-		ctx->alarm_err++;
-	}
+	ctx->alarm_err++;
 
 	return err;
 }
@@ -487,7 +498,7 @@ int can_run(void *priv, struct event *e)
 		can_enable_interrupt(ctx);
 		os_counter_start(os_counter);
 
-		if (alarm_trigger(ctx, PROCESS_ALARM_PERIOD_US) < 0)
+		if (alarm_start(ctx, PROCESS_ALARM_PERIOD_US) < 0)
 			break;
 
 		status = 0;
@@ -516,9 +527,6 @@ int can_run(void *priv, struct event *e)
 				mb_tx_process(&ctx->mb[i], ctx->base, ctx->use_canfd, e);
 		}
 
-		if (alarm_trigger(ctx, PROCESS_ALARM_PERIOD_US) < 0)
-			break;
-
 		status = 0;
 		break;
 	default:
@@ -547,12 +555,36 @@ void can_stats(void *priv)
 	}
 }
 
+void can_telemetry(void *priv, struct telemetry *t)
+{
+	struct can_ctx *ctx = priv;
+	struct message_buffer *mb;
+
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, HRPN_TELEMETRY_INSTANCE_NONE, HRPN_TELEMETRY_CAN_BITRATE, ctx->bps);
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, HRPN_TELEMETRY_INSTANCE_NONE, HRPN_TELEMETRY_CAN_GLOBAL_IRQ, ctx->global_irq_count);
+
+	for (int i= 0; i < ctx->mb_number; i++) {
+		mb = &ctx->mb[i];
+
+		if (mb->conf.tx) {
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_TX_IRQ, mb->stats.tx.irq_iter);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_TX, mb->stats.tx.w_success);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_TX_BUSY, mb->stats.tx.busy);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_TX_FAIL, mb->stats.tx.w_fail);
+		} else {
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_RX_IRQ, mb->stats.rx.irq_iter);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_RX, mb->stats.rx.r_success);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_RX_OVERFLOW, mb->stats.rx.overflow);
+			telemetry_add(t, HRPN_TELEMETRY_SOURCE_CAN, mb->conf.index, HRPN_TELEMETRY_CAN_RX_FAIL, mb->stats.rx.r_fail);
+		}
+	}
+}
+
 void can_exit(void *priv)
 {
 	struct can_ctx *ctx = priv;
 
-	os_counter_stop(os_counter);
-	os_counter_cancel_channel_alarm(os_counter, 0);
+	timer_wheel_timer_cancel(&timer_wheel, &ctx->tx_timer);
 	can_disable_interrupt(ctx);
 	FLEXCAN_Deinit(ctx->base);
 	rtos_free(ctx);
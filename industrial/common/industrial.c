@@ -13,6 +13,7 @@
 #include "industrial.h"
 #include "rpmsg.h"
 #include "rtos_abstraction_layer.h"
+#include "version.h"
 
 #define EPT_ADDR	(30)
 
@@ -64,15 +65,37 @@ static void industrial_stats(struct industrial_ctx *ctx)
 	}
 }
 
-static void response(struct rpmsg_ept *ept, uint32_t status)
+static void response(struct rpmsg_ept *ept, uint32_t req_id, uint32_t status)
 {
 	struct hrpn_resp_industrial resp;
 
-	resp.type = HRPN_RESP_TYPE_INDUSTRIAL;
+	resp.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_INDUSTRIAL, req_id);
 	resp.status = status;
 	rpmsg_send(ept, &resp, sizeof(resp));
 }
 
+static void industrial_caps(struct rpmsg_ept *ept, uint32_t req_id)
+{
+	struct hrpn_resp_caps caps;
+
+	memset(&caps, 0, sizeof(caps));
+
+	caps.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_CAPS, req_id);
+	caps.status = HRPN_RESP_STATUS_SUCCESS;
+	caps.version = HRPN_CAPS_VERSION(VERSION_MAJOR, VERSION_MDIUM, VERSION_MINOR);
+	caps.features = HRPN_CAPS_FEATURE_REQ_ID | HRPN_CAPS_FEATURE_TELEMETRY;
+
+	caps.can_modes = use_cases[INDUSTRIAL_USE_CASE_CAN].ops_num;
+	if (caps.can_modes)
+		caps.features |= HRPN_CAPS_FEATURE_CAN;
+
+	caps.ethernet_modes = use_cases[INDUSTRIAL_USE_CASE_ETHERNET].ops_num;
+	if (caps.ethernet_modes)
+		caps.features |= HRPN_CAPS_FEATURE_ETHERNET;
+
+	rpmsg_send(ept, &caps, sizeof(caps));
+}
+
 static void industrial_set_hw_addr(struct industrial_config *cfg, uint8_t *hw_addr)
 {
 	uint8_t *addr = cfg->address;
@@ -151,13 +174,17 @@ static void industrial_command_handler(struct industrial_ctx *ctx)
 	struct rpmsg_ept *ept = ctx->ctrl.ept;
 	struct data_ctx *data = NULL;
 	unsigned int len;
+	uint32_t req_id;
 	int rc;
 
 	len = sizeof(cmd);
 	if (rpmsg_recv(ept, &cmd, &len) < 0)
 		return;
 
-	switch (cmd.u.cmd.type) {
+	/* echoed in the response */
+	req_id = HRPN_REQ_ID(cmd.u.cmd.type);
+
+	switch (HRPN_TYPE(cmd.u.cmd.type)) {
 	case HRPN_CMD_TYPE_CAN_RUN:
 		if (!data)
 			data = industrial_get_data_ctx(ctx, INDUSTRIAL_USE_CASE_CAN);
@@ -166,14 +193,14 @@ static void industrial_command_handler(struct industrial_ctx *ctx)
 		if (!data)
 			data = industrial_get_data_ctx(ctx, INDUSTRIAL_USE_CASE_ETHERNET);
 		if (len != sizeof(struct hrpn_cmd_industrial_run)) {
-			response(ept, HRPN_RESP_STATUS_ERROR);
+			response(ept, req_id, HRPN_RESP_STATUS_ERROR);
 			break;
 		}
 
 		log_debug("data %p: ept=%p type=%x val=%p\n", data, ept, cmd.u.cmd.type, &cmd.u.industrial_run);
 		rc = industrial_run(data, &cmd.u.industrial_run);
 
-		response(ept, rc);
+		response(ept, req_id, rc);
 
 		break;
 
@@ -185,18 +212,22 @@ static void industrial_command_handler(struct industrial_ctx *ctx)
 		if (!data)
 			data = industrial_get_data_ctx(ctx, INDUSTRIAL_USE_CASE_ETHERNET);
 		if (len != sizeof(struct hrpn_cmd_industrial_stop)) {
-			response(ept, HRPN_RESP_STATUS_ERROR);
+			response(ept, req_id, HRPN_RESP_STATUS_ERROR);
 			break;
 		}
 
 		rc = industrial_stop(data);
 
-		response(ept, rc);
+		response(ept, req_id, rc);
 
 		break;
 
+	case HRPN_CMD_TYPE_CAPS:
+		industrial_caps(ept, req_id);
+		break;
+
 	default:
-		response(ept, HRPN_RESP_STATUS_ERROR);
+		response(ept, req_id, HRPN_RESP_STATUS_ERROR);
 		break;
 	}
 }
@@ -205,12 +236,30 @@ static void industrial_command_handler(struct industrial_ctx *ctx)
 #define STATS_POLL_PERIOD	10000
 #define STATS_COUNT		(STATS_POLL_PERIOD / CONTROL_POLL_PERIOD)
 
+static void industrial_telemetry(struct industrial_ctx *ctx)
+{
+	int i;
+
+	if (!telemetry_poll(&ctx->telemetry, CONTROL_POLL_PERIOD))
+		return;
+
+	for (i = 0; i < INDUSTRIAL_USE_CASE_MAX; i++) {
+		struct data_ctx *data = &ctx->data[i];
+
+		if (data->ops && data->ops->telemetry)
+			data->ops->telemetry(data->priv, &ctx->telemetry);
+	}
+
+	telemetry_send(&ctx->telemetry);
+}
+
 void industrial_control_loop(void *context)
 {
 	struct industrial_ctx *ctx = context;
 	static int count = STATS_COUNT;
 
 	industrial_command_handler(ctx);
+	industrial_telemetry(ctx);
 
 	count--;
 	if (!count) {
@@ -250,6 +299,9 @@ void *industrial_control_init(int nb_use_cases)
 	ctx->ctrl.ept = rpmsg_transport_init(RL_BOARD_RPMSG_LINK_ID, EPT_ADDR, "rpmsg-raw");
 	rtos_assert(ctx->ctrl.ept, "rpmsg transport initialization failed!");
 
+	err = telemetry_init(&ctx->telemetry, ctx->ctrl.ept->ri);
+	rtos_assert(!err, "telemetry initialization failed!");
+
 	for (i = 0; i < nb_use_cases; i++) {
 		struct data_ctx *data = &ctx->data[i];
 
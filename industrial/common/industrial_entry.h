@@ -8,6 +8,7 @@
 #define _INDUSTRIAL_ENTRY_H_
 
 #include "rpmsg.h"
+#include "telemetry.h"
 #include "industrial_os.h"
 
 #include "rtos_abstraction_layer.h"
@@ -32,6 +33,7 @@ struct mode_operations {
 	void *(*init)(void *);
 	void (*exit)(void *);
 	void (*stats)(void *);
+	void (*telemetry)(void *, struct telemetry *t);	/* optional */
 	int (*run)(void *, struct event *e);
 };
 
@@ -54,6 +56,7 @@ struct ctrl_ctx {
 
 struct industrial_ctx {
 	struct ctrl_ctx ctrl;
+	struct telemetry telemetry;
 
 	struct data_ctx data[INDUSTRIAL_USE_CASE_MAX];
 };
@@ -69,6 +72,7 @@ void *can_init(void *parameters);
 int can_run(void *priv, struct event *e);
 void can_exit(void *priv);
 void can_stats(void *priv);
+void can_telemetry(void *priv, struct telemetry *t);
 
 void *ethernet_avb_tsn_init(void *parameters);
 int ethernet_avb_tsn_run(void *priv, struct event *e);
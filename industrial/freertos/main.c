@@ -22,7 +22,11 @@
 
 __WEAK void BOARD_InitPlatform(void) {}
 
+#if defined(OS_COUNTER_GENERIC_TIMER)
+os_counter_t *os_counter = GET_COUNTER_DEVICE_INSTANCE(generic);
+#else
 os_counter_t *os_counter = GET_COUNTER_DEVICE_INSTANCE(0);
+#endif
 
 const struct industrial_use_case use_cases[] =
 {
@@ -38,6 +42,7 @@ const struct industrial_use_case use_cases[] =
 				.exit = can_exit,
 				.run = can_run,
 				.stats = can_stats,
+				.telemetry = can_telemetry,
 			},
 		},
 		.ops_num = INDUSTRIAL_CAN_USE_CASES_NUM,
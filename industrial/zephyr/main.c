@@ -48,6 +48,7 @@ const struct industrial_use_case use_cases[] =
 				.exit = can_exit,
 				.run = can_run,
 				.stats = can_stats,
+				.telemetry = can_telemetry,
 			},
 		},
 		.ops_num = INDUSTRIAL_CAN_USE_CASES_NUM,
@@ -4,54 +4,41 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stddef.h>
+
 #include "os/counter.h"
 #include "os/cache.h"
+#include "os/irq.h"
+#include "os/sched.h"
+#include "os/trace.h"
 
 #include "rtos_apps/log.h"
 #include "rtos_apps/stats.h"
 
+#include "gen_sw_mbox.h"
+#include "gen_sw_mbox_config.h"
+#include "hdr_hist.h"
 #include "hrpn_ctrl.h"
 #include "rt_latency.h"
+#include "rt_latency_hot.h"
 #include "rtos_abstraction_layer.h"
+#include "version.h"
 
 #define EPT_ADDR (30)
 
-static inline uint32_t calc_diff_ns(os_counter_t *dev,
-			uint32_t cnt_1, uint32_t cnt_2)
+static inline void irq_load_busy_wait(struct rt_latency_ctx *ctx, os_counter_t *dev)
 {
-	uint32_t diff;
-	static uint32_t top = 0;
-	static int counting_up = -1;
-
-	/*
-	 * Set these variables once for all to avoid multiple register accesses
-	 * each time we call this function.
-	 */
-	if (top == 0)
-		top = os_counter_get_top_value(dev);
-
-	if (counting_up == -1)
-		counting_up = os_counter_is_counting_up(dev);
+	uint32_t start, cur;
 
-	if (counting_up) {
-		diff =  (cnt_2 < cnt_1) ?
-			(cnt_2 + top - cnt_1) : (cnt_2 - cnt_1);
-	} else {
-		diff = (cnt_2 > cnt_1) ?
-			(cnt_1 + top - cnt_2) : (cnt_1 - cnt_2);
-	}
+	os_counter_get_value(dev, &start);
 
-	return os_counter_ticks_to_ns(dev, diff);
+	do {
+		os_counter_get_value(dev, &cur);
+	} while (calc_diff_ns(dev, start, cur) < ctx->irq_load_duration_ns);
 }
 
-/*
- * Used by all RTOS:
- *    o FreeRTOS through IRQ_Handler_GPT() handler
- *    o Zephyr through the alarm's ->callback
- *
- * @current_counter: counter value when the IRQ occurred
- */
-static void latency_alarm_handler(os_counter_t *dev, uint8_t chan_id,
+/* IRQ load synchronized with the latency alarm: fires once per iteration */
+static void load_alarm_handler(os_counter_t *dev, uint8_t chan_id,
 			  uint32_t irq_counter,
 			  void *user_data)
 {
@@ -59,193 +46,1623 @@ static void latency_alarm_handler(os_counter_t *dev, uint8_t chan_id,
 	bool yield = false;
 	int err;
 
-	ctx->time_irq = irq_counter;
+	irq_load_busy_wait(ctx, dev);
+
+	os_counter_stop(dev);
 
-	err = rtos_sem_give_from_isr(&ctx->semaphore, &yield);
+	err = rtos_sem_give_from_isr(&ctx->irq_load_sem, &yield);
 	rtos_assert(!err, "Failed to give semaphore from isr (err: %d)", err);
 
 	rtos_yield_from_isr(yield);
 }
 
-#define IRQ_LOAD_ISR_DURATION_US	10
+/*
+ * Periodic mode: the IRQ load synchronized with the latency alarm fires 1 us
+ * before the next deadline of the latency timeline, so that it stays in phase
+ * with the measured events. The IRQ load counter is stopped between
+ * iterations: the ticks left to the deadline are carried over to it.
+ */
+static uint32_t load_alarm_deadline(struct rt_latency_ctx *ctx)
+{
+	os_counter_t *dev = ctx->dev;
+	os_counter_t *load_dev = ctx->irq_load_dev;
+	uint32_t cnt, load_cnt, lead;
+	uint64_t ahead;
 
-static void load_alarm_handler(os_counter_t *dev, uint8_t chan_id,
+	os_counter_get_value(dev, &cnt);
+	os_counter_get_value(load_dev, &load_cnt);
+
+	ahead = calc_diff_ticks(dev, cnt, ctx->time_prog);
+
+	/* deadline already gone, the measurement resyncs on the next one */
+	if (ahead > ctx->period_ticks)
+		ahead = ctx->period_ticks - calc_diff_ticks(dev, ctx->time_prog, cnt) % ctx->period_ticks;
+
+	ahead = ahead * os_counter_us_to_ticks(load_dev, 1000000) / os_counter_us_to_ticks(dev, 1000000);
+	lead = os_counter_us_to_ticks(load_dev, 1);
+
+	return calc_add_ticks(load_dev, load_cnt, ahead > lead ? ahead - lead : ahead);
+}
+
+/* Free running IRQ load: re-armed from the handler at its own fixed rate */
+static void load_alarm_periodic_handler(os_counter_t *dev, uint8_t chan_id,
 			  uint32_t irq_counter,
 			  void *user_data)
 {
 	struct rt_latency_ctx *ctx = user_data;
-	uint32_t start, cur;
-	bool yield = false;
+	struct os_counter_alarm_cfg alarm_cfg;
 	int err;
 
-	os_counter_get_value(dev, &start);
+	irq_load_busy_wait(ctx, dev);
 
-	do {
-		os_counter_get_value(dev, &cur);
-	} while (calc_diff_ns(dev, start, cur) < IRQ_LOAD_ISR_DURATION_US * 1000);
+	ctx->irq_load_prog = calc_add_ticks(dev, ctx->irq_load_prog, ctx->irq_load_period_ticks);
 
-	os_counter_stop(dev);
+	alarm_cfg.ticks = ctx->irq_load_prog;
+	alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+	alarm_cfg.user_data = ctx;
+	alarm_cfg.callback = load_alarm_periodic_handler;
 
-	err = rtos_sem_give_from_isr(&ctx->irq_load_sem, &yield);
-	rtos_assert(!err, "Failed to give semaphore from isr (err: %d)", err);
+	err = os_counter_set_channel_alarm(dev, chan_id, &alarm_cfg);
+	rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+}
 
-	rtos_yield_from_isr(yield);
+static void storm_busy_wait(uint64_t start, uint64_t duration)
+{
+	while (os_trace_timestamp() - start < duration)
+		;
+}
+
+/*
+ * Interrupt storm source handler, one per nesting level: the next level is
+ * raised halfway through the busy loop, and preempts this handler if
+ * interrupts nest.
+ */
+static void storm_sgi_handler(void *data)
+{
+	struct rt_latency_storm_level *level = data;
+	struct rt_latency_storm_source *src = level->src;
+	uint64_t start = os_trace_timestamp();
+
+	if (level->depth < src->nest) {
+		storm_busy_wait(start, src->duration / 2);
+
+		os_irq_trigger_sgi(src->sgi + level->depth + 1);
+	}
+
+	storm_busy_wait(start, src->duration);
+}
+
+/* Deadlines not reached yet are less than one period ahead of @cnt */
+static bool storm_source_due(os_counter_t *dev, struct rt_latency_storm_source *src, uint32_t cnt)
+{
+	uint32_t ahead = calc_diff_ticks(dev, cnt, src->next);
+
+	return !ahead || (ahead > src->period_ticks);
+}
+
+/* Program the alarm on the earliest deadline of the sources */
+static void storm_alarm_program(struct rt_latency_storm *storm, os_counter_t *dev, uint32_t cnt);
+
+/* Interrupt storm driver: raise the interrupts of the sources due, during storm windows only */
+static void storm_alarm_handler(os_counter_t *dev, uint8_t chan_id,
+			  uint32_t irq_counter,
+			  void *user_data)
+{
+	struct rt_latency_storm *storm = user_data;
+	struct rt_latency_storm_source *src;
+	uint32_t cnt, missed;
+	unsigned int i;
+
+	if (!__atomic_load_n(&storm->active, __ATOMIC_ACQUIRE))
+		return;
+
+	os_counter_get_value(dev, &cnt);
+
+	for (i = 0; i < storm->count; i++) {
+		src = &storm->src[i];
+
+		if (!storm_source_due(dev, src, cnt))
+			continue;
+
+		missed = calc_diff_ticks(dev, src->next, cnt) / src->period_ticks;
+		src->overruns += missed;
+		src->next = calc_add_ticks(dev, src->next, (uint64_t)(missed + 1) * src->period_ticks);
+
+		os_irq_trigger_sgi(src->sgi);
+		src->fired++;
+	}
+
+	storm_alarm_program(storm, dev, cnt);
+}
+
+static void storm_alarm_program(struct rt_latency_storm *storm, os_counter_t *dev, uint32_t cnt)
+{
+	struct rt_latency_storm_source *first = &storm->src[0];
+	struct os_counter_alarm_cfg alarm_cfg;
+	unsigned int i;
+	int err;
+
+	for (i = 1; i < storm->count; i++)
+		if (calc_diff_ticks(dev, cnt, storm->src[i].next) < calc_diff_ticks(dev, cnt, first->next))
+			first = &storm->src[i];
+
+	alarm_cfg.ticks = first->next;
+	alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+	alarm_cfg.user_data = storm;
+	alarm_cfg.callback = storm_alarm_handler;
+
+	err = os_counter_set_channel_alarm(dev, 0, &alarm_cfg);
+	rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+}
+
+/* Called by the benchmark task: SGIs are private to each core */
+static void rt_latency_storm_start(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_storm *storm = &ctx->storm;
+	os_counter_t *dev = ctx->irq_load_dev;
+	struct rt_latency_storm_level *level;
+	unsigned int i, sgi;
+	int err;
+
+	for (i = 0; i < storm->levels; i++) {
+		level = &storm->level[i];
+		sgi = level->src->sgi + level->depth;
+
+		err = os_irq_register(sgi, storm_sgi_handler, level, level->src->prio - level->depth);
+		rtos_assert(!err, "Failed to register storm IRQ %u (err: %d)", sgi, err);
+
+		os_irq_enable(sgi);
+	}
+
+	os_counter_start(dev);
+
+	storm->started = true;
+}
+
+/*
+ * Called by the benchmark task at each iteration: the storm alarm is armed at
+ * the start of a storm window and cancelled at its end, so that the baseline
+ * windows see no storm driver interrupt either. The alarm interrupt is routed
+ * to the benchmark core, its handler never runs concurrently.
+ */
+static void rt_latency_storm_window(struct rt_latency_ctx *ctx, bool active)
+{
+	struct rt_latency_storm *storm = &ctx->storm;
+	os_counter_t *dev = ctx->irq_load_dev;
+	uint32_t cnt;
+	unsigned int i;
+	int err;
+
+	if (active == storm->active)
+		return;
+
+	if (active) {
+		os_counter_get_value(dev, &cnt);
+
+		for (i = 0; i < storm->count; i++)
+			storm->src[i].next = calc_add_ticks(dev, cnt, storm->src[i].period_ticks);
+
+		__atomic_store_n(&storm->active, true, __ATOMIC_RELEASE);
+
+		storm_alarm_program(storm, dev, cnt);
+	} else {
+		__atomic_store_n(&storm->active, false, __ATOMIC_RELEASE);
+
+		err = os_counter_cancel_channel_alarm(dev, 0);
+		rtos_assert(!err, "Failed to cancel counter alarm!");
+	}
+}
+
+static void rt_latency_storm_stop(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_storm *storm = &ctx->storm;
+	struct rt_latency_storm_level *level;
+	unsigned int i, sgi;
+	int err;
+
+	if (storm->started) {
+		err = os_counter_stop(ctx->irq_load_dev);
+		rtos_assert(!err, "Failed to stop counter!");
+
+		err = os_counter_cancel_channel_alarm(ctx->irq_load_dev, 0);
+		rtos_assert(!err, "Failed to cancel counter alarm!");
+
+		for (i = 0; i < storm->levels; i++) {
+			level = &storm->level[i];
+			sgi = level->src->sgi + level->depth;
+
+			os_irq_disable(sgi);
+			os_irq_unregister(sgi);
+		}
+	}
+
+	storm->started = false;
+	storm->active = false;
+}
+
+static void rt_latency_storm_init(struct rt_latency_storm *storm, os_counter_t *dev,
+		struct rt_latency_cfg *cfg)
+{
+	struct rt_latency_storm_source *src;
+	uint32_t frequency = os_trace_frequency();
+	unsigned int i, depth;
+
+	storm->count = cfg->irq_storm_count;
+	storm->levels = 0;
+	storm->started = false;
+	storm->active = false;
+
+	for (i = 0; i < storm->count; i++) {
+		src = &storm->src[i];
+
+		src->period_us = cfg->irq_storm[i].period_us;
+		src->duration_us = cfg->irq_storm[i].duration_us;
+		src->period_ticks = os_counter_us_to_ticks(dev, src->period_us);
+		src->duration = (uint64_t)src->duration_us * frequency / 1000000;
+		src->prio = cfg->irq_storm[i].prio;
+		src->nest = cfg->irq_storm[i].nest;
+		src->sgi = RT_LATENCY_STORM_SGI_BASE + storm->levels;
+		src->fired = 0;
+		src->overruns = 0;
+
+		for (depth = 0; depth <= src->nest; depth++) {
+			storm->level[storm->levels].src = src;
+			storm->level[storm->levels].depth = depth;
+			storm->levels++;
+		}
+
+		log_info("Interrupt storm source %u: period %u us, duration %u us, priority %u, %u nested\n",
+			 i, src->period_us, src->duration_us, src->prio, src->nest);
+	}
+
+	if (storm->count)
+		log_info("Interrupt storm: %u iterations on, %u off\n",
+			 RT_LATENCY_STORM_WINDOW, RT_LATENCY_STORM_WINDOW);
+}
+
+static void rt_latency_storm_snapshot(struct rt_latency_storm *storm)
+{
+	unsigned int i;
+
+	hdr_hist_copy(storm->irq_delay_off_snapshot, storm->irq_delay_off);
+	hdr_hist_copy(storm->irq_delay_on_snapshot, storm->irq_delay_on);
+
+	for (i = 0; i < storm->count; i++) {
+		storm->fired_snapshot[i] = storm->src[i].fired;
+		storm->overruns_snapshot[i] = storm->src[i].overruns;
+	}
+}
+
+static const char *rt_latency_phase_name[RT_LATENCY_PHASE_MAX] = {
+	[RT_LATENCY_PHASE_HW_ENTRY] = "hw entry (ns)",
+	[RT_LATENCY_PHASE_IRQ_DISPATCH] = "irq dispatch (ns)",
+	[RT_LATENCY_PHASE_ISR] = "isr to sem give (ns)",
+	[RT_LATENCY_PHASE_SEM_TO_SWITCH] = "sem give to switch-in (ns)",
+	[RT_LATENCY_PHASE_SWITCH_TO_TASK] = "switch-in to task (ns)",
+};
+
+static const char *rt_latency_wakeup_name[RT_LATENCY_WAKEUP_MAX][2] = {
+	[RT_LATENCY_WAKEUP_SEM] = { "semaphore isr to task (ns)", "semaphore task to task (ns)" },
+	[RT_LATENCY_WAKEUP_MQUEUE] = { "message queue isr to task (ns)", "message queue task to task (ns)" },
+	[RT_LATENCY_WAKEUP_NOTIFY] = { OS_NOTIFY_NAME " isr to task (ns)", OS_NOTIFY_NAME " task to task (ns)" },
+	[RT_LATENCY_WAKEUP_MUTEX] = { "mutex isr to task (ns)", "mutex task to task (ns)" },
+};
+
+static const char *rt_latency_sched_name[RT_LATENCY_SCHED_MAX] = {
+	[RT_LATENCY_SCHED_SWITCH] = "task switch (ns)",
+	[RT_LATENCY_SCHED_PREEMPT] = "preemption (ns)",
+	[RT_LATENCY_SCHED_YIELD] = "yield (ns)",
+	[RT_LATENCY_SCHED_MUTEX_PI] = "mutex hand-over with priority inheritance (ns)",
+};
+
+static void rt_latency_stats_init(rt_latency_stats_t *stats, unsigned int hist_sub_bits)
+{
+	int i;
+
+	rtos_apps_stats_init(&stats->irq_delay, 31, "irq delay (ns)", NULL);
+	hdr_hist_init(&stats->irq_delay_hist, "irq delay (ns)", hist_sub_bits);
+
+	rtos_apps_stats_init(&stats->irq_to_sched, 31, "irq to sched (ns)", NULL);
+	hdr_hist_init(&stats->irq_to_sched_hist, "irq to sched (ns)", hist_sub_bits);
+
+	stats->late_alarm_sched = 0;
+
+	for (i = 0; i < RT_LATENCY_PHASE_MAX; i++) {
+		rtos_apps_stats_init(&stats->phase[i], 31, rt_latency_phase_name[i], NULL);
+		hdr_hist_init(&stats->phase_hist[i], rt_latency_phase_name[i], hist_sub_bits);
+	}
+
+	rtos_apps_stats_init(&stats->wakeup_jitter, 31, "wake-up jitter (ns)", NULL);
+	stats->drift = 0;
+	stats->missed_deadlines = 0;
+}
+
+static void rt_latency_stats_reset(rt_latency_stats_t *stats)
+{
+	int i;
+
+	rtos_apps_stats_reset(&stats->irq_delay);
+	hdr_hist_reset(&stats->irq_delay_hist);
+
+	rtos_apps_stats_reset(&stats->irq_to_sched);
+	hdr_hist_reset(&stats->irq_to_sched_hist);
+
+	stats->late_alarm_sched = 0;
+
+	for (i = 0; i < RT_LATENCY_PHASE_MAX; i++) {
+		rtos_apps_stats_reset(&stats->phase[i]);
+		hdr_hist_reset(&stats->phase_hist[i]);
+	}
+
+	rtos_apps_stats_reset(&stats->wakeup_jitter);
+	stats->drift = 0;
+	stats->missed_deadlines = 0;
+}
+
+/*
+ * Copy @stats to @snapshot and start a new statistics period (histograms keep
+ * accumulating). Only the histogram buckets in use are copied.
+ */
+static void rt_latency_stats_snapshot(rt_latency_stats_t *snapshot, rt_latency_stats_t *stats)
+{
+	int i;
+
+	snapshot->irq_delay = stats->irq_delay;
+	hdr_hist_copy(&snapshot->irq_delay_hist, &stats->irq_delay_hist);
+
+	snapshot->irq_to_sched = stats->irq_to_sched;
+	hdr_hist_copy(&snapshot->irq_to_sched_hist, &stats->irq_to_sched_hist);
+
+	snapshot->late_alarm_sched = stats->late_alarm_sched;
+
+	for (i = 0; i < RT_LATENCY_PHASE_MAX; i++) {
+		snapshot->phase[i] = stats->phase[i];
+		hdr_hist_copy(&snapshot->phase_hist[i], &stats->phase_hist[i]);
+	}
+
+	snapshot->wakeup_jitter = stats->wakeup_jitter;
+	snapshot->drift = stats->drift;
+	snapshot->missed_deadlines = stats->missed_deadlines;
+
+	rtos_apps_stats_reset(&stats->irq_delay);
+	rtos_apps_stats_reset(&stats->irq_to_sched);
+	for (i = 0; i < RT_LATENCY_PHASE_MAX; i++)
+		rtos_apps_stats_reset(&stats->phase[i]);
+	rtos_apps_stats_reset(&stats->wakeup_jitter);
+}
+
+static void rt_latency_wakeup_stats_init(struct rt_latency_wakeup_stats *stats, unsigned int hist_sub_bits)
+{
+	int i;
+
+	for (i = 0; i < RT_LATENCY_WAKEUP_MAX; i++) {
+		rtos_apps_stats_init(&stats[i].isr_to_task, 31, rt_latency_wakeup_name[i][0], NULL);
+		hdr_hist_init(&stats[i].isr_to_task_hist, rt_latency_wakeup_name[i][0], hist_sub_bits);
+
+		rtos_apps_stats_init(&stats[i].task_to_task, 31, rt_latency_wakeup_name[i][1], NULL);
+		hdr_hist_init(&stats[i].task_to_task_hist, rt_latency_wakeup_name[i][1], hist_sub_bits);
+	}
+}
+
+/* Same as rt_latency_stats_snapshot(), for the wake-up matrix */
+static void rt_latency_wakeup_stats_snapshot(struct rt_latency_wakeup *w)
+{
+	int i;
+
+	for (i = 0; i < RT_LATENCY_WAKEUP_MAX; i++) {
+		w->snapshot[i].isr_to_task = w->stats[i].isr_to_task;
+		hdr_hist_copy(&w->snapshot[i].isr_to_task_hist, &w->stats[i].isr_to_task_hist);
+
+		w->snapshot[i].task_to_task = w->stats[i].task_to_task;
+		hdr_hist_copy(&w->snapshot[i].task_to_task_hist, &w->stats[i].task_to_task_hist);
+
+		rtos_apps_stats_reset(&w->stats[i].isr_to_task);
+		rtos_apps_stats_reset(&w->stats[i].task_to_task);
+	}
+}
+
+static void rt_latency_sched_stats_init(struct rt_latency_sched_stats *stats, unsigned int hist_sub_bits)
+{
+	int i;
+
+	for (i = 0; i < RT_LATENCY_SCHED_MAX; i++) {
+		rtos_apps_stats_init(&stats[i].stats, 31, rt_latency_sched_name[i], NULL);
+		hdr_hist_init(&stats[i].hist, rt_latency_sched_name[i], hist_sub_bits);
+	}
+}
+
+/* Same as rt_latency_stats_snapshot(), for the scheduling benchmark */
+static void rt_latency_sched_stats_snapshot(struct rt_latency_sched *s)
+{
+	int i;
+
+	for (i = 0; i < RT_LATENCY_SCHED_MAX; i++) {
+		s->snapshot[i].stats = s->stats[i].stats;
+		hdr_hist_copy(&s->snapshot[i].hist, &s->stats[i].hist);
+
+		rtos_apps_stats_reset(&s->stats[i].stats);
+	}
+}
+
+/*
+ * Single soak ring, for the first benchmark core. Allocated by the first soak
+ * mode test case, and kept after the test case ends for the soak read command.
+ */
+static struct rt_latency_soak *rt_latency_soak;
+
+static int rt_latency_soak_init(struct rt_latency_ctx *ctx, struct rt_latency_cfg *cfg)
+{
+	struct rt_latency_soak *soak = rt_latency_soak;
+	int i;
+
+	ctx->soak = NULL;
+
+	if (!cfg->soak_window_s)
+		return 0;
+
+	if (!soak) {
+		soak = rtos_malloc(sizeof(struct rt_latency_soak));
+		if (!soak) {
+			log_err("soak mode ring allocation failed\n");
+#if !defined(FSL_RTOS_FREE_RTOS)
+			log_err("heap sized for the features selected in the application Kconfig (CONFIG_RT_LATENCY_SOAK)\n");
+#endif
+			return -1;
+		}
+
+		rt_latency_soak = soak;
+	}
+
+	soak->window_s = cfg->soak_window_s;
+	/* windows on the generic timer, the latency counter is stopped between measurements in relative mode */
+	soak->window_ticks = (uint64_t)cfg->soak_window_s * os_trace_frequency();
+	soak->start = os_trace_timestamp();
+	soak->window_start = soak->start;
+	soak->active = 0;
+	soak->pending = false;
+	soak->late_alarm_sched = 0;
+	soak->missed = 0;
+	soak->seq = 0;
+
+	for (i = 0; i < 2; i++) {
+		hdr_hist_init(&soak->hist[i], "soak irq delay (ns)", cfg->hist_sub_bits);
+		soak->irq_to_sched_max[i] = 0;
+	}
+
+	ctx->soak = soak;
+
+	log_info("Soak mode: %u s windows, latest %u windows kept\n", soak->window_s, RT_LATENCY_SOAK_RING_SIZE);
+
+	return 0;
+}
+
+/* Hand the current window, ending at @end, over to the control task, or drop it if the previous one is still pending */
+static void rt_latency_soak_handover(struct rt_latency_ctx *ctx, uint64_t end)
+{
+	struct rt_latency_soak *soak = ctx->soak;
+	unsigned int active = soak->active;
+	uint32_t late = ctx->stats.late_alarm_sched;
+
+	if (__atomic_load_n(&soak->pending, __ATOMIC_ACQUIRE)) {
+		soak->missed++;
+		hdr_hist_reset(&soak->hist[active]);
+		soak->irq_to_sched_max[active] = 0;
+	} else {
+		soak->late[active] = late - soak->late_alarm_sched;
+		soak->hist_start[active] = soak->window_start;
+		soak->hist_end[active] = end;
+		soak->active = !active;
+		__atomic_store_n(&soak->pending, true, __ATOMIC_RELEASE);
+	}
+
+	soak->late_alarm_sched = late;
+	soak->window_start = end;
+}
+
+/* Called by the benchmark task after each measurement */
+static void rt_latency_soak_update(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_soak *soak = ctx->soak;
+	unsigned int active = soak->active;
+	uint64_t elapsed;
+
+	hdr_hist_update(&soak->hist[active], ctx->irq_delay);
+
+	if (ctx->irq_to_sched > soak->irq_to_sched_max[active])
+		soak->irq_to_sched_max[active] = ctx->irq_to_sched > UINT32_MAX ? UINT32_MAX : ctx->irq_to_sched;
+
+	elapsed = os_trace_timestamp() - soak->window_start;
+	if (elapsed < soak->window_ticks)
+		return;
+
+	/* window boundary, the window spans several if there was no sample for a while */
+	rt_latency_soak_handover(ctx, soak->window_start + elapsed - elapsed % soak->window_ticks);
+}
+
+/* Called by the control task: reduce the window handed over to a ring entry */
+static void rt_latency_soak_reduce(struct rt_latency_soak *soak)
+{
+	struct hrpn_latency_soak_entry *e;
+	struct hdr_hist *h;
+	unsigned int prev;
+
+	if (!__atomic_load_n(&soak->pending, __ATOMIC_ACQUIRE))
+		return;
+
+	prev = !soak->active;
+	h = &soak->hist[prev];
+	e = &soak->ring[soak->seq % RT_LATENCY_SOAK_RING_SIZE];
+
+	e->start = soak->hist_start[prev];
+	e->duration_ms = ((soak->hist_end[prev] - soak->hist_start[prev]) * 1000) / os_trace_frequency();
+	e->count = h->total > UINT32_MAX ? UINT32_MAX : h->total;
+	e->min = h->total ? h->min : 0;
+	e->mean = hdr_hist_mean(h);
+	e->max = h->max;
+	e->p50 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P50);
+	e->p99 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99);
+	e->p99_99 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_99);
+	e->irq_to_sched_max = soak->irq_to_sched_max[prev];
+	e->late_alarm_sched = soak->late[prev];
+
+	hdr_hist_reset(h);
+	soak->irq_to_sched_max[prev] = 0;
+	soak->seq++;
+
+	__atomic_store_n(&soak->pending, false, __ATOMIC_RELEASE);
+}
+
+/* Called once the benchmark task stopped: record the pending and last (partial) windows */
+static void rt_latency_soak_flush(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_soak *soak = ctx->soak;
+
+	rt_latency_soak_reduce(soak);
+
+	if (soak->hist[soak->active].total) {
+		rt_latency_soak_handover(ctx, os_trace_timestamp());
+		rt_latency_soak_reduce(soak);
+	}
+
+	log_info("soak mode: %u windows recorded, %u missed\n", soak->seq, soak->missed);
 }
 
 static void rt_latency_stats_dump(struct rt_latency_ctx *ctx)
 {
 	if (!ctx->stats_snapshot.pending) {
-		memcpy(&ctx->stats_snapshot, &ctx->stats, sizeof(struct rt_latency_stats));
+		rt_latency_stats_snapshot(&ctx->stats_snapshot, &ctx->stats);
 
-		ctx->stats_snapshot.pending = true;
+		if (ctx->tc_load & RT_LATENCY_USES_OCRAM)
+			rt_latency_stats_snapshot(ctx->ocram_stats_snapshot, ctx->ocram_stats);
+
+		if (ctx->wakeup.enabled)
+			rt_latency_wakeup_stats_snapshot(&ctx->wakeup);
+
+		if (ctx->sched.enabled)
+			rt_latency_sched_stats_snapshot(&ctx->sched);
+
+		if (ctx->storm.count)
+			rt_latency_storm_snapshot(&ctx->storm);
 
-		rtos_apps_stats_reset(&ctx->stats.irq_delay);
-		rtos_apps_stats_reset(&ctx->stats.irq_to_sched);
+		ctx->stats_snapshot.pending = true;
 	}
 }
 
 /*
- * Blocking function including an infinite loop ;
- * must be called by separate threads/tasks.
- *
- * In case an error is returned the caller shall handle the lifecycle of the
- * thread by suspending or destroying the latter.
+ * Task to task wake-up, with the primitive of the current window: the peer
+ * task (higher priority) is released, reports it is about to wait on the
+ * primitive (or to lock the mutex held by the benchmark task) and blocks,
+ * then the benchmark task signals it and waits for its measurement.
  */
-int rt_latency_test(struct rt_latency_ctx *ctx)
+static void rt_latency_wakeup_task_to_task(struct rt_latency_ctx *ctx)
 {
+	struct rt_latency_wakeup *w = &ctx->wakeup;
+	uint32_t msg = 0;
 	int err;
-	uint32_t cnt;
-	struct os_counter_alarm_cfg alarm_cfg;
-	struct os_counter_alarm_cfg load_alarm_cfg;
-	uint32_t now;
-	uint64_t irq_delay;
-	uint64_t irq_to_sched;
-	os_counter_t *dev = ctx->dev;
-	static uint32_t ticks = 0;
-#define LATENCY_STATS_PERIOD (LATENCY_STATS_PERIOD_SEC * 1000000 / COUNTER_PERIOD_US_VAL)
-	static uint64_t stats_cnt = 0;
 
-	/* only compute it once for all */
-	if (!ticks) {
-		uint32_t counter_period_us;
+	if (w->prim == RT_LATENCY_WAKEUP_MUTEX) {
+		err = rtos_mutex_lock(&w->mutex, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Failed to lock mutex (err: %d)", err);
+	}
+
+	err = rtos_sem_give(&w->peer_start);
+	rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+	err = rtos_sem_take(&w->peer_ready, RTOS_WAIT_FOREVER);
+	rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+	w->ts_signal = os_trace_timestamp();
+
+	switch (w->prim) {
+	case RT_LATENCY_WAKEUP_MQUEUE:
+		err = rtos_mqueue_send(w->mqueue, &msg, RTOS_NO_WAIT);
+		break;
+
+	case RT_LATENCY_WAKEUP_NOTIFY:
+		err = os_notify_give(&w->notify);
+		break;
+
+	case RT_LATENCY_WAKEUP_MUTEX:
+		err = rtos_mutex_unlock(&w->mutex);
+		break;
+
+	default:
+		err = rtos_sem_give(&w->sem);
+		break;
+	}
+
+	rtos_assert(!err, "Failed to wake the peer task up (err: %d)", err);
+
+	err = rtos_sem_take(&w->peer_done, RTOS_WAIT_FOREVER);
+	rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+}
+
+/*
+ * Wake-up matrix peer task body, called in a loop by the OS specific task.
+ * The task must have a higher priority than the benchmark task (or, on
+ * Zephyr, be cooperative as the benchmark thread is).
+ */
+void rt_latency_wakeup_peer(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_wakeup *w = &ctx->wakeup;
+	struct rt_latency_wakeup_stats *stats;
+	uint64_t task_to_task;
+	uint32_t msg;
+	int err;
+
+	if (!w->notify_bound) {
+		os_notify_init(&w->notify);
+		w->notify_bound = true;
+	}
+
+	err = rtos_sem_take(&w->peer_start, RTOS_WAIT_FOREVER);
+	rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+	err = rtos_sem_give(&w->peer_ready);
+	rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+	switch (w->prim) {
+	case RT_LATENCY_WAKEUP_MQUEUE:
+		err = rtos_mqueue_receive(w->mqueue, &msg, RTOS_WAIT_FOREVER);
+		break;
+
+	case RT_LATENCY_WAKEUP_NOTIFY:
+		err = os_notify_take(&w->notify, OS_NOTIFY_WAIT_FOREVER);
+		break;
+
+	case RT_LATENCY_WAKEUP_MUTEX:
+		err = rtos_mutex_lock(&w->mutex, RTOS_WAIT_FOREVER);
+		break;
+
+	default:
+		err = rtos_sem_take(&w->sem, RTOS_WAIT_FOREVER);
+		break;
+	}
+
+	task_to_task = rt_latency_ts_to_ns(ctx, os_trace_timestamp() - w->ts_signal);
+	rtos_assert(!err, "Failed to wait for the benchmark task (err: %d)", err);
+
+	if (w->prim == RT_LATENCY_WAKEUP_MUTEX)
+		rtos_mutex_unlock(&w->mutex);
+
+	stats = &w->stats[w->prim];
+	rtos_apps_stats_update(&stats->task_to_task, task_to_task);
+	hdr_hist_update(&stats->task_to_task_hist, task_to_task);
+
+	err = rtos_sem_give(&w->peer_done);
+	rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+}
+
+/* Called by the peer task switched in, @ts being its first timestamp once running */
+static void rt_latency_sched_update(struct rt_latency_ctx *ctx, uint64_t ts)
+{
+	struct rt_latency_sched *s = &ctx->sched;
+	struct rt_latency_sched_stats *stats = &s->stats[s->test];
+	uint64_t ns;
+
+	if (!s->ts) {
+		s->dropped++;
+		return;
+	}
+
+	ns = rt_latency_ts_to_ns(ctx, ts - s->ts);
+
+	rtos_apps_stats_update(&stats->stats, ns);
+	hdr_hist_update(&stats->hist, ns);
+}
+
+/*
+ * Scheduling benchmark iteration, run by the benchmark task instead of the
+ * alarm wait: the measurement of the current window, then a pause so that
+ * the lower priority tasks (control task included) run while the benchmark
+ * task and its peers are all blocked.
+ *
+ * The peers timestamp their switch-in. The same priority peer is made ready
+ * before the timestamp taken ahead of the switch, it may only have been
+ * switched in earlier by time slicing, the measurement is then dropped.
+ */
+static int rt_latency_sched_test(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_sched *s = &ctx->sched;
+	int err;
+
+	if (!s->t0)
+		s->t0 = os_trace_timestamp();
+
+	s->test = (ctx->iterations / RT_LATENCY_SCHED_WINDOW) % RT_LATENCY_SCHED_MAX;
+	s->ts = 0;
+
+	switch (s->test) {
+	case RT_LATENCY_SCHED_SWITCH:
+	case RT_LATENCY_SCHED_YIELD:
+		err = rtos_sem_give(&s->start[RT_LATENCY_SCHED_PEER_SAME]);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		s->ts = os_trace_timestamp();
+
+		/* task switch: block on the peer measurement below */
+		if (s->test == RT_LATENCY_SCHED_YIELD)
+			os_sched_yield();
+
+		break;
+
+	case RT_LATENCY_SCHED_PREEMPT:
+		s->ts = os_trace_timestamp();
+
+		err = rtos_sem_give(&s->start[RT_LATENCY_SCHED_PEER_HIGH]);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		break;
+
+	case RT_LATENCY_SCHED_MUTEX_PI:
+		/* the low priority peer locks the mutex, then waits for the unlock request */
+		err = rtos_sem_give(&s->start[RT_LATENCY_SCHED_PEER_LOW]);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		err = rtos_sem_take(&s->locked, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+		/* the high priority peer blocks on the mutex, boosting the low priority one */
+		err = rtos_sem_give(&s->start[RT_LATENCY_SCHED_PEER_HIGH]);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		/* boosted above the benchmark task, the low priority peer must unlock right away */
+		s->low_running = false;
+
+		err = rtos_sem_give(&s->unlock);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		if (!s->low_running)
+			s->pi_failures++;
+
+		break;
+	}
+
+	err = rtos_sem_take(&s->done, RTOS_WAIT_FOREVER);
+	rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+	ctx->iterations++;
+
+	if (ctx->duration_ns) {
+		ctx->elapsed_ns = rt_latency_ts_to_ns(ctx, os_trace_timestamp() - s->t0);
+		if (ctx->elapsed_ns >= ctx->duration_ns)
+			__atomic_store_n(&ctx->done, true, __ATOMIC_RELEASE);
+	}
+
+	if (!ctx->quiet) {
+		/* Dump statistics every LATENCY_STATS_PERIOD_SEC seconds (about) */
+		if (!(ctx->iterations % ctx->stats_period))
+			rt_latency_stats_dump(ctx);
+	}
+
+	rtos_sleep(RTOS_MS_TO_TICKS(RT_LATENCY_SCHED_PAUSE_MS));
+
+	return 0;
+}
+
+/*
+ * Scheduling benchmark peer task body, called in a loop by the OS specific
+ * task. @peer (RT_LATENCY_SCHED_PEER_xxx) gives the task priority relative to
+ * the benchmark task, all tasks running on the same core.
+ */
+void rt_latency_sched_peer(struct rt_latency_ctx *ctx, unsigned int peer)
+{
+	struct rt_latency_sched *s = &ctx->sched;
+	uint64_t ts;
+	int err;
+
+	err = rtos_sem_take(&s->start[peer], RTOS_WAIT_FOREVER);
+	ts = os_trace_timestamp();
+	rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+	switch (peer) {
+	case RT_LATENCY_SCHED_PEER_LOW:
+		err = rtos_mutex_lock(&s->mutex, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Failed to lock mutex (err: %d)", err);
+
+		err = rtos_sem_give(&s->locked);
+		rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+
+		err = rtos_sem_take(&s->unlock, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Failed to take semaphore (err: %d)", err);
+
+		s->low_running = true;
+		s->ts = os_trace_timestamp();
+
+		/* hands the mutex over to the high priority peer, which measures */
+		err = rtos_mutex_unlock(&s->mutex);
+		rtos_assert(!err, "Failed to unlock mutex (err: %d)", err);
+
+		return;
+
+	case RT_LATENCY_SCHED_PEER_HIGH:
+		if (s->test == RT_LATENCY_SCHED_MUTEX_PI) {
+			err = rtos_mutex_lock(&s->mutex, RTOS_WAIT_FOREVER);
+			ts = os_trace_timestamp();
+			rtos_assert(!err, "Failed to lock mutex (err: %d)", err);
+
+			rtos_mutex_unlock(&s->mutex);
+		}
+
+		break;
+
+	default:
+		break;
+	}
+
+	rt_latency_sched_update(ctx, ts);
+
+	err = rtos_sem_give(&s->done);
+	rtos_assert(!err, "Failed to give semaphore (err: %d)", err);
+}
+
+/*
+ * Blocking function including an infinite loop ;
+ * must be called by separate threads/tasks.
+ *
+ * In case an error is returned the caller shall handle the lifecycle of the
+ * thread by suspending or destroying the latter.
+ */
+int rt_latency_test(struct rt_latency_ctx *ctx)
+{
+	int err;
+	uint32_t cnt;
+	struct os_counter_alarm_cfg load_alarm_cfg;
+	os_counter_t *dev = ctx->dev;
+
+	/* Test duration elapsed: idle until the control task destroys the test case */
+	if (__atomic_load_n(&ctx->done, __ATOMIC_ACQUIRE)) {
+		rtos_sleep(RTOS_MS_TO_TICKS(COUNTER_IRQ_TIMEOUT_MS));
+		return 0;
+	}
+
+	if (ctx->sched.enabled)
+		return rt_latency_sched_test(ctx);
+
+	/*
+	 * Start IRQ latency testing alarm. In periodic mode the counter keeps
+	 * running between iterations so that all alarms share the same timeline.
+	 */
+	if (ctx->mode == HRPN_LATENCY_MODE_RELATIVE || !ctx->timeline_started)
+		os_counter_start(dev);
+
+	/* Start IRQ load alarm, if need be */
+	if (ctx->tc_load & RT_LATENCY_WITH_IRQ_LOAD) {
+		if (!ctx->irq_load_period_ticks) {
+			/* fire just before the latency alarm */
+			os_counter_start(ctx->irq_load_dev);
+			if ((ctx->mode == HRPN_LATENCY_MODE_PERIODIC) && ctx->timeline_started) {
+				load_alarm_cfg.ticks = load_alarm_deadline(ctx);
+				load_alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+			} else {
+				load_alarm_cfg.ticks = os_counter_us_to_ticks(ctx->irq_load_dev, ctx->period_us - 1);
+				load_alarm_cfg.flags = 0;
+			}
+			load_alarm_cfg.user_data = ctx;
+			load_alarm_cfg.callback = load_alarm_handler;
+
+			err = os_counter_set_channel_alarm(ctx->irq_load_dev, 0, &load_alarm_cfg);
+			rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+		} else if (!ctx->irq_load_started) {
+			os_counter_start(ctx->irq_load_dev);
+			os_counter_get_value(ctx->irq_load_dev, &cnt);
+			ctx->irq_load_prog = calc_add_ticks(ctx->irq_load_dev, cnt, ctx->irq_load_period_ticks);
+
+			load_alarm_cfg.ticks = ctx->irq_load_prog;
+			load_alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+			load_alarm_cfg.user_data = ctx;
+			load_alarm_cfg.callback = load_alarm_periodic_handler;
+
+			err = os_counter_set_channel_alarm(ctx->irq_load_dev, 0, &load_alarm_cfg);
+			rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+
+			ctx->irq_load_started = true;
+		}
+	}
+
+	/* Wake-up matrix: next primitive, by windows of iterations */
+	if (ctx->wakeup.enabled) {
+		if (!ctx->wakeup.isr_notify_bound) {
+			os_notify_init(&ctx->wakeup.isr_notify);
+			ctx->wakeup.isr_notify_bound = true;
+		}
+
+		ctx->wakeup.prim = (ctx->iterations / RT_LATENCY_WAKEUP_WINDOW) % RT_LATENCY_WAKEUP_MAX;
+	}
+
+	/* Interrupt storm: baseline and storm windows of iterations, baseline first */
+	if (ctx->storm.count) {
+		if (!ctx->storm.started)
+			rt_latency_storm_start(ctx);
+
+		rt_latency_storm_window(ctx, (ctx->iterations / RT_LATENCY_STORM_WINDOW) & 1);
+	}
+
+	/* Alternate DDR and OCRAM copies of the measurement code, by windows of iterations */
+	if ((ctx->tc_load & RT_LATENCY_USES_OCRAM) && !(ctx->iterations % RT_LATENCY_OCRAM_WINDOW))
+		ctx->ocram_window = !ctx->ocram_window;
+
+	if (ctx->ocram_window)
+		err = rt_latency_measure_ocram(ctx);
+	else
+		err = rt_latency_measure(ctx, &ctx->stats);
+
+	if (ctx->storm.count)
+		hdr_hist_update(ctx->storm.active ? ctx->storm.irq_delay_on : ctx->storm.irq_delay_off,
+				ctx->irq_delay);
+
+	if (ctx->soak)
+		rt_latency_soak_update(ctx);
+
+	if (ctx->wakeup.enabled)
+		rt_latency_wakeup_task_to_task(ctx);
+
+	ctx->iterations++;
+
+	if (!ctx->quiet) {
+		/* Dump statistics every LATENCY_STATS_PERIOD_SEC seconds */
+		if (!(ctx->iterations % ctx->stats_period))
+			rt_latency_stats_dump(ctx);
+	}
+
+	if ((ctx->tc_load & RT_LATENCY_WITH_IRQ_LOAD) && !ctx->irq_load_period_ticks) {
+		/* Waiting irq load ISR exits and then go to next loop */
+		err = rtos_sem_take(&ctx->irq_load_sem, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Can't take the semaphore (err: %d)", err);
+	}
+
+	return err;
+}
+
+void cpu_load(struct rt_latency_ctx *ctx)
+{
+	int err;
+
+	if (ctx->tc_load & RT_LATENCY_WITH_CPU_LOAD_SEM) {
+		err = rtos_sem_take(&ctx->cpu_load_sem, RTOS_WAIT_FOREVER);
+		rtos_assert(!err, "Failed to take semaphore");
+
+		err = rtos_sem_give(&ctx->cpu_load_sem);
+		rtos_assert(!err, "Failed to give semaphore");
+	}
+}
+
+/* Memory interference load buffer, one slice per load core */
+static uint8_t rt_latency_mem_buf[RT_LATENCY_MEM_SIZE_MAX] __attribute__((aligned(64)));
+
+static const char *rt_latency_mem_pattern_name[HRPN_LATENCY_MEM_PATTERN_MAX] = {
+	[HRPN_LATENCY_MEM_READ_WRITE] = "read-modify-write",
+	[HRPN_LATENCY_MEM_READ] = "read",
+	[HRPN_LATENCY_MEM_WRITE] = "write",
+	[HRPN_LATENCY_MEM_RANDOM] = "random read",
+};
+
+/*
+ * Memory interference load: one pass over the footprint of the load core
+ * @cpu, one access per stride. The random pattern visits as many strides,
+ * picked by a linear congruential generator.
+ */
+void mem_load(struct rt_latency_ctx *ctx, unsigned int cpu)
+{
+	uint8_t *buf = &rt_latency_mem_buf[cpu * RT_LATENCY_MEM_SLICE_SIZE];
+	unsigned int size = ctx->mem_size;
+	unsigned int stride = ctx->mem_stride;
+	unsigned int n = size / stride;
+	volatile uint32_t *p;
+	uint32_t off, seed;
+	unsigned int i;
+
+	switch (ctx->mem_pattern) {
+	case HRPN_LATENCY_MEM_READ:
+		for (off = 0; off < size; off += stride)
+			(void)*(volatile uint32_t *)(buf + off);
+
+		break;
+
+	case HRPN_LATENCY_MEM_WRITE:
+		for (off = 0; off < size; off += stride)
+			*(volatile uint32_t *)(buf + off) = off;
+
+		break;
+
+	case HRPN_LATENCY_MEM_RANDOM:
+		seed = (uint32_t)os_trace_timestamp();
+
+		for (i = 0; i < n; i++) {
+			seed = seed * 1664525 + 1013904223;
+			(void)*(volatile uint32_t *)(buf + (uint32_t)(((uint64_t)seed * n) >> 32) * stride);
+		}
+
+		break;
+
+	default:
+		for (off = 0; off < size; off += stride) {
+			p = (volatile uint32_t *)(buf + off);
+			*p = *p + 1;
+		}
+
+		break;
+	}
+}
+
+void cache_inval(void)
+{
+	os_trace_record(OS_TRACE_CACHE_INVAL_ENTRY, 0);
+
+	os_dcache_invd_all();
+	os_icache_invd_all();
+
+	os_trace_record(OS_TRACE_CACHE_INVAL_EXIT, 0);
+
+	rtos_sleep(RTOS_MS_TO_TICKS(CACHE_INVAL_PERIOD_MS));
+}
+
+/*
+ * Send all samples captured so far, in batches of HRPN_LATENCY_SAMPLES_MAX.
+ * Called periodically by the control task, and once more when the test case
+ * is destroyed.
+ */
+static void rt_latency_capture_send(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_capture *cap = &ctx->capture;
+	struct hrpn_resp_latency_samples msg;
+	uint32_t head, tail;
+	int err;
+
+	if (!cap->ept)
+		return;
+
+	head = __atomic_load_n(&cap->head, __ATOMIC_ACQUIRE);
+	tail = cap->tail;
+
+	while (tail != head) {
+		msg.count = 0;
+		while ((tail != head) && (msg.count < HRPN_LATENCY_SAMPLES_MAX))
+			msg.samples[msg.count++] = cap->ring[tail++ & (RT_LATENCY_CAPTURE_RING_SIZE - 1)];
+
+		__atomic_store_n(&cap->tail, tail, __ATOMIC_RELEASE);
+
+		msg.type = HRPN_RESP_TYPE_LATENCY_SAMPLES;
+		msg.status = HRPN_RESP_STATUS_SUCCESS;
+		msg.seq = cap->seq++;
+		msg.dropped = cap->dropped;
+		msg.frequency = cap->frequency;
+
+		err = rpmsg_send(cap->ept, &msg, sizeof(msg));
+		if (err) {
+			log_err("rpmsg_send() failed (err: %d)\n", err);
+			break;
+		}
+	}
+}
+
+/*
+ * Send the frozen event trace, in batches of HRPN_LATENCY_TRACE_EVENTS_MAX,
+ * and restart it for the next outlier.
+ */
+static void rt_latency_trace_send(struct rt_latency_ctx *ctx)
+{
+	struct rt_latency_trace *trace = &ctx->trace;
+	struct hrpn_resp_latency_trace msg;
+	struct os_trace_event ev[HRPN_LATENCY_TRACE_EVENTS_MAX];
+	unsigned int total, i;
+	int err;
+
+	if (!trace->ept || !__atomic_load_n(&trace->pending, __ATOMIC_ACQUIRE))
+		return;
+
+	total = os_trace_count();
+
+	log_info("outlier: irq delay %u ns, sending trace (%u events)\n", trace->value, total);
+
+	msg.type = HRPN_RESP_TYPE_LATENCY_TRACE;
+	msg.status = HRPN_RESP_STATUS_SUCCESS;
+	msg.seq = trace->seq++;
+	msg.value = trace->value;
+	msg.frequency = os_trace_frequency();
+	msg.total = total;
+
+	for (msg.index = 0; msg.index < total; msg.index += msg.count) {
+		msg.count = os_trace_read(ev, msg.index, HRPN_LATENCY_TRACE_EVENTS_MAX);
+
+		for (i = 0; i < msg.count; i++) {
+			msg.events[i].ts = ev[i].ts;
+			msg.events[i].type = ev[i].type;
+			msg.events[i].arg = ev[i].arg;
+		}
+
+		err = rpmsg_send(trace->ept, &msg, sizeof(msg));
+		if (err) {
+			log_err("rpmsg_send() failed (err: %d)\n", err);
+			break;
+		}
+	}
+
+	__atomic_store_n(&trace->pending, false, __ATOMIC_RELAXED);
+	os_trace_restart();
+}
+
+static void rt_latency_stats_send_metric(struct rt_latency_ctx *ctx, uint32_t metric,
+		const struct hdr_hist *h)
+{
+	struct hrpn_resp_latency_stats msg;
+	int err;
+
+	msg.type = HRPN_RESP_TYPE_LATENCY_STATS;
+	msg.status = HRPN_RESP_STATUS_SUCCESS;
+	msg.core = ctx->core;
+	msg.metric = metric;
+	msg.count = h->total;
+	msg.min = h->total ? h->min : 0;
+	msg.mean = hdr_hist_mean(h);
+	msg.max = h->max;
+	msg.p50 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P50);
+	msg.p99 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99);
+	msg.p99_9 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_9);
+	msg.p99_99 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_99);
+	msg.p99_999 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_999);
+	msg.p99_9999 = hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_9999);
+	msg.late_alarm_sched = ctx->stats.late_alarm_sched;
+
+	err = rpmsg_send(ctx->stats_ept, &msg, sizeof(msg));
+	if (err)
+		log_err("rpmsg_send() failed (err: %d)\n", err);
+}
+
+/* Non-empty buckets of the histogram, in batches of HRPN_LATENCY_HIST_BUCKETS_MAX */
+static void rt_latency_hist_send(struct rt_latency_ctx *ctx, uint32_t metric, const struct hdr_hist *h)
+{
+	struct hrpn_resp_latency_hist msg;
+	unsigned int i, total = 0;
+	int err;
+
+	for (i = 0; i < HDR_HIST_BUCKETS(h->sub_bits); i++)
+		if (h->count[i])
+			total++;
+
+	msg.type = HRPN_RESP_TYPE_LATENCY_HIST;
+	msg.status = HRPN_RESP_STATUS_SUCCESS;
+	msg.core = ctx->core;
+	msg.metric = metric;
+	msg.sub_bits = h->sub_bits;
+	msg.index = 0;
+	msg.total = total;
+	msg.count = 0;
+
+	for (i = 0; i < HDR_HIST_BUCKETS(h->sub_bits); i++) {
+		if (!h->count[i])
+			continue;
+
+		msg.buckets[msg.count].index = i;
+		msg.buckets[msg.count].count = h->count[i];
+		msg.count++;
+
+		if ((msg.count == HRPN_LATENCY_HIST_BUCKETS_MAX) || (msg.index + msg.count == total)) {
+			err = rpmsg_send(ctx->stats_ept, &msg, sizeof(msg));
+			if (err) {
+				log_err("rpmsg_send() failed (err: %d)\n", err);
+				break;
+			}
+
+			msg.index += msg.count;
+			msg.count = 0;
+		}
+	}
+}
+
+/*
+ * End of run statistics report, from the histograms accumulated over the
+ * whole test case (DDR copy of the measurement code for the OCRAM test case).
+ * Nothing is sent if the test case did not run, so that a failed start
+ * is only answered by its error response.
+ */
+static void rt_latency_stats_send(struct rt_latency_ctx *ctx)
+{
+	int i;
+
+	if (!ctx->stats_ept || !ctx->iterations)
+		return;
+
+	if (ctx->sched.enabled) {
+		for (i = 0; i < RT_LATENCY_SCHED_MAX; i++) {
+			rt_latency_stats_send_metric(ctx, HRPN_LATENCY_METRIC_SCHED_SWITCH + i, &ctx->sched.stats[i].hist);
+			rt_latency_hist_send(ctx, HRPN_LATENCY_METRIC_SCHED_SWITCH + i, &ctx->sched.stats[i].hist);
+		}
+
+		return;
+	}
+
+	rt_latency_stats_send_metric(ctx, HRPN_LATENCY_METRIC_IRQ_DELAY, &ctx->stats.irq_delay_hist);
+	rt_latency_hist_send(ctx, HRPN_LATENCY_METRIC_IRQ_DELAY, &ctx->stats.irq_delay_hist);
+
+	rt_latency_stats_send_metric(ctx, HRPN_LATENCY_METRIC_IRQ_TO_SCHED, &ctx->stats.irq_to_sched_hist);
+	rt_latency_hist_send(ctx, HRPN_LATENCY_METRIC_IRQ_TO_SCHED, &ctx->stats.irq_to_sched_hist);
+}
+
+static void hist_print(struct hdr_hist *h)
+{
+	log_info("%s histogram: %llu samples, min %u max %u\n", h->name,
+		 (unsigned long long)h->total, h->total ? h->min : 0, h->max);
+
+	if (!h->total)
+		return;
+
+	log_info("  p50 %u p99 %u p99.9 %u p99.99 %u p99.999 %u p99.9999 %u\n",
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P50),
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99),
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_9),
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_99),
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_999),
+		 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_9999));
+}
+
+static void stats_print(rt_latency_stats_t *stats, unsigned int mode)
+{
+	int i;
+
+	rtos_apps_stats_compute(&stats->irq_delay);
+	rtos_apps_stats_print(&stats->irq_delay);
+	hist_print(&stats->irq_delay_hist);
+
+	rtos_apps_stats_compute(&stats->irq_to_sched);
+	rtos_apps_stats_print(&stats->irq_to_sched);
+	hist_print(&stats->irq_to_sched_hist);
+	log_info("late alarm scheduling: %u\n", stats->late_alarm_sched);
+
+	if (stats->phase_hist[RT_LATENCY_PHASE_HW_ENTRY].total) {
+		log_info("latency breakdown:\n");
+		for (i = 0; i < RT_LATENCY_PHASE_MAX; i++) {
+			rtos_apps_stats_compute(&stats->phase[i]);
+			rtos_apps_stats_print(&stats->phase[i]);
+			hist_print(&stats->phase_hist[i]);
+		}
+	}
+
+	if (mode == HRPN_LATENCY_MODE_PERIODIC) {
+		rtos_apps_stats_compute(&stats->wakeup_jitter);
+		rtos_apps_stats_print(&stats->wakeup_jitter);
+		log_info("accumulated drift (ns): %lld\n", (long long)stats->drift);
+		log_info("missed deadlines: %u\n", stats->missed_deadlines);
+	}
+}
+
+static void wakeup_print(struct rt_latency_wakeup_stats *stats)
+{
+	int i;
+
+	log_info("wake-up matrix:\n");
+
+	for (i = 0; i < RT_LATENCY_WAKEUP_MAX; i++) {
+		if (stats[i].isr_to_task_hist.total) {
+			rtos_apps_stats_compute(&stats[i].isr_to_task);
+			rtos_apps_stats_print(&stats[i].isr_to_task);
+			hist_print(&stats[i].isr_to_task_hist);
+		}
+
+		if (stats[i].task_to_task_hist.total) {
+			rtos_apps_stats_compute(&stats[i].task_to_task);
+			rtos_apps_stats_print(&stats[i].task_to_task);
+			hist_print(&stats[i].task_to_task_hist);
+		}
+	}
+}
+
+static void sched_print(struct rt_latency_sched *s)
+{
+	int i;
+
+	log_info("scheduling costs:\n");
+
+	for (i = 0; i < RT_LATENCY_SCHED_MAX; i++) {
+		rtos_apps_stats_compute(&s->snapshot[i].stats);
+		rtos_apps_stats_print(&s->snapshot[i].stats);
+		hist_print(&s->snapshot[i].hist);
+	}
+
+	log_info("priority inheritance failures: %u, measurements dropped: %u\n", s->pi_failures, s->dropped);
+}
+
+static int gain_percent(uint32_t ddr, uint32_t ocram)
+{
+	if (!ddr)
+		return 0;
+
+	return (int)(((int64_t)ddr - ocram) * 100 / ddr);
+}
+
+/*
+ * Code and data placed in OCRAM for the OCRAM test case, the rest stays in
+ * DDR: only the measurement code inlined from rt_latency_hot.h is copied, the
+ * functions it calls (statistics update, semaphore give, counter driver and
+ * IRQ dispatcher, unless OS_OCRAM_HOT_PATH) are shared with the DDR copy.
+ */
+static const char *rt_latency_ocram_placement =
+#if !defined(FSL_RTOS_FREE_RTOS)
+	"statistics only (no code relocation on Zephyr)";
+#elif defined(OS_OCRAM_HOT_PATH)
+	"inlined measurement code and statistics, IRQ dispatcher and counter driver (all test cases);"
+	" statistics update and semaphore give in DDR";
+#else
+	"inlined measurement code and statistics;"
+	" statistics update, semaphore give, counter driver and IRQ dispatcher in DDR";
+#endif
+
+/* Latency reduction of the OCRAM placement, positive when OCRAM is faster */
+static void ocram_gain_print(struct hdr_hist *ddr, struct hdr_hist *ocram)
+{
+	uint32_t ddr_p50, ddr_p99_99, ocram_p50, ocram_p99_99;
+
+	if (!ddr->total || !ocram->total)
+		return;
+
+	ddr_p50 = hdr_hist_value_at_ppm(ddr, HDR_HIST_PPM_P50);
+	ocram_p50 = hdr_hist_value_at_ppm(ocram, HDR_HIST_PPM_P50);
+	ddr_p99_99 = hdr_hist_value_at_ppm(ddr, HDR_HIST_PPM_P99_99);
+	ocram_p99_99 = hdr_hist_value_at_ppm(ocram, HDR_HIST_PPM_P99_99);
+
+	log_info("%s OCRAM gain: p50 %d (%d%%) p99.99 %d (%d%%) max %d (%d%%)\n", ddr->name,
+		 (int)(ddr_p50 - ocram_p50), gain_percent(ddr_p50, ocram_p50),
+		 (int)(ddr_p99_99 - ocram_p99_99), gain_percent(ddr_p99_99, ocram_p99_99),
+		 (int)(ddr->max - ocram->max), gain_percent(ddr->max, ocram->max));
+}
+
+/* irq delay increase of the storm windows, over the baseline windows */
+static void storm_print(struct rt_latency_storm *storm)
+{
+	struct hdr_hist *off = storm->irq_delay_off_snapshot;
+	struct hdr_hist *on = storm->irq_delay_on_snapshot;
+	struct rt_latency_storm_source *src;
+	unsigned int i;
+
+	log_info("interrupt storm:\n");
+
+	for (i = 0; i < storm->count; i++) {
+		src = &storm->src[i];
+
+		log_info("source %u: period %u us, duration %u us, priority %u, %u nested: %u irqs, %u overruns\n",
+			 i, src->period_us, src->duration_us, src->prio, src->nest,
+			 storm->fired_snapshot[i], storm->overruns_snapshot[i]);
+	}
+
+	hist_print(off);
+	hist_print(on);
+
+	if (!off->total || !on->total)
+		return;
+
+	log_info("irq delay storm shift: p50 %+d p99.99 %+d max %+d\n",
+		 (int)(hdr_hist_value_at_ppm(on, HDR_HIST_PPM_P50) - hdr_hist_value_at_ppm(off, HDR_HIST_PPM_P50)),
+		 (int)(hdr_hist_value_at_ppm(on, HDR_HIST_PPM_P99_99) - hdr_hist_value_at_ppm(off, HDR_HIST_PPM_P99_99)),
+		 (int)(on->max - off->max));
+}
+
+void print_stats(struct rt_latency_ctx *ctx)
+{
+	if (ctx->stats_snapshot.pending) {
+		if (RT_LATENCY_CPUS_MAX > 1)
+			log_info("core %u:\n", ctx->core);
+
+		if (ctx->linux_load[0])
+			log_info("Linux load: %s\n", ctx->linux_load);
+
+		if (ctx->tc_load & RT_LATENCY_WITH_MEM_LOAD)
+			log_info("memory load: %u bytes footprint, %u bytes stride, %s\n", ctx->mem_size,
+				 ctx->mem_stride, rt_latency_mem_pattern_name[ctx->mem_pattern]);
+
+		if (ctx->sched.enabled) {
+			sched_print(&ctx->sched);
+		} else if (ctx->tc_load & RT_LATENCY_USES_OCRAM) {
+			log_info("in OCRAM: %s\n", rt_latency_ocram_placement);
+
+			log_info("measurement code in DDR:\n");
+			stats_print(&ctx->stats_snapshot, ctx->mode);
+
+			log_info("measurement code in OCRAM:\n");
+			stats_print(ctx->ocram_stats_snapshot, ctx->mode);
+
+			ocram_gain_print(&ctx->stats_snapshot.irq_delay_hist,
+					 &ctx->ocram_stats_snapshot->irq_delay_hist);
+			ocram_gain_print(&ctx->stats_snapshot.irq_to_sched_hist,
+					 &ctx->ocram_stats_snapshot->irq_to_sched_hist);
+		} else {
+			stats_print(&ctx->stats_snapshot, ctx->mode);
+		}
+
+		if (ctx->wakeup.enabled)
+			wakeup_print(ctx->wakeup.snapshot);
+
+		if (ctx->storm.count)
+			storm_print(&ctx->storm);
+
+		log_info("\n");
+
+		ctx->stats_snapshot.pending = false;
+	}
+}
 
-		counter_period_us = COUNTER_PERIOD_US_VAL;
-		ticks = os_counter_us_to_ticks(dev, counter_period_us);
+/*
+ * Aggregate of the per-core histograms of the latest snapshots (histograms
+ * accumulate over the whole test case), with a per-core summary to spot the
+ * cores suffering from cross-core interference.
+ */
+void print_stats_aggregate(struct rt_latency_ctx *ctx, unsigned int count)
+{
+	static struct hdr_hist irq_delay, irq_to_sched;
+	uint32_t late_alarm_sched = 0;
+	struct hdr_hist *h;
+	unsigned int i;
+
+	hdr_hist_init(&irq_delay, "irq delay (ns)", ctx[0].stats_snapshot.irq_delay_hist.sub_bits);
+	hdr_hist_init(&irq_to_sched, "irq to sched (ns)", ctx[0].stats_snapshot.irq_to_sched_hist.sub_bits);
+
+	for (i = 0; i < count; i++) {
+		hdr_hist_merge(&irq_delay, &ctx[i].stats_snapshot.irq_delay_hist);
+		hdr_hist_merge(&irq_to_sched, &ctx[i].stats_snapshot.irq_to_sched_hist);
+		late_alarm_sched += ctx[i].stats_snapshot.late_alarm_sched;
 	}
 
-	/* Start IRQ latency testing alarm */
-	os_counter_start(dev);
+	log_info("all cores:\n");
+	hist_print(&irq_delay);
+	hist_print(&irq_to_sched);
+	log_info("late alarm scheduling: %u\n", late_alarm_sched);
 
-	/* Start IRQ load alarm, if need be */
-	if (ctx->tc_load & RT_LATENCY_WITH_IRQ_LOAD) {
-		os_counter_start(ctx->irq_load_dev);
-		cnt = COUNTER_PERIOD_US_VAL - 1;
-		load_alarm_cfg.ticks = os_counter_us_to_ticks(ctx->irq_load_dev, cnt);
-		load_alarm_cfg.flags = 0;
-		load_alarm_cfg.user_data = ctx;
-		load_alarm_cfg.callback = load_alarm_handler;
-
-		err = os_counter_set_channel_alarm(ctx->irq_load_dev, 0, &load_alarm_cfg);
-		rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
-		err = rtos_sem_init(&ctx->irq_load_sem, 0);
-		rtos_assert(!err, "semaphore init failed!");
+	for (i = 0; i < count; i++) {
+		h = &ctx[i].stats_snapshot.irq_to_sched_hist;
+
+		log_info("core %u irq to sched: p50 %u p99.99 %u max %u\n", ctx[i].core,
+			 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P50),
+			 hdr_hist_value_at_ppm(h, HDR_HIST_PPM_P99_99), h->max);
 	}
 
-retry:
-	/* Configure IRQ latency testing alarm */
-	os_counter_get_value(dev, &cnt);
-	alarm_cfg.ticks = cnt + ticks;
-	alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
-	alarm_cfg.user_data = ctx;
-	alarm_cfg.callback = latency_alarm_handler;
+	log_info("\n");
+}
 
-	ctx->time_prog = alarm_cfg.ticks;
+/*
+ * Multi-core test case: print the statistics of each core, then their
+ * aggregate, once all the benchmark tasks dumped a new snapshot.
+ */
+void print_stats_cores(struct rt_latency_ctx *ctx, unsigned int count)
+{
+	unsigned int i;
 
-	err = os_counter_set_channel_alarm(dev, 0, &alarm_cfg);
-	rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+	for (i = 0; i < count; i++)
+		if (!ctx[i].stats_snapshot.pending)
+			return;
 
-	/* Sync current thread with alarm callback function thanks to a semaphore */
-	err = rtos_sem_take(&ctx->semaphore, RTOS_MS_TO_TICKS(COUNTER_IRQ_TIMEOUT_MS));
-	if (err < 0) {
-		/* waiting period timed out: probably late alarm scheduling and waiting for counter wrap. */
-		os_counter_cancel_channel_alarm(dev, 0);
-		/* There is a small race window between cancel alarm and alarm callback
-		 * giving the semaphore. But the difference between the small timeout
-		 * and the time for timer (few minutes at 24Mhz) to wrap covers that.
-		 */
-		ctx->stats.late_alarm_sched++;
-		goto retry;
-	}
-
-	/* Woken up... fetch counter value to compute latency */
-	os_counter_get_value(dev, &now);
-	os_counter_stop(dev);
+	for (i = 0; i < count; i++)
+		print_stats(&ctx[i]);
 
-	irq_delay = calc_diff_ns(dev, ctx->time_prog, ctx->time_irq);
+	if (count > 1)
+		print_stats_aggregate(ctx, count);
+}
 
-	rtos_apps_stats_update(&ctx->stats.irq_delay, irq_delay);
-	rtos_apps_hist_update(&ctx->stats.irq_delay_hist, irq_delay);
+static void rt_latency_free(struct rt_latency_ctx *ctx)
+{
+	if (ctx->capture.ring) {
+		rtos_free(ctx->capture.ring);
+		ctx->capture.ring = NULL;
+	}
 
-	irq_to_sched = calc_diff_ns(dev, ctx->time_prog, now);
-	rtos_apps_stats_update(&ctx->stats.irq_to_sched, irq_to_sched);
-	rtos_apps_hist_update(&ctx->stats.irq_to_sched_hist, irq_to_sched);
+	if (ctx->ocram_stats_snapshot) {
+		rtos_free(ctx->ocram_stats_snapshot);
+		ctx->ocram_stats_snapshot = NULL;
+	}
 
-	if (!ctx->quiet) {
-		/* Dump statistics every TIMER_STATS_PERIOD_SEC seconds */
-		if (!(++stats_cnt % LATENCY_STATS_PERIOD))
-			rt_latency_stats_dump(ctx);
+	if (ctx->wakeup.stats) {
+		rtos_free(ctx->wakeup.stats);
+		ctx->wakeup.stats = NULL;
+		ctx->wakeup.snapshot = NULL;
 	}
 
-	if (ctx->tc_load & RT_LATENCY_WITH_IRQ_LOAD) {
-		/* Waiting irq load ISR exits and then go to next loop */
-		err = rtos_sem_take(&ctx->irq_load_sem, RTOS_WAIT_FOREVER);
-		rtos_assert(!err, "Can't take the semaphore (err: %d)", err);
+	if (ctx->storm.irq_delay_off) {
+		rtos_free(ctx->storm.irq_delay_off);
+		ctx->storm.irq_delay_off = NULL;
+		ctx->storm.irq_delay_on = NULL;
+		ctx->storm.irq_delay_off_snapshot = NULL;
+		ctx->storm.irq_delay_on_snapshot = NULL;
 	}
 
-	return err;
+	if (ctx->sched.stats) {
+		rtos_free(ctx->sched.stats);
+		ctx->sched.stats = NULL;
+		ctx->sched.snapshot = NULL;
+	}
 }
 
-void cpu_load(struct rt_latency_ctx *ctx)
+/* Storage of the optional features, allocated only when they are enabled */
+static int rt_latency_alloc(struct rt_latency_ctx *ctx, struct rt_latency_cfg *cfg)
 {
-	int err;
+	ctx->capture.ring = NULL;
+	ctx->ocram_stats_snapshot = NULL;
+	ctx->wakeup.stats = NULL;
+	ctx->storm.irq_delay_off = NULL;
+	ctx->sched.stats = NULL;
+
+	if (cfg->capture_ept) {
+		ctx->capture.ring = rtos_malloc(RT_LATENCY_CAPTURE_RING_SIZE * sizeof(struct hrpn_latency_sample));
+		if (!ctx->capture.ring) {
+			log_err("capture ring allocation failed\n");
+			goto err;
+		}
+	}
 
-	if (ctx->tc_load & RT_LATENCY_WITH_CPU_LOAD_SEM) {
-		err = rtos_sem_take(&ctx->cpu_load_sem, RTOS_WAIT_FOREVER);
-		rtos_assert(!err, "Failed to take semaphore");
+	if (cfg->load & RT_LATENCY_USES_OCRAM) {
+		ctx->ocram_stats_snapshot = rtos_malloc(sizeof(rt_latency_stats_t));
+		if (!ctx->ocram_stats_snapshot) {
+			log_err("OCRAM statistics snapshot allocation failed\n");
+			goto err;
+		}
+	}
 
-		err = rtos_sem_give(&ctx->cpu_load_sem);
-		rtos_assert(!err, "Failed to give semaphore");
+	/* current and snapshot statistics */
+	if (cfg->wakeup_matrix) {
+		ctx->wakeup.stats = rtos_malloc(2 * RT_LATENCY_WAKEUP_MAX * sizeof(struct rt_latency_wakeup_stats));
+		if (!ctx->wakeup.stats) {
+			log_err("wake-up matrix statistics allocation failed\n");
+			goto err;
+		}
+
+		ctx->wakeup.snapshot = &ctx->wakeup.stats[RT_LATENCY_WAKEUP_MAX];
 	}
-}
 
-void cache_inval(void)
-{
-	os_dcache_invd_all();
-	os_icache_invd_all();
+	/* storm off and on windows, and their snapshot */
+	if (cfg->irq_storm_count) {
+		ctx->storm.irq_delay_off = rtos_malloc(4 * sizeof(struct hdr_hist));
+		if (!ctx->storm.irq_delay_off) {
+			log_err("interrupt storm histograms allocation failed\n");
+			goto err;
+		}
 
-	rtos_sleep(RTOS_MS_TO_TICKS(CACHE_INVAL_PERIOD_MS));
-}
+		ctx->storm.irq_delay_on = &ctx->storm.irq_delay_off[1];
+		ctx->storm.irq_delay_off_snapshot = &ctx->storm.irq_delay_off[2];
+		ctx->storm.irq_delay_on_snapshot = &ctx->storm.irq_delay_off[3];
+	}
 
-void print_stats(struct rt_latency_ctx *ctx)
-{
-	if (ctx->stats_snapshot.pending) {
-		rtos_apps_stats_compute(&ctx->stats_snapshot.irq_delay);
-		rtos_apps_stats_print(&ctx->stats_snapshot.irq_delay);
-		rtos_apps_hist_print(&ctx->stats_snapshot.irq_delay_hist);
-
-		rtos_apps_stats_compute(&ctx->stats_snapshot.irq_to_sched);
-		rtos_apps_stats_print(&ctx->stats_snapshot.irq_to_sched);
-		rtos_apps_hist_print(&ctx->stats_snapshot.irq_to_sched_hist);
-		log_info("late alarm scheduling: %u\n", ctx->stats_snapshot.late_alarm_sched);
-		log_info("\n");
+	/* current and snapshot statistics */
+	if (cfg->mode == HRPN_LATENCY_MODE_SCHED) {
+		ctx->sched.stats = rtos_malloc(2 * RT_LATENCY_SCHED_MAX * sizeof(struct rt_latency_sched_stats));
+		if (!ctx->sched.stats) {
+			log_err("scheduling benchmark statistics allocation failed\n");
+			goto err;
+		}
 
-		ctx->stats_snapshot.pending = false;
+		ctx->sched.snapshot = &ctx->sched.stats[RT_LATENCY_SCHED_MAX];
 	}
+
+	return 0;
+
+err:
+#if !defined(FSL_RTOS_FREE_RTOS)
+	log_err("heap sized for the features selected in the application Kconfig (CONFIG_RT_LATENCY_xxx)\n");
+#endif
+	rt_latency_free(ctx);
+
+	return -1;
 }
 
 void rt_latency_destroy(struct rt_latency_ctx *ctx)
 {
-	int err;
+	int err, i;
 	os_counter_t *dev = ctx->dev;
 
 	if (ctx->tc_load & RT_LATENCY_WITH_CPU_LOAD) {
@@ -259,7 +1676,10 @@ void rt_latency_destroy(struct rt_latency_ctx *ctx)
 		err = os_counter_cancel_channel_alarm(ctx->irq_load_dev, 0);
 		rtos_assert(!err, "Failed to cancel counter alarm!");
 
-		rtos_sem_destroy(&ctx->irq_load_sem);
+		if (!ctx->irq_load_period_ticks)
+			rtos_sem_destroy(&ctx->irq_load_sem);
+
+		ctx->irq_load_started = false;
 	}
 
 	err = os_counter_stop(dev);
@@ -268,41 +1688,267 @@ void rt_latency_destroy(struct rt_latency_ctx *ctx)
 	err = os_counter_cancel_channel_alarm(dev, 0);
 	rtos_assert(!err, "Failed to cancel counter alarm!");
 
+	if (ctx->storm.count)
+		rt_latency_storm_stop(ctx);
+
 	rtos_sem_destroy(&ctx->semaphore);
 
+	if (ctx->wakeup.enabled) {
+		rtos_sem_destroy(&ctx->wakeup.peer_start);
+		rtos_sem_destroy(&ctx->wakeup.peer_ready);
+		rtos_sem_destroy(&ctx->wakeup.peer_done);
+		rtos_sem_destroy(&ctx->wakeup.sem);
+	}
+
+	if (ctx->sched.enabled) {
+		for (i = 0; i < RT_LATENCY_SCHED_PEER_MAX; i++)
+			rtos_sem_destroy(&ctx->sched.start[i]);
+
+		rtos_sem_destroy(&ctx->sched.done);
+		rtos_sem_destroy(&ctx->sched.locked);
+		rtos_sem_destroy(&ctx->sched.unlock);
+	}
+
+	/* flush the samples still in the capture ring */
+	rt_latency_capture_send(ctx);
+	if (ctx->capture.dropped)
+		log_warn("capture: %u samples dropped\n", ctx->capture.dropped);
+
+	ctx->capture.ept = NULL;
+
+	rt_latency_trace_send(ctx);
+	if (ctx->trace.ept)
+		log_info("outlier tracer: %u traces sent, %u outliers not traced\n",
+			 ctx->trace.seq, ctx->trace.missed);
+
+	ctx->trace.ept = NULL;
+	os_trace_freeze();
+
 	/* dump and print current stats before reseting them all */
 	rt_latency_stats_dump(ctx);
 	print_stats(ctx);
 
-	rtos_apps_stats_reset(&ctx->stats.irq_delay);
-	rtos_apps_hist_reset(&ctx->stats.irq_delay_hist);
+	rt_latency_stats_send(ctx);
+	ctx->stats_ept = NULL;
+
+	if (ctx->soak) {
+		rt_latency_soak_flush(ctx);
+		ctx->soak = NULL;
+	}
+
+	rt_latency_stats_reset(&ctx->stats);
+
+	if (ctx->tc_load & RT_LATENCY_USES_OCRAM)
+		rt_latency_stats_reset(ctx->ocram_stats);
+
+	ctx->storm.count = 0;
+
+	ctx->wakeup.enabled = false;
+	ctx->wakeup.prim = RT_LATENCY_WAKEUP_SEM;
 
-	rtos_apps_stats_reset(&ctx->stats.irq_to_sched);
-	rtos_apps_hist_reset(&ctx->stats.irq_to_sched_hist);
+	ctx->sched.enabled = false;
 
-	ctx->stats.late_alarm_sched = 0;
+	ctx->timeline_started = false;
+	ctx->wakeup_valid = false;
+	ctx->done = false;
 
 	ctx->dev = NULL;
 	ctx->irq_load_dev = NULL;
+
+	rt_latency_free(ctx);
 }
 
-int rt_latency_init(os_counter_t *dev,
-		os_counter_t *irq_load_dev, struct rt_latency_ctx *ctx)
+static int rt_latency_wakeup_init(struct rt_latency_wakeup *w, unsigned int hist_sub_bits)
 {
 	int err;
 
-	ctx->dev = dev;
-	ctx->irq_load_dev = irq_load_dev;
+	if (!w->resources) {
+		err = rtos_mutex_init(&w->mutex);
+		rtos_assert(!err, "mutex init failed!");
+
+		w->isr_mqueue = rtos_mqueue_alloc_init(2, sizeof(uint32_t));
+		w->mqueue = rtos_mqueue_alloc_init(1, sizeof(uint32_t));
+		if (!w->isr_mqueue || !w->mqueue) {
+			log_err("message queue allocation failed\n");
+			return -1;
+		}
+
+		w->resources = true;
+	}
+
+	err = rtos_sem_init(&w->peer_start, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	err = rtos_sem_init(&w->peer_ready, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	err = rtos_sem_init(&w->peer_done, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	err = rtos_sem_init(&w->sem, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	/* bound to the benchmark and peer tasks when they start */
+	w->isr_notify_bound = false;
+	w->notify_bound = false;
+
+	rt_latency_wakeup_stats_init(w->stats, hist_sub_bits);
+	rt_latency_wakeup_stats_init(w->snapshot, hist_sub_bits);
+
+	return 0;
+}
+
+/*
+ * The benchmark task and its peers are all blocked between two iterations,
+ * the mutex is never held when the test case is destroyed.
+ */
+static int rt_latency_sched_init(struct rt_latency_sched *s, unsigned int hist_sub_bits)
+{
+	int err, i;
+
+	if (!s->resources) {
+		err = rtos_mutex_init(&s->mutex);
+		rtos_assert(!err, "mutex init failed!");
+
+		s->resources = true;
+	}
+
+	for (i = 0; i < RT_LATENCY_SCHED_PEER_MAX; i++) {
+		err = rtos_sem_init(&s->start[i], 0);
+		rtos_assert(!err, "semaphore init failed!");
+	}
+
+	err = rtos_sem_init(&s->done, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	err = rtos_sem_init(&s->locked, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	err = rtos_sem_init(&s->unlock, 0);
+	rtos_assert(!err, "semaphore init failed!");
+
+	s->test = RT_LATENCY_SCHED_SWITCH;
+	s->ts = 0;
+	s->t0 = 0;
+	s->pi_failures = 0;
+	s->dropped = 0;
+
+	rt_latency_sched_stats_init(s->stats, hist_sub_bits);
+	rt_latency_sched_stats_init(s->snapshot, hist_sub_bits);
+
+	return 0;
+}
+
+int rt_latency_init(os_counter_t *dev, os_counter_t *irq_load_dev,
+		struct rt_latency_cfg *cfg, struct rt_latency_ctx *ctx)
+{
+	int err;
+
+	/* keep a safe margin with the counter wrap, for late alarm detection */
+	if (os_counter_us_to_ticks(dev, cfg->period_us) >= os_counter_get_top_value(dev) / 2) {
+		log_err("period %u us too long for the counter\n", cfg->period_us);
+		return -1;
+	}
+
+	if (cfg->load & RT_LATENCY_USES_OCRAM) {
+		ctx->ocram_stats = rt_latency_ocram_stats_get();
+		if (!ctx->ocram_stats) {
+			log_err("OCRAM not available\n");
+			return -1;
+		}
+	}
+
+	if (rt_latency_alloc(ctx, cfg) < 0)
+		return -1;
+
+	ctx->tc_load = cfg->load;
+	ctx->quiet = cfg->quiet;
+	ctx->core = cfg->core;
+	ctx->mode = cfg->mode;
+
+	ctx->period_us = cfg->period_us;
+	ctx->period_ticks = os_counter_us_to_ticks(dev, cfg->period_us);
+	ctx->period_ns = os_counter_ticks_to_ns(dev, ctx->period_ticks);
+
+	ctx->stats_period = LATENCY_STATS_PERIOD_SEC * 1000000 / cfg->period_us;
+	ctx->iterations = 0;
 
-	rtos_apps_stats_init(&ctx->stats.irq_delay, 31, "irq delay (ns)", NULL);
-	rtos_apps_hist_init(&ctx->stats.irq_delay_hist, 20, 1000);
+	ctx->duration_ns = (uint64_t)cfg->duration_s * 1000000000;
+	ctx->elapsed_ns = 0;
+	ctx->done = false;
 
-	rtos_apps_stats_init(&ctx->stats.irq_to_sched, 31, "irq to sched (ns)", NULL);
-	rtos_apps_hist_init(&ctx->stats.irq_to_sched_hist, 20, 1000);
+	ctx->irq_load_duration_ns = cfg->irq_load_duration_us * 1000;
+	ctx->irq_load_period_ticks = 0;
+	if (cfg->irq_load_period_us)
+		ctx->irq_load_period_ticks = os_counter_us_to_ticks(irq_load_dev, cfg->irq_load_period_us);
+	ctx->irq_load_started = false;
 
+	ctx->ts_irq_entry = 0;
+	ctx->ts_frequency = os_trace_frequency();
+
+	ctx->capture.ept = cfg->capture_ept;
+	ctx->capture.frequency = os_counter_us_to_ticks(dev, 1000000);
+	ctx->capture.head = 0;
+	ctx->capture.tail = 0;
+	ctx->capture.dropped = 0;
+	ctx->capture.seq = 0;
+
+	ctx->stats_ept = cfg->stats_ept;
+
+	err = rt_latency_soak_init(ctx, cfg);
+	if (err)
+		goto err_free;
+
+	ctx->trace.ept = cfg->trace_ept;
+	ctx->trace.threshold_ns = (uint64_t)cfg->trace_threshold_us * 1000;
+	ctx->trace.seq = 0;
+	ctx->trace.missed = 0;
+	ctx->trace.pending = false;
+
+	rt_latency_stats_init(&ctx->stats, cfg->hist_sub_bits);
+	rt_latency_stats_init(&ctx->stats_snapshot, cfg->hist_sub_bits);
 	ctx->stats_snapshot.pending = false;
 
-	ctx->stats.late_alarm_sched = 0;
+	ctx->ocram_window = false;
+	if (ctx->tc_load & RT_LATENCY_USES_OCRAM) {
+		rt_latency_stats_init(ctx->ocram_stats, cfg->hist_sub_bits);
+		rt_latency_stats_init(ctx->ocram_stats_snapshot, cfg->hist_sub_bits);
+	}
+
+	ctx->timeline_started = false;
+	ctx->wakeup_valid = false;
+
+	rt_latency_storm_init(&ctx->storm, irq_load_dev, cfg);
+	if (ctx->storm.count) {
+		hdr_hist_init(ctx->storm.irq_delay_off, "irq delay, storm off (ns)", cfg->hist_sub_bits);
+		hdr_hist_init(ctx->storm.irq_delay_on, "irq delay, storm on (ns)", cfg->hist_sub_bits);
+		hdr_hist_init(ctx->storm.irq_delay_off_snapshot, "irq delay, storm off (ns)", cfg->hist_sub_bits);
+		hdr_hist_init(ctx->storm.irq_delay_on_snapshot, "irq delay, storm on (ns)", cfg->hist_sub_bits);
+	}
+
+	ctx->wakeup.prim = RT_LATENCY_WAKEUP_SEM;
+	ctx->wakeup.enabled = cfg->wakeup_matrix;
+	if (ctx->wakeup.enabled) {
+		err = rt_latency_wakeup_init(&ctx->wakeup, cfg->hist_sub_bits);
+		if (err)
+			goto err_soak;
+
+		log_info("Wake-up matrix: semaphore, message queue, %s and mutex, %u iterations each\n",
+			 OS_NOTIFY_NAME, RT_LATENCY_WAKEUP_WINDOW);
+	}
+
+	ctx->sched.enabled = (cfg->mode == HRPN_LATENCY_MODE_SCHED);
+	if (ctx->sched.enabled) {
+		err = rt_latency_sched_init(&ctx->sched, cfg->hist_sub_bits);
+		if (err)
+			goto err_wakeup;
+
+		/* one iteration per pause */
+		ctx->stats_period = LATENCY_STATS_PERIOD_SEC * 1000 / RT_LATENCY_SCHED_PAUSE_MS;
+
+		log_info("Scheduling benchmark: task switch, preemption, yield and mutex hand-over, %u iterations each\n",
+			 RT_LATENCY_SCHED_WINDOW);
+	}
 
 	err = rtos_sem_init(&ctx->semaphore, 0);
 	rtos_assert(!err, "semaphore creation failed!");
@@ -312,74 +1958,456 @@ int rt_latency_init(os_counter_t *dev,
 		rtos_assert(!err, "semaphore init failed!");
 	}
 
-	if (ctx->tc_load & RT_LATENCY_WITH_LINUX_LOAD) {
-		/* TODO: Add command to trigger Linux Load */
-		log_warn("Linux load must be run manually!\n");
+	if ((ctx->tc_load & RT_LATENCY_WITH_IRQ_LOAD) && !ctx->irq_load_period_ticks) {
+		err = rtos_sem_init(&ctx->irq_load_sem, 0);
+		rtos_assert(!err, "semaphore init failed!");
 	}
 
-	if (ctx->tc_load & RT_LATENCY_USES_OCRAM) {
-		/* TODO: Place specific code/data in OCRAM */
-		log_warn("not supported\n");
+	ctx->mem_size = cfg->mem_size;
+	ctx->mem_stride = cfg->mem_stride;
+	ctx->mem_pattern = cfg->mem_pattern;
+	if (ctx->tc_load & RT_LATENCY_WITH_MEM_LOAD)
+		log_info("Memory load: %u bytes footprint per load core, %u bytes stride, %s\n",
+			 ctx->mem_size, ctx->mem_stride, rt_latency_mem_pattern_name[ctx->mem_pattern]);
+
+	memcpy(ctx->linux_load, cfg->linux_load, sizeof(ctx->linux_load));
+	if (ctx->linux_load[0])
+		log_info("Linux load profile: %s\n", ctx->linux_load);
+	else if (ctx->tc_load & RT_LATENCY_WITH_LINUX_LOAD)
+		log_warn("Linux load must be run manually (or with harpoon_ctrl latency -L)!\n");
+
+	if (ctx->trace.ept) {
+		os_trace_restart();
+		log_info("Outlier tracer: irq delay threshold %u us\n", cfg->trace_threshold_us);
+	}
+
+	/* test case initialized, seen by the control task */
+	ctx->irq_load_dev = irq_load_dev;
+	ctx->dev = dev;
+
+	return 0;
+
+err_wakeup:
+	if (ctx->wakeup.enabled) {
+		rtos_sem_destroy(&ctx->wakeup.peer_start);
+		rtos_sem_destroy(&ctx->wakeup.peer_ready);
+		rtos_sem_destroy(&ctx->wakeup.peer_done);
+		rtos_sem_destroy(&ctx->wakeup.sem);
+		ctx->wakeup.enabled = false;
 	}
 
+err_soak:
+	ctx->soak = NULL;
+
+err_free:
+	rt_latency_free(ctx);
+
 	return err;
 }
 
-static void response(struct rpmsg_ept *ept, uint32_t status)
+static void response(struct rpmsg_ept *ept, uint32_t type, uint32_t req_id, uint32_t status)
 {
 	struct hrpn_resp_latency resp;
 
-	resp.type = HRPN_RESP_TYPE_LATENCY;
+	resp.type = HRPN_TYPE_REQ(type, req_id);
 	resp.status = status;
 	rpmsg_send(ept, &resp, sizeof(resp));
 }
 
+/*
+ * Interrupt storm sources: each nesting level takes one SGI and one priority
+ * level above the previous one. The storm runs on the IRQ load counter.
+ */
+static int rt_latency_storm_cfg_init(struct rt_latency_cfg *cfg, struct hrpn_cmd_latency_run *run)
+{
+	struct hrpn_latency_irq_source *src;
+	unsigned int i, levels = 0;
+
+	if (run->irq_storm_count > HRPN_LATENCY_IRQ_STORM_SOURCES_MAX)
+		return -1;
+
+	if (run->irq_storm_count && (cfg->load & RT_LATENCY_WITH_IRQ_LOAD))
+		return -1;
+
+	cfg->irq_storm_count = run->irq_storm_count;
+
+	for (i = 0; i < cfg->irq_storm_count; i++) {
+		src = &cfg->irq_storm[i];
+		*src = run->irq_storm[i];
+
+		if (!src->prio)
+			src->prio = RT_LATENCY_STORM_PRIO_DEFAULT;
+
+		/* nesting levels first, they bound the busy loop product below */
+		if ((src->nest >= RT_LATENCY_STORM_SGI_MAX) ||
+		    (src->prio < OS_IRQ_PRIO_MAX) || (src->prio > OS_IRQ_PRIO_MIN) ||
+		    (src->nest > src->prio - OS_IRQ_PRIO_MAX))
+			return -1;
+
+		/* all the nested handlers busy loop within one period */
+		if ((src->period_us < RT_LATENCY_PERIOD_US_MIN) || (src->period_us > RT_LATENCY_PERIOD_US_MAX) ||
+		    (src->duration_us >= src->period_us) ||
+		    ((uint64_t)src->duration_us * (src->nest + 1) >= src->period_us))
+			return -1;
+
+		levels += src->nest + 1;
+		if (levels > RT_LATENCY_STORM_SGI_MAX)
+			return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Build the test case configuration from the run command. Parameters left
+ * to 0 take their default value, the load of a predefined test case comes
+ * from the test case table.
+ */
+static int rt_latency_cfg_init(struct rt_latency_cfg *cfg,
+		struct hrpn_cmd_latency_run *run, struct rpmsg_ept *ept)
+{
+	if (run->id >= RT_LATENCY_TEST_CASE_MAX)
+		goto err;
+
+	if (run->id == RT_LATENCY_TEST_CASE_CUSTOM) {
+		if (run->load & ~HRPN_LATENCY_LOAD_ALL)
+			goto err;
+
+		cfg->load = run->load;
+	} else {
+		cfg->load = rt_latency_get_tc_load(run->id);
+		if (cfg->load < 0)
+			goto err;
+	}
+
+	if (run->mode > HRPN_LATENCY_MODE_SCHED)
+		goto err;
+
+	cfg->test_case_id = run->id;
+	cfg->quiet = run->quiet;
+	cfg->mode = run->mode;
+	cfg->capture_ept = run->capture ? ept : NULL;
+
+	cfg->period_us = run->period_us ? run->period_us : COUNTER_PERIOD_US_VAL;
+	cfg->irq_load_duration_us = run->irq_load_duration_us ? run->irq_load_duration_us : IRQ_LOAD_ISR_DURATION_US;
+	cfg->irq_load_period_us = run->irq_load_period_us;
+	cfg->hist_sub_bits = run->hist_sub_bits ? run->hist_sub_bits : HDR_HIST_SUB_BITS;
+	cfg->duration_s = run->duration_s;
+
+	memcpy(cfg->linux_load, run->linux_load, sizeof(cfg->linux_load));
+	cfg->linux_load[sizeof(cfg->linux_load) - 1] = '\0';
+
+	cfg->trace_threshold_us = run->trace_threshold_us;
+	cfg->trace_ept = run->trace_threshold_us ? ept : NULL;
+	cfg->wakeup_matrix = run->wakeup_matrix;
+	cfg->stats_ept = run->stats_report ? ept : NULL;
+	cfg->soak_window_s = run->soak_window_s;
+	cfg->mem_size = run->mem_size ? run->mem_size : RT_LATENCY_MEM_SIZE_DEFAULT;
+	cfg->mem_stride = run->mem_stride ? run->mem_stride : RT_LATENCY_MEM_STRIDE_DEFAULT;
+	cfg->mem_pattern = run->mem_pattern;
+
+	if (rt_latency_storm_cfg_init(cfg, run) < 0)
+		goto err;
+
+	cfg->cpu_mask = run->cpu_mask ? run->cpu_mask : 1;
+	cfg->load_cpu_mask = run->load_cpu_mask ? run->load_cpu_mask : cfg->cpu_mask;
+	cfg->core = __builtin_ctz(cfg->cpu_mask);
+
+	if ((cfg->cpu_mask | cfg->load_cpu_mask) & ~RT_LATENCY_CPU_MASK_ALL)
+		goto err;
+
+	/* single OCRAM statistics region */
+	if ((cfg->load & RT_LATENCY_USES_OCRAM) && (cfg->cpu_mask & (cfg->cpu_mask - 1)))
+		goto err;
+
+	if ((cfg->period_us < RT_LATENCY_PERIOD_US_MIN) || (cfg->period_us > RT_LATENCY_PERIOD_US_MAX))
+		goto err;
+
+	if ((cfg->hist_sub_bits < HDR_HIST_SUB_BITS_MIN) || (cfg->hist_sub_bits > HDR_HIST_SUB_BITS_MAX))
+		goto err;
+
+	if (cfg->soak_window_s > RT_LATENCY_SOAK_WINDOW_S_MAX)
+		goto err;
+
+#if !defined(OS_TRACE)
+	/* outlier tracer not built in (lib_trace) */
+	if (cfg->trace_ept)
+		goto err;
+#endif
+
+	/* memory load: word aligned accesses, within the slice of the load core */
+	if ((cfg->mem_size > RT_LATENCY_MEM_SLICE_SIZE) || (cfg->mem_stride % sizeof(uint32_t)) ||
+	    (cfg->mem_stride > cfg->mem_size) || (cfg->mem_pattern >= HRPN_LATENCY_MEM_PATTERN_MAX))
+		goto err;
+
+	/* the scheduling benchmark runs alone (no alarm), on a single core */
+	if ((cfg->mode == HRPN_LATENCY_MODE_SCHED) &&
+	    ((cfg->cpu_mask & (cfg->cpu_mask - 1)) || cfg->capture_ept || cfg->trace_ept ||
+	     cfg->wakeup_matrix || cfg->irq_storm_count || cfg->soak_window_s ||
+	     (cfg->load & (RT_LATENCY_WITH_IRQ_LOAD | RT_LATENCY_USES_OCRAM))))
+		goto err;
+
+	/* the IRQ load must leave some time to the rest of the system */
+	if (cfg->irq_load_period_us) {
+		if ((cfg->irq_load_period_us < RT_LATENCY_PERIOD_US_MIN) ||
+		    (cfg->irq_load_period_us > RT_LATENCY_PERIOD_US_MAX) ||
+		    (cfg->irq_load_duration_us >= cfg->irq_load_period_us))
+			goto err;
+	} else if (cfg->irq_load_duration_us >= cfg->period_us - 1) {
+		goto err;
+	}
+
+	return 0;
+
+err:
+	log_err("invalid test case parameters\n");
+	return -1;
+}
+
+/*
+ * Echo an IPC benchmark ping, with the RTOS side timestamps: latest mailbox
+ * interrupt (doorbell), reception by the task and transmission of the pong.
+ */
+static void rt_latency_ipc_pong(struct rpmsg_ept *ept, struct hrpn_cmd_latency_ping *ping,
+		unsigned int len, uint64_t ts_recv)
+{
+	struct hrpn_resp_latency_pong pong;
+
+	pong.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_LATENCY_PONG, HRPN_REQ_ID(ping->type));
+	pong.ts_mbox = gen_sw_mbox_rx_timestamp((void *)GEN_SW_MBOX_BASE);
+	pong.ts_recv = ts_recv;
+
+	if ((len < offsetof(struct hrpn_cmd_latency_ping, payload)) ||
+	    (ping->len > HRPN_LATENCY_PING_PAYLOAD_MAX) ||
+	    (len != offsetof(struct hrpn_cmd_latency_ping, payload) + ping->len)) {
+		pong.status = HRPN_RESP_STATUS_ERROR;
+		pong.seq = 0;
+		pong.len = 0;
+	} else {
+		pong.status = HRPN_RESP_STATUS_SUCCESS;
+		pong.seq = ping->seq;
+		pong.len = ping->len;
+		memcpy(pong.payload, ping->payload, ping->len);
+	}
+
+	pong.ts_send = os_trace_timestamp();
+	rpmsg_send(ept, &pong, offsetof(struct hrpn_resp_latency_pong, payload) + pong.len);
+}
+
+/*
+ * Soak mode ring read: up to HRPN_LATENCY_SOAK_ENTRIES_MAX windows from
+ * @cmd->seq, or from the oldest window still in the ring.
+ */
+static void rt_latency_soak_read(struct rpmsg_ept *ept, struct hrpn_cmd_latency_soak_read *cmd)
+{
+	struct rt_latency_soak *soak = rt_latency_soak;
+	struct hrpn_resp_latency_soak resp;
+	uint32_t seq = cmd->seq, oldest;
+
+	memset(&resp, 0, sizeof(resp));
+	resp.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_LATENCY_SOAK, HRPN_REQ_ID(cmd->type));
+	resp.status = HRPN_RESP_STATUS_SUCCESS;
+	resp.frequency = os_trace_frequency();
+
+	/* no soak mode test case ran (window_s is 0) */
+	if (!soak)
+		goto send;
+
+	oldest = soak->seq > RT_LATENCY_SOAK_RING_SIZE ? soak->seq - RT_LATENCY_SOAK_RING_SIZE : 0;
+	if (seq < oldest)
+		seq = oldest;
+
+	resp.window_s = soak->window_s;
+	resp.seq = seq;
+	resp.total = soak->seq;
+	resp.missed = soak->missed;
+	resp.start = soak->start;
+
+	for (resp.count = 0; (resp.count < HRPN_LATENCY_SOAK_ENTRIES_MAX) && (seq + resp.count < soak->seq); resp.count++)
+		resp.entries[resp.count] = soak->ring[(seq + resp.count) % RT_LATENCY_SOAK_RING_SIZE];
+
+send:
+	rpmsg_send(ept, &resp, sizeof(resp));
+}
+
+static void rt_latency_caps(struct rpmsg_ept *ept, uint32_t req_id)
+{
+	struct hrpn_resp_caps caps;
+
+	memset(&caps, 0, sizeof(caps));
+
+	caps.type = HRPN_TYPE_REQ(HRPN_RESP_TYPE_CAPS, req_id);
+	caps.status = HRPN_RESP_STATUS_SUCCESS;
+	caps.version = HRPN_CAPS_VERSION(VERSION_MAJOR, VERSION_MDIUM, VERSION_MINOR);
+	caps.features = HRPN_CAPS_FEATURE_REQ_ID | HRPN_CAPS_FEATURE_TELEMETRY | HRPN_CAPS_FEATURE_LATENCY;
+
+	/* same limits as rt_latency_cfg_init() */
+	caps.latency_test_cases = RT_LATENCY_TEST_CASE_MAX;
+	caps.latency_loads = HRPN_LATENCY_LOAD_ALL;
+	caps.latency_modes = HRPN_LATENCY_MODE_SCHED + 1;
+	caps.latency_period_us_min = RT_LATENCY_PERIOD_US_MIN;
+	caps.latency_period_us_max = RT_LATENCY_PERIOD_US_MAX;
+	caps.latency_cpu_mask = RT_LATENCY_CPU_MASK_ALL;
+	caps.latency_mem_size_max = RT_LATENCY_MEM_SLICE_SIZE;
+
+	rpmsg_send(ept, &caps, sizeof(caps));
+}
+
+/*
+ * Body of the IPC echo task: answers the pings received on the IPC endpoint,
+ * as soon as they are received (raw rpmsg round trip, not delayed by the
+ * control task polling).
+ */
+void rt_latency_ipc_echo(struct rpmsg_ept *ept)
+{
+	struct hrpn_command cmd;
+	uint64_t ts_recv;
+	uint32_t len;
+
+	len = sizeof(cmd);
+	if (rpmsg_recv_timeout(ept, &cmd, &len, RL_BLOCK) < 0)
+		return;
+
+	ts_recv = os_trace_timestamp();
+
+	if (HRPN_TYPE(cmd.u.cmd.type) == HRPN_CMD_TYPE_LATENCY_PING)
+		rt_latency_ipc_pong(ept, &cmd.u.latency_ping, len, ts_recv);
+	else
+		response(ept, HRPN_RESP_TYPE_LATENCY_PONG, HRPN_REQ_ID(cmd.u.cmd.type), HRPN_RESP_STATUS_ERROR);
+}
+
 void command_handler(void *ctx, struct rpmsg_ept *ept)
 {
 	struct hrpn_command cmd;
+	struct rt_latency_cfg cfg;
+	uint64_t ts_recv;
 	unsigned int len;
+	uint32_t req_id;
 	int ret;
 
 	len = sizeof(cmd);
 	if (rpmsg_recv(ept, &cmd, &len) < 0)
 		return;
 
-	switch (cmd.u.cmd.type) {
+	ts_recv = os_trace_timestamp();
+
+	/* echoed in the response */
+	req_id = HRPN_REQ_ID(cmd.u.cmd.type);
+
+	switch (HRPN_TYPE(cmd.u.cmd.type)) {
 	case HRPN_CMD_TYPE_LATENCY_RUN:
 		if (len != sizeof(struct hrpn_cmd_latency_run)) {
-			response(ept, HRPN_RESP_STATUS_ERROR);
+			response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_ERROR);
 			break;
 		}
 
-		if (cmd.u.latency_run.id >= RT_LATENCY_TEST_CASE_MAX) {
-			response(ept, HRPN_RESP_STATUS_ERROR);
+		if (rt_latency_cfg_init(&cfg, &cmd.u.latency_run, ept) < 0) {
+			response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_ERROR);
 			break;
 		}
 
-		ret = start_test_case(ctx, cmd.u.latency_run.id, cmd.u.latency_run.quiet);
+		ret = start_test_case(ctx, &cfg);
 		if (ret)
-			response(ept, HRPN_RESP_STATUS_ERROR);
+			response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_ERROR);
 		else
-			response(ept, HRPN_RESP_STATUS_SUCCESS);
+			response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_SUCCESS);
 
 		break;
 
 	case HRPN_CMD_TYPE_LATENCY_STOP:
 		if (len != sizeof(struct hrpn_cmd_latency_stop)) {
-			response(ept, HRPN_RESP_STATUS_ERROR);
+			response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_ERROR);
 			break;
 		}
 
+		/* remaining captured samples are sent before the response */
 		destroy_test_case(ctx);
-		response(ept, HRPN_RESP_STATUS_SUCCESS);
+		response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_SUCCESS);
+		break;
+
+	case HRPN_CMD_TYPE_LATENCY_PING:
+		/* control path round trip, including the control task polling delay */
+		rt_latency_ipc_pong(ept, &cmd.u.latency_ping, len, ts_recv);
+		break;
+
+	case HRPN_CMD_TYPE_LATENCY_SOAK_READ:
+		if (len != sizeof(struct hrpn_cmd_latency_soak_read)) {
+			response(ept, HRPN_RESP_TYPE_LATENCY_SOAK, req_id, HRPN_RESP_STATUS_ERROR);
+			break;
+		}
+
+		rt_latency_soak_read(ept, &cmd.u.latency_soak_read);
+		break;
+
+	case HRPN_CMD_TYPE_CAPS:
+		rt_latency_caps(ept, req_id);
 		break;
 
 	default:
-		response(ept, HRPN_RESP_STATUS_ERROR);
+		response(ept, HRPN_RESP_TYPE_LATENCY, req_id, HRPN_RESP_STATUS_ERROR);
 		break;
 	}
 }
 
+/*
+ * Background processing of the control task, called after each command
+ * handler poll: drains the capture ring, sends the outlier trace, records the
+ * soak mode windows and ends the test case once its duration elapsed (Linux is
+ * notified with a HRPN_RESP_TYPE_LATENCY_DONE message, sent after the last
+ * captured samples).
+ */
+void rt_latency_ctrl_poll(void *context, struct rt_latency_ctx *ctx, struct rpmsg_ept *ept)
+{
+	rt_latency_capture_send(ctx);
+	rt_latency_trace_send(ctx);
+	if (rt_latency_soak)
+		rt_latency_soak_reduce(rt_latency_soak);
+
+	if (ctx->dev && __atomic_load_n(&ctx->done, __ATOMIC_ACQUIRE)) {
+		log_info("test case duration elapsed\n");
+
+		destroy_test_case(context);
+		response(ept, HRPN_RESP_TYPE_LATENCY_DONE, 0, HRPN_RESP_STATUS_SUCCESS);
+	}
+}
+
+static void rt_latency_telemetry_hist(struct telemetry *t, uint8_t core, uint16_t id, const struct hdr_hist *h)
+{
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_LATENCY, core, id, h->total ? h->min : 0);
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_LATENCY, core, id + 1, hdr_hist_mean(h));
+	telemetry_add(t, HRPN_TELEMETRY_SOURCE_LATENCY, core, id + 2, h->max);
+}
+
+/*
+ * Telemetry snapshot, with the statistics of the running test case of each
+ * core: read from the histograms accumulated since the test case start, while
+ * the benchmark updates them (monitoring only, may be a sample off).
+ */
+void rt_latency_telemetry_poll(struct ctrl_ctx *ctrl, struct rt_latency_ctx *ctx, unsigned int count)
+{
+	struct telemetry *t = &ctrl->telemetry;
+	unsigned int i;
+
+	if (!telemetry_poll(t, RT_LATENCY_CTRL_POLL_PERIOD_MS))
+		return;
+
+	for (i = 0; i < count; i++, ctx++) {
+		if (!ctx->dev || ctx->sched.enabled)
+			continue;
+
+		telemetry_add(t, HRPN_TELEMETRY_SOURCE_LATENCY, ctx->core, HRPN_TELEMETRY_LATENCY_COUNT,
+			      ctx->stats.irq_delay_hist.total);
+		rt_latency_telemetry_hist(t, ctx->core, HRPN_TELEMETRY_LATENCY_IRQ_DELAY_MIN,
+					  &ctx->stats.irq_delay_hist);
+		rt_latency_telemetry_hist(t, ctx->core, HRPN_TELEMETRY_LATENCY_IRQ_TO_SCHED_MIN,
+					  &ctx->stats.irq_to_sched_hist);
+		telemetry_add(t, HRPN_TELEMETRY_SOURCE_LATENCY, ctx->core, HRPN_TELEMETRY_LATENCY_LATE_ALARM_SCHED,
+			      ctx->stats.late_alarm_sched);
+	}
+
+	telemetry_send(t);
+}
+
 int ctrl_ctx_init(struct ctrl_ctx *ctrl)
 {
 	int rc = 0;
@@ -387,5 +2415,11 @@ int ctrl_ctx_init(struct ctrl_ctx *ctrl)
 	ctrl->ept = rpmsg_transport_init(RL_BOARD_RPMSG_LINK_ID, EPT_ADDR, "rpmsg-raw");
 	rtos_assert(ctrl->ept, "rpmsg transport initialization failed, cannot proceed\n");
 
+	ctrl->ipc_ept = rpmsg_create_ept(ctrl->ept->ri, HRPN_LATENCY_IPC_EPT, "rpmsg-raw");
+	rtos_assert(ctrl->ipc_ept, "IPC benchmark endpoint creation failed, cannot proceed\n");
+
+	rc = telemetry_init(&ctrl->telemetry, ctrl->ept->ri);
+	rtos_assert(!rc, "telemetry endpoint creation failed, cannot proceed\n");
+
 	return rc;
 }
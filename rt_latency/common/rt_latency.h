@@ -8,25 +8,138 @@
 #define _RT_LATENCY_H_
 
 #include "os/counter.h"
+#include "os/notify.h"
+#include "os/trace.h"
 #include "rtos_apps/stats.h"
+#include "hdr_hist.h"
+#include "hrpn_ctrl.h"
 #include "rpmsg.h"
+#include "telemetry.h"
 #include "rtos_abstraction_layer.h"
 
+/* Control task poll period (ms) */
+#define RT_LATENCY_CTRL_POLL_PERIOD_MS			(100)
+
 /* Time period between two statistics polling logs (seconds) */
 #define STATS_PERIOD_SEC					   (1)
 
 /* Time period between two statistics dump logs (seconds) */
 #define LATENCY_STATS_PERIOD_SEC				   (10)
 
-/* Time for counter alarm timeout (us) */
+/* Time for counter alarm timeout (us), default value */
 #define COUNTER_PERIOD_US_VAL			   (100)
 
+/* Valid range of the counter alarm period (us) */
+#define RT_LATENCY_PERIOD_US_MIN			(10)
+#define RT_LATENCY_PERIOD_US_MAX			(1000000)
+
+/* IRQ load handler duration (us), default value */
+#define IRQ_LOAD_ISR_DURATION_US			(10)
+
 /* Timeout to wait for timer irq (ms) */
 #define COUNTER_IRQ_TIMEOUT_MS			   (10)
 
 /* Time between two cache invalidation instructions (ms) */
 #define CACHE_INVAL_PERIOD_MS				 (100)
 
+/*
+ * OCRAM test case: number of iterations run with one copy of the measurement
+ * code (DDR or OCRAM) before switching to the other one
+ */
+#define RT_LATENCY_OCRAM_WINDOW				(1000)
+
+/*
+ * Wake-up matrix: number of iterations run with one wake-up primitive before
+ * switching to the next one
+ */
+#define RT_LATENCY_WAKEUP_WINDOW			(1000)
+
+/*
+ * Interrupt storm: number of iterations run with the storm sources on, then
+ * off, so that the storm impact is measured against a baseline of the same run
+ */
+#define RT_LATENCY_STORM_WINDOW				(1000)
+
+/*
+ * Scheduling benchmark: number of iterations run with one measurement before
+ * switching to the next one, and pause between two iterations (ms), leaving
+ * the CPU to the lower priority tasks
+ */
+#define RT_LATENCY_SCHED_WINDOW				(1000)
+#define RT_LATENCY_SCHED_PAUSE_MS			(1)
+
+/* Interrupt storm: software generated interrupts used by the sources (SGI 8 to 15) */
+#define RT_LATENCY_STORM_SGI_BASE			(8)
+#define RT_LATENCY_STORM_SGI_MAX			(8)
+
+/* Interrupt storm sources priority default: the latency alarm one (or the highest allowed) */
+#if defined(BOARD_COUNTER_0_IRQ_PRIO)
+#define RT_LATENCY_STORM_PRIO_DEFAULT			BOARD_COUNTER_0_IRQ_PRIO
+#else
+#define RT_LATENCY_STORM_PRIO_DEFAULT			OS_IRQ_PRIO_MAX
+#endif
+
+/*
+ * Maximum number of cores running a benchmark task, each with its own
+ * counters and statistics (Zephyr SMP builds)
+ */
+#if defined(OS_ZEPHYR) && defined(CONFIG_SMP)
+#define RT_LATENCY_CPUS_MAX				CONFIG_MP_MAX_NUM_CPUS
+#else
+#define RT_LATENCY_CPUS_MAX				(1)
+#endif
+
+#define RT_LATENCY_CPU_MASK_ALL				((1U << RT_LATENCY_CPUS_MAX) - 1)
+
+/*
+ * Zephyr i.MX 95 and i.MX 943 cells only have 1 MB of memory: buffers are
+ * smaller. Static data: benchmark context (statistics and snapshot, ~97 KB),
+ * memory load buffer (64 KB), log buffer (64 KB) and thread stacks (~46 KB).
+ *
+ * The storage of the optional features is allocated from the heap only when
+ * a test case enables them: capture ring (96 KB, 48 KB on the 1 MB cells),
+ * OCRAM statistics snapshot (48 KB), wake-up matrix statistics (110 KB),
+ * interrupt storm histograms (27 KB per benchmark core), soak ring (216 KB,
+ * 81 KB on the 1 MB cells) and scheduling benchmark statistics (55 KB). The
+ * FreeRTOS heap holds all of them, the Zephyr heap is sized for the features
+ * selected in the application Kconfig (CONFIG_RT_LATENCY_xxx).
+ */
+#if defined(OS_ZEPHYR) && (defined(CONFIG_BOARD_IMX95_EVK) || defined(CONFIG_BOARD_IMX95_EVK_15X15) || \
+			   defined(CONFIG_BOARD_IMX943_EVK))
+#define RT_LATENCY_SMALL_MEMORY
+#endif
+
+/*
+ * Memory interference load: static buffer, split in one slice per core, well
+ * past the L2 cache of the supported SoCs (on the 1 MB cells, the footprint
+ * stays cache resident whatever its size, and is limited to the default one).
+ */
+#if defined(RT_LATENCY_SMALL_MEMORY)
+#define RT_LATENCY_MEM_SIZE_MAX				(64 * 1024)
+#else
+#define RT_LATENCY_MEM_SIZE_MAX				(2 * 1024 * 1024)
+#endif
+#define RT_LATENCY_MEM_SLICE_SIZE			(RT_LATENCY_MEM_SIZE_MAX / RT_LATENCY_CPUS_MAX)
+
+/* Memory interference load defaults: footprint (bytes) and stride (bytes, one cache line) */
+#define RT_LATENCY_MEM_SIZE_DEFAULT			(64 * 1024)
+#define RT_LATENCY_MEM_STRIDE_DEFAULT			(64)
+
+/* Raw samples capture ring size (must be a power of 2), allocated when capturing */
+#if defined(RT_LATENCY_SMALL_MEMORY)
+#define RT_LATENCY_CAPTURE_RING_SIZE			(4096)
+#else
+#define RT_LATENCY_CAPTURE_RING_SIZE			(8192)
+#endif
+
+/* Soak mode ring size: 72 h of 1 min windows (24 h on the 1 MB cells), allocated by the first soak test case */
+#if defined(RT_LATENCY_SMALL_MEMORY)
+#define RT_LATENCY_SOAK_RING_SIZE			(1440)
+#else
+#define RT_LATENCY_SOAK_RING_SIZE			(4320)
+#endif
+#define RT_LATENCY_SOAK_WINDOW_S_MAX			(86400)
+
 /*
  * Symbol definitions:
  *
@@ -34,16 +147,21 @@
  * WITH_CPU_LOAD:     Add CPU load in the lower priority task
  * WITH_CPU_LOAD_SEM: Add Semaphore load in CPU load thread
  * WITH_INVD_CACHE:   Add cache invalidation thread
+ * WITH_LINUX_LOAD:   Linux load (run from Linux)
+ * USES_OCRAM:        Alternate DDR and OCRAM copies of the measurement code
+ * WITH_MEM_LOAD:     Add memory interference (buffer streaming) load thread
  */
-#define RT_LATENCY_WITH_IRQ_LOAD             (1 << 1)
-#define RT_LATENCY_WITH_CPU_LOAD             (1 << 2)
-#define RT_LATENCY_WITH_CPU_LOAD_SEM         (1 << 3)
-#define RT_LATENCY_WITH_INVD_CACHE           (1 << 4)
-#define RT_LATENCY_WITH_LINUX_LOAD           (1 << 5)
-#define RT_LATENCY_USES_OCRAM                (1 << 6)
+#define RT_LATENCY_WITH_IRQ_LOAD             HRPN_LATENCY_LOAD_IRQ
+#define RT_LATENCY_WITH_CPU_LOAD             HRPN_LATENCY_LOAD_CPU
+#define RT_LATENCY_WITH_CPU_LOAD_SEM         HRPN_LATENCY_LOAD_CPU_SEM
+#define RT_LATENCY_WITH_INVD_CACHE           HRPN_LATENCY_LOAD_INVD_CACHE
+#define RT_LATENCY_WITH_LINUX_LOAD           HRPN_LATENCY_LOAD_LINUX
+#define RT_LATENCY_USES_OCRAM                HRPN_LATENCY_LOAD_OCRAM
+#define RT_LATENCY_WITH_MEM_LOAD             HRPN_LATENCY_LOAD_MEM
 
 enum rt_latency_test_case_id
 {
+	RT_LATENCY_TEST_CASE_CUSTOM = HRPN_LATENCY_TEST_CASE_CUSTOM, /* load set at run time */
 	RT_LATENCY_TEST_CASE_1 = 1,
 	RT_LATENCY_TEST_CASE_2,
 	RT_LATENCY_TEST_CASE_3,
@@ -81,11 +199,9 @@ static inline int rt_latency_get_tc_load(int test_case_id)
 				RT_LATENCY_WITH_INVD_CACHE;
 		break;
 	case RT_LATENCY_TEST_CASE_7:
-		/*
-		 * TODO: Move/duplicate the code in OCRAM to enable before enabling
-		 * RT_LATENCY_TEST_CASE_7
-		 */
-		mask = -1;
+		mask |= RT_LATENCY_WITH_CPU_LOAD |
+				RT_LATENCY_WITH_LINUX_LOAD |
+				RT_LATENCY_USES_OCRAM;
 		break;
 	default:
 		mask = -1;
@@ -95,18 +211,261 @@ static inline int rt_latency_get_tc_load(int test_case_id)
 	return mask;
 }
 
+/*
+ * Latency breakdown phases, from generic timer timestamps taken at the GIC
+ * exception entry (IRQ dispatcher), in the counter ISR, just before the
+ * semaphore is given and at the benchmark task switch-in.
+ */
+enum {
+	RT_LATENCY_PHASE_HW_ENTRY = 0,	/* programmed alarm -> GIC exception entry */
+	RT_LATENCY_PHASE_IRQ_DISPATCH,	/* GIC exception entry -> counter ISR */
+	RT_LATENCY_PHASE_ISR,		/* counter ISR -> semaphore give */
+	RT_LATENCY_PHASE_SEM_TO_SWITCH,	/* semaphore give -> task switch-in */
+	RT_LATENCY_PHASE_SWITCH_TO_TASK,	/* task switch-in -> task running */
+	RT_LATENCY_PHASE_MAX,
+};
+
 typedef struct rt_latency_stats {
 	struct rtos_apps_stats irq_delay;
-	struct rtos_apps_hist irq_delay_hist;
+	struct hdr_hist irq_delay_hist;
 
 	struct rtos_apps_stats irq_to_sched;
-	struct rtos_apps_hist irq_to_sched_hist;
+	struct hdr_hist irq_to_sched_hist;
 
 	uint32_t late_alarm_sched;
+
+	struct rtos_apps_stats phase[RT_LATENCY_PHASE_MAX];
+	struct hdr_hist phase_hist[RT_LATENCY_PHASE_MAX];
+
+	/* Periodic (absolute deadline) mode only */
+	struct rtos_apps_stats wakeup_jitter; /* |wake-up interval - expected interval| */
+	int64_t drift;			/* accumulated wake-up interval error since test start (ns) */
+	uint32_t missed_deadlines;	/* timeline periods elapsed without a wake-up */
+
 	bool pending;
 
 } rt_latency_stats_t;
 
+/* Wake-up primitives of the wake-up matrix */
+enum {
+	RT_LATENCY_WAKEUP_SEM = 0,	/* semaphore (default path, outside of the wake-up matrix) */
+	RT_LATENCY_WAKEUP_MQUEUE,	/* message queue */
+	RT_LATENCY_WAKEUP_NOTIFY,	/* OS native notification (os/notify.h) */
+	RT_LATENCY_WAKEUP_MUTEX,	/* mutex hand-over, task to task only */
+	RT_LATENCY_WAKEUP_MAX,
+};
+
+struct rt_latency_wakeup_stats {
+	struct rtos_apps_stats isr_to_task; /* counter IRQ -> benchmark task running */
+	struct hdr_hist isr_to_task_hist;
+	struct rtos_apps_stats task_to_task; /* benchmark task signal -> peer task running */
+	struct hdr_hist task_to_task_hist;
+};
+
+/*
+ * Wake-up matrix: each window of iterations, the alarm handler wakes the
+ * benchmark task up with the next primitive, then the benchmark task wakes a
+ * peer task up with the same primitive.
+ */
+struct rt_latency_wakeup {
+	bool enabled;
+	unsigned int prim; /* RT_LATENCY_WAKEUP_xxx of the current window */
+
+	/* ISR to task, the semaphore is the benchmark semaphore */
+	rtos_mqueue_t *isr_mqueue;
+	os_notify_t isr_notify; /* bound to the benchmark task */
+	bool isr_notify_bound;
+
+	/* Task to task */
+	rtos_sem_t peer_start; /* start of a task to task measurement */
+	rtos_sem_t peer_ready; /* peer about to wait (or to lock the mutex) */
+	rtos_sem_t peer_done; /* peer measurement done */
+	rtos_sem_t sem;
+	rtos_mqueue_t *mqueue;
+	os_notify_t notify; /* bound to the peer task */
+	bool notify_bound;
+	rtos_mutex_t mutex;
+	uint64_t ts_signal; /* generic timer count when the peer was signaled */
+	bool resources; /* mutex and message queues allocated, kept across test cases */
+
+	/* RT_LATENCY_WAKEUP_MAX entries each, allocated when enabled */
+	struct rt_latency_wakeup_stats *stats;
+	struct rt_latency_wakeup_stats *snapshot;
+};
+
+/* Scheduling benchmark measurements, in the HRPN_LATENCY_METRIC_SCHED_xxx order */
+enum {
+	RT_LATENCY_SCHED_SWITCH = 0,	/* benchmark task blocks -> same priority peer running */
+	RT_LATENCY_SCHED_PREEMPT,	/* benchmark task gives a semaphore -> higher priority peer running */
+	RT_LATENCY_SCHED_YIELD,		/* benchmark task yields -> same priority peer running */
+	RT_LATENCY_SCHED_MUTEX_PI,	/* low priority peer, boosted, unlocks -> higher priority peer running */
+	RT_LATENCY_SCHED_MAX,
+};
+
+/* Scheduling benchmark peer tasks, relative to the benchmark task priority */
+enum {
+	RT_LATENCY_SCHED_PEER_SAME = 0,	/* same priority */
+	RT_LATENCY_SCHED_PEER_HIGH,	/* higher priority */
+	RT_LATENCY_SCHED_PEER_LOW,	/* lower priority, holds the mutex */
+	RT_LATENCY_SCHED_PEER_MAX,
+};
+
+struct rt_latency_sched_stats {
+	struct rtos_apps_stats stats;
+	struct hdr_hist hist;
+};
+
+/*
+ * Scheduling benchmark: no alarm, the benchmark task and its peers measure the
+ * RTOS costs of task to task switches, one measurement per window of
+ * iterations. All the tasks run on the same core, and are all blocked between
+ * two iterations.
+ */
+struct rt_latency_sched {
+	bool enabled;
+	unsigned int test; /* RT_LATENCY_SCHED_xxx of the current window */
+
+	rtos_sem_t start[RT_LATENCY_SCHED_PEER_MAX]; /* peer released by the benchmark task */
+	rtos_sem_t done; /* peer measurement done */
+	rtos_sem_t locked; /* low priority peer holds the mutex */
+	rtos_sem_t unlock; /* low priority peer to unlock the mutex */
+	rtos_mutex_t mutex;
+	bool resources; /* mutex allocated, kept across test cases */
+
+	uint64_t ts; /* generic timer count before the switch, 0 if not valid */
+	bool low_running; /* low priority peer ran on unlock request (priority inheritance) */
+	uint64_t t0; /* generic timer count of the first iteration */
+	uint32_t pi_failures; /* unlock requests not run right away, the low priority peer not boosted */
+	uint32_t dropped; /* measurements dropped, the peer switched in by time slicing */
+
+	/* RT_LATENCY_SCHED_MAX entries each, allocated when enabled */
+	struct rt_latency_sched_stats *stats;
+	struct rt_latency_sched_stats *snapshot;
+};
+
+/*
+ * Single producer (benchmark task), single consumer (control task) ring of
+ * raw samples, drained to Linux over RPMsg.
+ */
+struct rt_latency_capture {
+	struct rpmsg_ept *ept; /* capture disabled if NULL */
+	uint32_t frequency;
+	uint32_t head; /* next slot to write, updated by the producer only */
+	uint32_t tail; /* next slot to read, updated by the consumer only */
+	uint32_t dropped;
+	uint32_t seq;
+	struct hrpn_latency_sample *ring; /* RT_LATENCY_CAPTURE_RING_SIZE samples */
+};
+
+/*
+ * Outlier tracer: the OS event trace is frozen by the benchmark task on an irq
+ * delay above the threshold, and sent to Linux by the control task, which
+ * then restarts it.
+ */
+struct rt_latency_trace {
+	struct rpmsg_ept *ept; /* tracer disabled if NULL */
+	uint64_t threshold_ns;
+	uint32_t value; /* irq delay of the frozen trace outlier (ns) */
+	uint32_t seq; /* traces sent so far */
+	uint32_t missed; /* outliers not traced, the previous trace still being sent */
+	bool pending; /* frozen trace to be sent */
+};
+
+/*
+ * Soak mode: the benchmark task accounts the samples of the current window
+ * in one of two histograms, and hands it over to the control task at the end
+ * of the window, which reduces it to a ring entry.
+ */
+struct rt_latency_soak {
+	unsigned int window_s;
+	uint64_t window_ticks; /* generic timer (os_trace_timestamp()) ticks */
+	uint64_t start; /* test case start */
+	uint64_t window_start; /* current window start */
+	unsigned int active; /* histogram of the current window, written by the benchmark task */
+	bool pending; /* previous window handed over to the control task */
+	uint32_t late_alarm_sched; /* total at the start of the current window */
+	uint32_t missed; /* windows not recorded, the previous one still pending */
+	uint32_t seq; /* windows recorded so far */
+
+	struct hdr_hist hist[2];
+	uint32_t irq_to_sched_max[2];
+	uint32_t late[2];
+	uint64_t hist_start[2];
+	uint64_t hist_end[2];
+
+	struct hrpn_latency_soak_entry ring[RT_LATENCY_SOAK_RING_SIZE];
+};
+
+struct rt_latency_storm_source {
+	unsigned int period_us;
+	unsigned int duration_us;
+	uint32_t period_ticks; /* IRQ load counter ticks */
+	uint32_t next; /* next interrupt, IRQ load counter value */
+	uint64_t duration; /* handler busy loop, generic timer ticks */
+	unsigned int prio;
+	unsigned int nest;
+	unsigned int sgi; /* first level SGI, nested levels use the following ones */
+	uint32_t fired;
+	uint32_t overruns; /* periods skipped, the storm driver being late */
+};
+
+/* Nesting level of a source, one SGI each */
+struct rt_latency_storm_level {
+	struct rt_latency_storm_source *src;
+	unsigned int depth;
+};
+
+/*
+ * Interrupt storm: the IRQ load counter alarm raises the SGIs of the sources
+ * on their deadlines, during the storm windows only. The irq delays of the
+ * storm and baseline windows are accounted apart.
+ */
+struct rt_latency_storm {
+	unsigned int count; /* sources, storm disabled if 0 */
+	struct rt_latency_storm_source src[HRPN_LATENCY_IRQ_STORM_SOURCES_MAX];
+	struct rt_latency_storm_level level[RT_LATENCY_STORM_SGI_MAX];
+	unsigned int levels;
+	bool started;
+	bool active; /* storm window, written by the benchmark task */
+
+	/* allocated when enabled, in a single block starting at irq_delay_off */
+	struct hdr_hist *irq_delay_off;
+	struct hdr_hist *irq_delay_on;
+
+	/* snapshot for the logging task */
+	struct hdr_hist *irq_delay_off_snapshot;
+	struct hdr_hist *irq_delay_on_snapshot;
+	uint32_t fired_snapshot[HRPN_LATENCY_IRQ_STORM_SOURCES_MAX];
+	uint32_t overruns_snapshot[HRPN_LATENCY_IRQ_STORM_SOURCES_MAX];
+};
+
+struct rt_latency_cfg {
+	int test_case_id;
+	int load; /* bitmask of the RT_LATENCY_WITH_xxx test case load conditions */
+	bool quiet;
+	unsigned int mode; /* HRPN_LATENCY_MODE_xxx */
+	struct rpmsg_ept *capture_ept; /* stream raw samples to this endpoint, if not NULL */
+	unsigned int period_us;
+	unsigned int irq_load_duration_us;
+	unsigned int irq_load_period_us; /* 0: IRQ load fires once before each latency alarm */
+	unsigned int hist_sub_bits;
+	unsigned int duration_s; /* 0: run until stopped */
+	char linux_load[HRPN_LATENCY_LINUX_LOAD_LEN]; /* Linux load profile tag, empty if none */
+	struct rpmsg_ept *trace_ept; /* send outlier traces to this endpoint, if not NULL */
+	unsigned int trace_threshold_us;
+	bool wakeup_matrix;
+	uint32_t cpu_mask; /* cores running a benchmark task */
+	uint32_t load_cpu_mask; /* cores running the load tasks */
+	unsigned int irq_storm_count;
+	struct hrpn_latency_irq_source irq_storm[HRPN_LATENCY_IRQ_STORM_SOURCES_MAX];
+	struct rpmsg_ept *stats_ept; /* send the end of run statistics to this endpoint, if not NULL */
+	unsigned int soak_window_s; /* 0: soak mode disabled */
+	unsigned int mem_size; /* memory interference load footprint per load core (bytes) */
+	unsigned int mem_stride;
+	unsigned int mem_pattern; /* HRPN_LATENCY_MEM_xxx */
+	unsigned int core; /* core of this benchmark task instance, set by the OS specific code */
+};
+
 struct rt_latency_ctx {
 	os_counter_t *dev;
 	os_counter_t *irq_load_dev;
@@ -119,30 +478,95 @@ struct rt_latency_ctx {
 
 	uint64_t time_irq;
 	uint32_t time_prog;
+	uint64_t irq_delay; /* latest measurement (ns) */
+	uint64_t irq_to_sched; /* latest measurement (ns) */
+
+	/* Latency breakdown timestamps (generic timer), set by the alarm handler */
+	uint64_t ts_irq_entry; /* 0 if not available (OS_TRACE disabled) */
+	uint64_t ts_isr;
+	uint64_t ts_sem_give;
+	uint32_t ts_frequency;
+
+	unsigned int period_us;
+	uint32_t period_ticks;
+	uint64_t period_ns;
+	uint64_t iterations;
+	uint64_t stats_period; /* iterations between two stats dumps */
+
+	uint64_t duration_ns; /* 0: run until stopped */
+	uint64_t elapsed_ns;
+	struct os_counter_clock clock; /* periodic mode: 64-bit timeline since t0 */
+	bool done; /* test duration elapsed, set by the benchmark task */
+
+	uint64_t irq_load_duration_ns;
+	uint32_t irq_load_period_ticks; /* 0: synchronized with the latency alarm */
+	uint32_t irq_load_prog;
+	bool irq_load_started;
+
+	unsigned int mode; /* HRPN_LATENCY_MODE_xxx */
+	bool timeline_started; /* periodic mode: counter running and time_prog on the timeline */
+	bool wakeup_valid; /* periodic mode: time_wakeup holds the previous wake-up time */
+	uint64_t time_wakeup; /* periodic mode: on the 64-bit timeline */
+	uint64_t deadline; /* periodic mode: time_prog on the 64-bit timeline */
+	uint32_t periods; /* periodic mode: timeline periods since previous wake-up */
 
 	rt_latency_stats_t stats;	  /* Current stats tracked by timer task. */
 	rt_latency_stats_t stats_snapshot; /* Stats snapshot dump by timer task and printed by logging task. */
 
+	/* OCRAM test case: stats of the OCRAM placement (stats above track the DDR one) */
+	rt_latency_stats_t *ocram_stats; /* located in OCRAM */
+	rt_latency_stats_t *ocram_stats_snapshot; /* allocated for the OCRAM test case only */
+	bool ocram_window; /* current iterations run the OCRAM copy of the measurement code */
+
 	bool quiet;
+	unsigned int core; /* core running the benchmark task */
+
+	char linux_load[HRPN_LATENCY_LINUX_LOAD_LEN]; /* Linux load profile tag, reported with the stats */
+
+	struct rpmsg_ept *stats_ept; /* end of run statistics report disabled if NULL */
+	struct rt_latency_soak *soak; /* soak mode disabled if NULL */
+	struct rt_latency_capture capture;
+	struct rt_latency_trace trace;
+	struct rt_latency_wakeup wakeup;
+	struct rt_latency_sched sched;
+	struct rt_latency_storm storm;
+
+	/* Memory interference load */
+	unsigned int mem_size;
+	unsigned int mem_stride;
+	unsigned int mem_pattern;
 };
 
 struct ctrl_ctx {
 	struct rpmsg_ept *ept;
+	struct rpmsg_ept *ipc_ept; /* IPC round trip benchmark, served by the echo task */
+	struct telemetry telemetry;
 };
 
-int rt_latency_init(os_counter_t *dev,
-		os_counter_t *irq_load_dev, struct rt_latency_ctx *ctx);
+int rt_latency_init(os_counter_t *dev, os_counter_t *irq_load_dev,
+		struct rt_latency_cfg *cfg, struct rt_latency_ctx *ctx);
 int rt_latency_test(struct rt_latency_ctx *ctx);
+int rt_latency_measure_ocram(struct rt_latency_ctx *ctx);
+void rt_latency_wakeup_peer(struct rt_latency_ctx *ctx);
+void rt_latency_sched_peer(struct rt_latency_ctx *ctx, unsigned int peer);
 void rt_latency_destroy(struct rt_latency_ctx *ctx);
 
+void rt_latency_ctrl_poll(void *context, struct rt_latency_ctx *ctx, struct rpmsg_ept *ept);
+void rt_latency_telemetry_poll(struct ctrl_ctx *ctrl, struct rt_latency_ctx *ctx, unsigned int count);
+
 void print_stats(struct rt_latency_ctx *ctx);
+void print_stats_cores(struct rt_latency_ctx *ctx, unsigned int count);
+void print_stats_aggregate(struct rt_latency_ctx *ctx, unsigned int count);
 void cpu_load(struct rt_latency_ctx *ctx);
+void mem_load(struct rt_latency_ctx *ctx, unsigned int cpu);
 void cache_inval(void);
 void command_handler(void *ctx, struct rpmsg_ept *ept);
+void rt_latency_ipc_echo(struct rpmsg_ept *ept);
 int ctrl_ctx_init(struct ctrl_ctx *ctrl);
 
 /* OS specific functions */
-int start_test_case(void *context, int test_case_id, bool quiet);
+int start_test_case(void *context, struct rt_latency_cfg *cfg);
 void destroy_test_case(void *context);
+rt_latency_stats_t *rt_latency_ocram_stats_get(void);
 
 #endif /* _RT_LATENCY_H_ */
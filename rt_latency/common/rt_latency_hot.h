@@ -0,0 +1,383 @@
+/*
+ * Copyright 2021-2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _RT_LATENCY_HOT_H_
+#define _RT_LATENCY_HOT_H_
+
+/*
+ * Latency measurement hot path: alarm programming and handling, latency
+ * computation and statistics update.
+ *
+ * Included by rt_latency.c (default placement, DDR) and rt_latency_ocram.c
+ * (linked in OCRAM), so that the RT_LATENCY_USES_OCRAM test case can compare
+ * both placements of the same code. Only the code inlined from this file is
+ * duplicated: the out of line functions it calls (rtos_apps_stats_update(),
+ * semaphore give, counter driver) are shared by both copies.
+ */
+
+#include "os/counter.h"
+#include "os/trace.h"
+
+#include "hdr_hist.h"
+#include "rt_latency.h"
+#include "rtos_abstraction_layer.h"
+
+static inline uint32_t calc_diff_ticks(os_counter_t *dev,
+			uint32_t cnt_1, uint32_t cnt_2)
+{
+	uint32_t diff;
+	static uint32_t top = 0;
+	static int counting_up = -1;
+
+	/*
+	 * Set these variables once for all to avoid multiple register accesses
+	 * each time we call this function.
+	 */
+	if (top == 0)
+		top = os_counter_get_top_value(dev);
+
+	if (counting_up == -1)
+		counting_up = os_counter_is_counting_up(dev);
+
+	if (counting_up) {
+		diff =  (cnt_2 < cnt_1) ?
+			(cnt_2 + top - cnt_1) : (cnt_2 - cnt_1);
+	} else {
+		diff = (cnt_2 > cnt_1) ?
+			(cnt_1 + top - cnt_2) : (cnt_1 - cnt_2);
+	}
+
+	return diff;
+}
+
+static inline uint32_t calc_diff_ns(os_counter_t *dev,
+			uint32_t cnt_1, uint32_t cnt_2)
+{
+	return os_counter_ticks_to_ns(dev, calc_diff_ticks(dev, cnt_1, cnt_2));
+}
+
+/* Counter value @ticks after @cnt, wrapping at the counter top value */
+static inline uint32_t calc_add_ticks(os_counter_t *dev,
+			uint32_t cnt, uint64_t ticks)
+{
+	uint64_t top = os_counter_get_top_value(dev);
+
+	if (top == UINT32_MAX)
+		return cnt + (uint32_t)ticks;
+
+	return (cnt + ticks) % (top + 1);
+}
+
+/* Wake the benchmark task up, with the primitive of the current wake-up matrix window */
+static inline int rt_latency_wakeup_from_isr(struct rt_latency_ctx *ctx, bool *yield)
+{
+	uint32_t msg = 0;
+
+	switch (ctx->wakeup.prim) {
+	case RT_LATENCY_WAKEUP_MQUEUE:
+		return rtos_mqueue_send_from_isr(ctx->wakeup.isr_mqueue, &msg, RTOS_NO_WAIT, yield);
+
+	case RT_LATENCY_WAKEUP_NOTIFY:
+		return os_notify_give_from_isr(&ctx->wakeup.isr_notify, yield);
+
+	default:
+		return rtos_sem_give_from_isr(&ctx->semaphore, yield);
+	}
+}
+
+static inline int rt_latency_wakeup_wait(struct rt_latency_ctx *ctx, unsigned int timeout_ms)
+{
+	uint32_t msg;
+
+	switch (ctx->wakeup.prim) {
+	case RT_LATENCY_WAKEUP_MQUEUE:
+		return rtos_mqueue_receive(ctx->wakeup.isr_mqueue, &msg, RTOS_MS_TO_TICKS(timeout_ms)) ? -1 : 0;
+
+	case RT_LATENCY_WAKEUP_NOTIFY:
+		return os_notify_take(&ctx->wakeup.isr_notify, timeout_ms);
+
+	default:
+		return rtos_sem_take(&ctx->semaphore, RTOS_MS_TO_TICKS(timeout_ms));
+	}
+}
+
+/*
+ * Used by all RTOS:
+ *    o FreeRTOS through IRQ_Handler_GPT() handler
+ *    o Zephyr through the alarm's ->callback
+ *
+ * @current_counter: counter value when the IRQ occurred
+ */
+static void latency_alarm_handler(os_counter_t *dev, uint8_t chan_id,
+			  uint32_t irq_counter,
+			  void *user_data)
+{
+	struct rt_latency_ctx *ctx = user_data;
+	bool yield = false;
+	int err;
+
+	ctx->time_irq = irq_counter;
+	ctx->ts_isr = os_trace_timestamp();
+	ctx->ts_irq_entry = os_trace_irq_entry_ts();
+
+	os_trace_record(OS_TRACE_LATENCY_IRQ, 0);
+
+	ctx->ts_sem_give = os_trace_timestamp();
+
+	err = rt_latency_wakeup_from_isr(ctx, &yield);
+	rtos_assert(!err, "Failed to wake the benchmark task up from isr (err: %d)", err);
+
+	rtos_yield_from_isr(yield);
+}
+
+static inline void rt_latency_capture_push(struct rt_latency_capture *cap,
+			uint32_t prog, uint32_t irq, uint32_t wakeup)
+{
+	uint32_t head = cap->head;
+	struct hrpn_latency_sample *sample;
+
+	if (head - __atomic_load_n(&cap->tail, __ATOMIC_ACQUIRE) >= RT_LATENCY_CAPTURE_RING_SIZE) {
+		cap->dropped++;
+		return;
+	}
+
+	sample = &cap->ring[head & (RT_LATENCY_CAPTURE_RING_SIZE - 1)];
+	sample->prog = prog;
+	sample->irq = irq;
+	sample->wakeup = wakeup;
+
+	__atomic_store_n(&cap->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint64_t rt_latency_ts_to_ns(struct rt_latency_ctx *ctx, uint64_t ticks)
+{
+	return ticks * 1000000000ULL / ctx->ts_frequency;
+}
+
+static inline void rt_latency_phase_update(rt_latency_stats_t *stats, unsigned int phase, uint64_t ns)
+{
+	rtos_apps_stats_update(&stats->phase[phase], ns);
+	hdr_hist_update(&stats->phase_hist[phase], ns);
+}
+
+/*
+ * Split the wake-up latency in phases. The hardware entry phase is derived
+ * from the counter (GPT/TPM) irq delay minus the dispatch time measured with
+ * the generic timer, as the GIC entry can't read the latency counter. The
+ * switch phases are skipped if the task did not have to be switched in (no
+ * switch since the semaphore was given).
+ */
+static inline void rt_latency_phases_update(struct rt_latency_ctx *ctx, rt_latency_stats_t *stats,
+			uint64_t irq_delay, uint64_t ts_wakeup)
+{
+	uint64_t ts_switch_in = os_trace_switch_in_ts();
+	uint64_t dispatch;
+
+	if (!ctx->ts_irq_entry || (ctx->ts_irq_entry > ctx->ts_isr))
+		return;
+
+	dispatch = rt_latency_ts_to_ns(ctx, ctx->ts_isr - ctx->ts_irq_entry);
+
+	rt_latency_phase_update(stats, RT_LATENCY_PHASE_HW_ENTRY, irq_delay > dispatch ? irq_delay - dispatch : 0);
+	rt_latency_phase_update(stats, RT_LATENCY_PHASE_IRQ_DISPATCH, dispatch);
+	rt_latency_phase_update(stats, RT_LATENCY_PHASE_ISR,
+				rt_latency_ts_to_ns(ctx, ctx->ts_sem_give - ctx->ts_isr));
+
+	if ((ts_switch_in < ctx->ts_sem_give) || (ts_switch_in > ts_wakeup))
+		return;
+
+	rt_latency_phase_update(stats, RT_LATENCY_PHASE_SEM_TO_SWITCH,
+				rt_latency_ts_to_ns(ctx, ts_switch_in - ctx->ts_sem_give));
+	rt_latency_phase_update(stats, RT_LATENCY_PHASE_SWITCH_TO_TASK,
+				rt_latency_ts_to_ns(ctx, ts_wakeup - ts_switch_in));
+}
+
+/* Freeze the event trace on an outlier, unless the previous one is still being sent */
+static inline void rt_latency_trace_trigger(struct rt_latency_trace *trace, uint64_t irq_delay)
+{
+	if (!os_trace_freeze()) {
+		trace->missed++;
+		return;
+	}
+
+	trace->value = irq_delay > UINT32_MAX ? UINT32_MAX : irq_delay;
+
+	__atomic_store_n(&trace->pending, true, __ATOMIC_RELEASE);
+}
+
+/*
+ * Periodic mode: account for the wake-up that just happened and move
+ * ctx->time_prog to the next deadline of the t0 + n * period timeline.
+ * Deadlines that already elapsed are skipped and counted as missed, so that
+ * the timeline never stretches whatever the wake-up latency. Intervals are
+ * measured on the 64-bit timeline (@now), they can span several counter wraps
+ * with long periods and missed deadlines.
+ */
+static inline void rt_latency_periodic_update(struct rt_latency_ctx *ctx, rt_latency_stats_t *stats,
+			uint64_t now, uint32_t ticks)
+{
+	os_counter_t *dev = ctx->dev;
+	uint64_t missed;
+
+	if (ctx->wakeup_valid) {
+		int64_t interval = os_counter_clock_ticks_to_ns(&ctx->clock, now - ctx->time_wakeup);
+		int64_t error = interval - (int64_t)(ctx->periods * ctx->period_ns);
+
+		rtos_apps_stats_update(&stats->wakeup_jitter, error < 0 ? -error : error);
+		stats->drift += error;
+	}
+
+	ctx->time_wakeup = now;
+	ctx->wakeup_valid = true;
+
+	missed = (now > ctx->deadline) ? (now - ctx->deadline) / ticks : 0;
+	stats->missed_deadlines += missed;
+
+	ctx->periods = missed + 1;
+	ctx->deadline += (uint64_t)ctx->periods * ticks;
+	ctx->time_prog = calc_add_ticks(dev, ctx->time_prog, (uint64_t)ctx->periods * ticks);
+}
+
+/*
+ * Periodic mode: the alarm never fired, the deadline was already gone when it
+ * was programmed. Count the elapsed deadlines as missed and resync on the first
+ * deadline still ahead of us.
+ */
+static inline void rt_latency_periodic_resync(struct rt_latency_ctx *ctx, rt_latency_stats_t *stats,
+			uint32_t ticks)
+{
+	os_counter_t *dev = ctx->dev;
+	uint64_t now, missed;
+
+	now = os_counter_clock_read(&ctx->clock);
+
+	missed = ((now > ctx->deadline) ? (now - ctx->deadline) / ticks : 0) + 1;
+	stats->missed_deadlines += missed;
+
+	ctx->periods += missed;
+	ctx->deadline += missed * ticks;
+	ctx->time_prog = calc_add_ticks(dev, ctx->time_prog, missed * ticks);
+}
+
+/*
+ * One latency measurement: program the next alarm, wait for it and account
+ * the IRQ and wake-up latencies in @stats.
+ */
+static inline int rt_latency_measure(struct rt_latency_ctx *ctx, rt_latency_stats_t *stats)
+{
+	int err;
+	uint32_t cnt;
+	struct os_counter_alarm_cfg alarm_cfg;
+	uint32_t now;
+	uint64_t irq_delay;
+	uint64_t irq_to_sched;
+	uint64_t ts_wakeup;
+	uint64_t now_clock = 0;
+	os_counter_t *dev = ctx->dev;
+	uint32_t ticks = ctx->period_ticks;
+
+retry:
+	/* Configure IRQ latency testing alarm */
+	if (ctx->mode == HRPN_LATENCY_MODE_PERIODIC) {
+		/* t0 is the first read of the counter, deadlines then follow the timeline */
+		if (!ctx->timeline_started) {
+			os_counter_clock_init(&ctx->clock, dev);
+			cnt = ctx->clock.last;
+			ctx->time_prog = calc_add_ticks(dev, cnt, ticks);
+			ctx->deadline = ticks;
+			ctx->periods = 1;
+			ctx->timeline_started = true;
+		}
+	} else {
+		os_counter_get_value(dev, &cnt);
+		ctx->time_prog = cnt + ticks;
+	}
+
+	alarm_cfg.ticks = ctx->time_prog;
+	alarm_cfg.flags = OS_COUNTER_ALARM_CFG_ABSOLUTE;
+	alarm_cfg.user_data = ctx;
+	alarm_cfg.callback = latency_alarm_handler;
+
+	err = os_counter_set_channel_alarm(dev, 0, &alarm_cfg);
+	rtos_assert(!err, "Counter set alarm failed (err: %d)", err);
+
+	/* Sync current thread with alarm callback function thanks to a semaphore (or the wake-up matrix primitive) */
+	err = rt_latency_wakeup_wait(ctx, ctx->period_us / 1000 + COUNTER_IRQ_TIMEOUT_MS);
+	if (err < 0) {
+		/* waiting period timed out: probably late alarm scheduling and waiting for counter wrap. */
+		os_counter_cancel_channel_alarm(dev, 0);
+		/* There is a small race window between cancel alarm and alarm callback
+		 * giving the semaphore. But the difference between the small timeout
+		 * and the time for timer (few minutes at 24Mhz) to wrap covers that.
+		 */
+		stats->late_alarm_sched++;
+
+		if (ctx->mode == HRPN_LATENCY_MODE_PERIODIC)
+			rt_latency_periodic_resync(ctx, stats, ticks);
+
+		goto retry;
+	}
+
+	/* Woken up... fetch counter value to compute latency */
+	os_counter_get_value(dev, &now);
+	ts_wakeup = os_trace_timestamp();
+	if (ctx->mode == HRPN_LATENCY_MODE_RELATIVE)
+		os_counter_stop(dev);
+	else if (ctx->mode == HRPN_LATENCY_MODE_PERIODIC)
+		now_clock = os_counter_clock_read(&ctx->clock);
+
+	irq_delay = calc_diff_ns(dev, ctx->time_prog, ctx->time_irq);
+	ctx->irq_delay = irq_delay;
+
+	os_trace_record(OS_TRACE_LATENCY_WAKEUP, irq_delay > UINT32_MAX ? UINT32_MAX : irq_delay);
+	if (ctx->trace.ept && (irq_delay > ctx->trace.threshold_ns))
+		rt_latency_trace_trigger(&ctx->trace, irq_delay);
+
+	rtos_apps_stats_update(&stats->irq_delay, irq_delay);
+	hdr_hist_update(&stats->irq_delay_hist, irq_delay);
+
+	irq_to_sched = calc_diff_ns(dev, ctx->time_prog, now);
+	ctx->irq_to_sched = irq_to_sched;
+	rtos_apps_stats_update(&stats->irq_to_sched, irq_to_sched);
+	hdr_hist_update(&stats->irq_to_sched_hist, irq_to_sched);
+
+	rt_latency_phases_update(ctx, stats, irq_delay, ts_wakeup);
+
+	/* the mutex can't be given from an IRQ, its window uses the semaphore */
+	if (ctx->wakeup.enabled && (ctx->wakeup.prim != RT_LATENCY_WAKEUP_MUTEX)) {
+		struct rt_latency_wakeup_stats *wstats = &ctx->wakeup.stats[ctx->wakeup.prim];
+		uint64_t isr_to_task = calc_diff_ns(dev, ctx->time_irq, now);
+
+		rtos_apps_stats_update(&wstats->isr_to_task, isr_to_task);
+		hdr_hist_update(&wstats->isr_to_task_hist, isr_to_task);
+	}
+
+	if (ctx->capture.ept)
+		rt_latency_capture_push(&ctx->capture, ctx->time_prog, ctx->time_irq, now);
+
+	if (ctx->duration_ns) {
+		/*
+		 * periodic mode: time since t0, measured on the 64-bit timeline
+		 * (no rounding accumulated over multi-day runs). Relative mode:
+		 * the counter is stopped between measurements, and the period is
+		 * stretched by the wake-up latency.
+		 */
+		if (ctx->mode == HRPN_LATENCY_MODE_PERIODIC)
+			ctx->elapsed_ns = os_counter_clock_ticks_to_ns(&ctx->clock, now_clock);
+		else
+			ctx->elapsed_ns += ctx->period_ns + irq_to_sched;
+
+		if (ctx->elapsed_ns >= ctx->duration_ns)
+			__atomic_store_n(&ctx->done, true, __ATOMIC_RELEASE);
+	}
+
+	if (ctx->mode == HRPN_LATENCY_MODE_PERIODIC)
+		rt_latency_periodic_update(ctx, stats, now_clock, ticks);
+
+	return err;
+}
+
+#endif /* _RT_LATENCY_HOT_H_ */
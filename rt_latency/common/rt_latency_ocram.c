@@ -0,0 +1,22 @@
+/*
+ * Copyright 2025 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * OCRAM copy of the latency measurement code inlined from rt_latency_hot.h:
+ * the code, data and bss of the *ocram.c object files are linked in OCRAM by
+ * the FreeRTOS board linker scripts. The functions it calls (statistics
+ * update, semaphore give, counter driver) and the IRQ dispatcher are not
+ * copied, they stay in DDR unless the build defines OS_OCRAM_HOT_PATH (counter
+ * driver and IRQ dispatcher only).
+ */
+
+#include "rt_latency.h"
+#include "rt_latency_hot.h"
+
+int rt_latency_measure_ocram(struct rt_latency_ctx *ctx)
+{
+	return rt_latency_measure(ctx, ctx->ocram_stats);
+}
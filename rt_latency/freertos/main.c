@@ -16,6 +16,7 @@
 
 /* Harpoon-apps includes. */
 #include "os/counter.h"
+#include "os/section.h"
 
 #include "rtos_apps/stats.h"
 #include "rtos_apps/log.h"
@@ -49,17 +50,38 @@
  * Globals
  ******************************************************************************/
 
+/* Scheduling benchmark peer task parameters */
+struct sched_peer {
+	struct rt_latency_ctx *ctx;
+	unsigned int peer; /* RT_LATENCY_SCHED_PEER_xxx */
+};
+
 static struct main_ctx{
 	bool started;
 
 	struct rt_latency_ctx rt_ctx;
 	struct ctrl_ctx ctrl;
+	struct sched_peer sched_peer[RT_LATENCY_SCHED_PEER_MAX];
 
 	/* hard-coded number of elements ; only used to create/delete test case's
 	* task handles, all at once */
 	TaskHandle_t tc_taskHandles[8];
 } main_ctx;
 
+/*
+ * Scheduling benchmark peers priorities: same as the benchmark task, above
+ * (preempts it) and below the IPC echo task (boosted by the mutex priority
+ * inheritance)
+ */
+static const UBaseType_t sched_peer_prio[RT_LATENCY_SCHED_PEER_MAX] = {
+	[RT_LATENCY_SCHED_PEER_SAME] = HIGHEST_TASK_PRIORITY - 1,
+	[RT_LATENCY_SCHED_PEER_HIGH] = HIGHEST_TASK_PRIORITY,
+	[RT_LATENCY_SCHED_PEER_LOW] = HIGHEST_TASK_PRIORITY - 3,
+};
+
+/* OCRAM test case statistics */
+static rt_latency_stats_t ocram_stats OS_OCRAM_BSS;
+
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
@@ -70,6 +92,10 @@ void benchmark_task(void *pvParameters);
 void log_task(void *pvParameters);
 void cpu_load_task(void *pvParameters);
 void cache_inval_task(void *pvParameters);
+void mem_load_task(void *pvParameters);
+void wakeup_peer_task(void *pvParameters);
+void sched_peer_task(void *pvParameters);
+void ipc_echo_task(void *pvParameters);
 
 /*******************************************************************************
  * Code
@@ -98,6 +124,44 @@ void cache_inval_task(void *pvParameters)
 	} while(1);
 }
 
+void mem_load_task(void *pvParameters)
+{
+	struct rt_latency_ctx *ctx = pvParameters;
+
+	log_info("running\n");
+
+	do {
+		mem_load(ctx, 0);
+	} while(1);
+}
+
+void wakeup_peer_task(void *pvParameters)
+{
+	struct rt_latency_ctx *ctx = pvParameters;
+
+	do {
+		rt_latency_wakeup_peer(ctx);
+	} while(1);
+}
+
+void sched_peer_task(void *pvParameters)
+{
+	struct sched_peer *peer = pvParameters;
+
+	do {
+		rt_latency_sched_peer(peer->ctx, peer->peer);
+	} while(1);
+}
+
+void ipc_echo_task(void *pvParameters)
+{
+	struct ctrl_ctx *ctrl = pvParameters;
+
+	do {
+		rt_latency_ipc_echo(ctrl->ipc_ept);
+	} while(1);
+}
+
 void log_task(void *pvParameters)
 {
 	struct rt_latency_ctx *ctx = pvParameters;
@@ -131,6 +195,11 @@ void benchmark_task(void *pvParameters)
  * Application functions
  ******************************************************************************/
 
+rt_latency_stats_t *rt_latency_ocram_stats_get(void)
+{
+	return &ocram_stats;
+}
+
 void destroy_test_case(void *context)
 {
 	struct main_ctx *ctx = context;
@@ -151,38 +220,61 @@ void destroy_test_case(void *context)
 	ctx->started = false;
 }
 
-int start_test_case(void *context, int test_case_id, bool quiet)
+int start_test_case(void *context, struct rt_latency_cfg *cfg)
 {
 	struct main_ctx *ctx = context;
 	os_counter_t *main_counter_dev;
 	os_counter_t *irq_load_dev;
 	int hnd_idx = 0;
 	BaseType_t xResult;
+	int i;
 
 	if (ctx->started)
 		return -1;
 
 	log_info("---\n");
-	log_info("Running test case %d:\n", test_case_id);
+	log_info("Running test case %d (load: 0x%x, period: %u us):\n",
+		 cfg->test_case_id, cfg->load, cfg->period_us);
 
+#if defined(OS_COUNTER_GENERIC_TIMER)
+	main_counter_dev = GET_COUNTER_DEVICE_INSTANCE(generic);
+#else
 	main_counter_dev = GET_COUNTER_DEVICE_INSTANCE(0); //GPT1
+#endif
 	irq_load_dev = GET_COUNTER_DEVICE_INSTANCE(1); //GPT2
 
-	/* Initialize test case load conditions based on test case ID */
-	ctx->rt_ctx.tc_load = rt_latency_get_tc_load(test_case_id);
-	if (ctx->rt_ctx.tc_load < 0) {
-		log_err("Wrong test conditions!\n");
-		goto err;
-	}
-
 	/* Initialize test cases' context */
-	xResult = rt_latency_init(main_counter_dev, irq_load_dev, &ctx->rt_ctx);
+	xResult = rt_latency_init(main_counter_dev, irq_load_dev, cfg, &ctx->rt_ctx);
 	if (xResult) {
 		log_err("Initialization failed!\n");
 		goto err;
 	}
 
-	ctx->rt_ctx.quiet = quiet;
+	/* Wake-up matrix peer task: preempts the benchmark task as soon as it is woken up */
+	if (ctx->rt_ctx.wakeup.enabled) {
+		xResult = xTaskCreate(wakeup_peer_task, "wakeup_peer", STACK_SIZE,
+				       &ctx->rt_ctx, HIGHEST_TASK_PRIORITY, &ctx->tc_taskHandles[hnd_idx++]);
+		if (xResult != pdPASS) {
+			log_err("task creation failed!\n");
+			goto err_task;
+		}
+	}
+
+	/* Scheduling benchmark peers, the benchmark task makes them run */
+	if (ctx->rt_ctx.sched.enabled) {
+		for (i = 0; i < RT_LATENCY_SCHED_PEER_MAX; i++) {
+			ctx->sched_peer[i].ctx = &ctx->rt_ctx;
+			ctx->sched_peer[i].peer = i;
+
+			xResult = xTaskCreate(sched_peer_task, "sched_peer", STACK_SIZE,
+					       &ctx->sched_peer[i], sched_peer_prio[i], &ctx->tc_taskHandles[hnd_idx++]);
+			if (xResult != pdPASS) {
+				log_err("task creation failed!\n");
+				goto err_task;
+			}
+		}
+	}
+
 	/* Benchmark task: main "high prio IRQ" task */
 	xResult = xTaskCreate(benchmark_task, "benchmark_task", STACK_SIZE,
 			       &ctx->rt_ctx, HIGHEST_TASK_PRIORITY - 1, &ctx->tc_taskHandles[hnd_idx++]);
@@ -211,7 +303,17 @@ int start_test_case(void *context, int test_case_id, bool quiet)
 		}
 	}
 
-	if (!quiet) {
+	/* Memory interference task, shares the idle time with the CPU load task */
+	if (ctx->rt_ctx.tc_load & RT_LATENCY_WITH_MEM_LOAD) {
+		xResult = xTaskCreate(mem_load_task, "mem_load_task", STACK_SIZE,
+				       &ctx->rt_ctx, LOWEST_TASK_PRIORITY, &ctx->tc_taskHandles[hnd_idx++]);
+		if (xResult != pdPASS) {
+			log_err("task creation failed!\n");
+			goto err_task;
+		}
+	}
+
+	if (!cfg->quiet) {
 		/* Print task */
 		xResult = xTaskCreate(log_task, "log_task", STACK_SIZE,
 					&ctx->rt_ctx, LOWEST_TASK_PRIORITY + 1, &ctx->tc_taskHandles[hnd_idx++]);
@@ -243,6 +345,7 @@ err:
 void main_task(void *pvParameters)
 {
 	struct main_ctx *ctx = pvParameters;
+	BaseType_t xResult;
 	int rc;
 
 	log_info("Harpoon v%s\n", VERSION);
@@ -254,10 +357,17 @@ void main_task(void *pvParameters)
 	rc = ctrl_ctx_init(&ctx->ctrl);
 	rtos_assert(!rc, "ctrl context failed!");
 
+	/* IPC round trip benchmark, always running, below the benchmark task */
+	xResult = xTaskCreate(ipc_echo_task, "ipc_echo", MAIN_STACK_SIZE,
+			&ctx->ctrl, HIGHEST_TASK_PRIORITY - 2, NULL);
+	rtos_assert(xResult == pdPASS, "IPC echo task creation failed!");
+
 	do {
 		command_handler(ctx, ctx->ctrl.ept);
+		rt_latency_ctrl_poll(ctx, &ctx->rt_ctx, ctx->ctrl.ept);
+		rt_latency_telemetry_poll(&ctx->ctrl, &ctx->rt_ctx, 1);
 
-		vTaskDelay(pdMS_TO_TICKS(100));
+		vTaskDelay(pdMS_TO_TICKS(RT_LATENCY_CTRL_POLL_PERIOD_MS));
 
 	} while(1);
 }
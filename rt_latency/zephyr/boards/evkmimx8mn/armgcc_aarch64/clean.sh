@@ -1,3 +1,3 @@
 #!/bin/sh
-rm -rf build_singlecore
+rm -rf build_singlecore build_smp
 rm -rf .ninja*
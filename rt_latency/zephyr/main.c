@@ -6,33 +6,133 @@
 
 #include <zephyr/device.h>
 #include <zephyr/kernel.h>
+#include <stdio.h>
 #include <string.h>
 
+#include "memory.h"
+#include "os/irq.h"
+#include "os/mmu.h"
 #include "rtos_apps/log.h"
 #include "rt_latency.h"
 #include "rtos_abstraction_layer.h"
 
 #define STACK_SIZE 4096
 
-K_THREAD_STACK_DEFINE(counter_stack, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(counter_stack, RT_LATENCY_CPUS_MAX, STACK_SIZE);
 
-K_THREAD_STACK_DEFINE(cpu_load_stack, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(cpu_load_stack, RT_LATENCY_CPUS_MAX, STACK_SIZE);
 
-K_THREAD_STACK_DEFINE(cache_inval_stack, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(cache_inval_stack, RT_LATENCY_CPUS_MAX, STACK_SIZE);
+
+K_THREAD_STACK_ARRAY_DEFINE(mem_load_stack, RT_LATENCY_CPUS_MAX, STACK_SIZE);
 
 K_THREAD_STACK_DEFINE(print_stack, STACK_SIZE);
 
-#define MAX_TC_THREADS	8
+K_THREAD_STACK_DEFINE(wakeup_peer_stack, STACK_SIZE);
+
+K_THREAD_STACK_ARRAY_DEFINE(sched_peer_stack, RT_LATENCY_SCHED_PEER_MAX, STACK_SIZE);
+
+K_THREAD_STACK_DEFINE(ipc_echo_stack, STACK_SIZE);
+
+/*
+ * benchmark, CPU load, cache invalidation and memory load threads per core,
+ * print and wake-up peer threads, scheduling benchmark peer threads
+ */
+#define MAX_TC_THREADS	(4 * RT_LATENCY_CPUS_MAX + 2 + RT_LATENCY_SCHED_PEER_MAX)
+
+/*
+ * Wake-up matrix: preemptible benchmark thread, the peer thread one priority
+ * above it so that it runs as soon as the benchmark thread signals it (as on
+ * FreeRTOS), both above the main thread running the control loop
+ */
+#define WAKEUP_PRIO	(K_HIGHEST_APPLICATION_THREAD_PRIO + 1)
+
+/*
+ * Scheduling benchmark: preemptible threads (cooperative ones are not
+ * preempted by the higher priority peer), above the main thread running the
+ * control loop (CONFIG_MAIN_THREAD_PRIORITY)
+ */
+#define SCHED_PRIO	(K_HIGHEST_APPLICATION_THREAD_PRIO + 2)
+
+/*
+ * IPC round trip benchmark: preemptible, below the benchmark threads and above
+ * the lower priority scheduling benchmark peer (as on FreeRTOS)
+ */
+#define IPC_ECHO_PRIO	(SCHED_PRIO + 1)
+
+static const int sched_peer_prio[RT_LATENCY_SCHED_PEER_MAX] = {
+	[RT_LATENCY_SCHED_PEER_SAME] = SCHED_PRIO,
+	[RT_LATENCY_SCHED_PEER_HIGH] = SCHED_PRIO - 1,
+	[RT_LATENCY_SCHED_PEER_LOW] = IPC_ECHO_PRIO + 1,
+};
+
+BUILD_ASSERT(WAKEUP_PRIO < CONFIG_MAIN_THREAD_PRIORITY,
+	     "wake-up matrix threads must run above the main thread");
+BUILD_ASSERT(IPC_ECHO_PRIO + 1 < CONFIG_MAIN_THREAD_PRIORITY,
+	     "scheduling benchmark and IPC echo threads must run above the main thread");
+
+/*
+ * Counters of each core running a benchmark thread: latency alarm and IRQ
+ * load, from the counter<2n> and counter<2n + 1> devicetree aliases. The
+ * benchmark thread routes their interrupts to its core.
+ */
+struct core_counters {
+	const struct device *dev;
+	unsigned int irq;
+	const struct device *irq_load_dev;
+	unsigned int irq_load_irq;
+};
+
+#define CORE_COUNTERS(latency, load) \
+	{ DEVICE_DT_GET(DT_ALIAS(latency)), DT_IRQN(DT_ALIAS(latency)), \
+	  DEVICE_DT_GET(DT_ALIAS(load)), DT_IRQN(DT_ALIAS(load)) }
+
+static const struct core_counters core_counters[] = {
+	CORE_COUNTERS(counter0, counter1),
+#if DT_NODE_EXISTS(DT_ALIAS(counter3))
+	CORE_COUNTERS(counter2, counter3),
+#endif
+#if DT_NODE_EXISTS(DT_ALIAS(counter5))
+	CORE_COUNTERS(counter4, counter5),
+#endif
+#if DT_NODE_EXISTS(DT_ALIAS(counter7))
+	CORE_COUNTERS(counter6, counter7),
+#endif
+};
+
+/* Scheduling benchmark peer thread parameters */
+struct sched_peer {
+	struct rt_latency_ctx *ctx;
+	unsigned int peer; /* RT_LATENCY_SCHED_PEER_xxx */
+};
+
+/* Memory interference load thread parameters */
+struct mem_load {
+	struct rt_latency_ctx *ctx;
+	unsigned int cpu; /* buffer slice */
+};
 
 static struct main_ctx{
 	int test_case_id;
 	bool started;
-	struct rt_latency_ctx rt_ctx;
+	struct rt_latency_ctx rt_ctx[RT_LATENCY_CPUS_MAX]; /* one per benchmark core, rt_ctx[0] handles capture, tracing and wake-up matrix */
+	unsigned int cores; /* number of rt_ctx in use */
 	struct ctrl_ctx ctrl;
 	struct k_thread tc_thread[MAX_TC_THREADS];
-	int threads_running_count;
+	unsigned int threads_running_count;
+	struct k_thread ipc_echo_thread;
+	struct sched_peer sched_peer[RT_LATENCY_SCHED_PEER_MAX];
+	struct mem_load mem_load[RT_LATENCY_CPUS_MAX];
 } main_ctx;
 
+static void ipc_echo_func(void *p1, void *p2, void *p3)
+{
+	struct ctrl_ctx *ctrl = p1;
+
+	do {
+		rt_latency_ipc_echo(ctrl->ipc_ept);
+	} while (1);
+}
 
 static void counter_latency_test(void *p1, void *p2, void *p3)
 {
@@ -42,6 +142,11 @@ static void counter_latency_test(void *p1, void *p2, void *p3)
 
 	k_object_access_grant(dev, k_current_get());
 
+#if defined(CONFIG_SMP)
+	os_irq_route_to_current_cpu(core_counters[ctx->core].irq);
+	os_irq_route_to_current_cpu(core_counters[ctx->core].irq_load_irq);
+#endif
+
 	do {
 		ret = rt_latency_test(ctx);
 		if (ret)
@@ -76,41 +181,110 @@ static void cache_inval_func(void *p1, void *p2, void *p3)
 	} while(1);
 }
 
-static void print_stats_func(void *p1, void *p2, void *p3)
+static void mem_load_func(void *p1, void *p2, void *p3)
+{
+	struct mem_load *load = p1;
+
+	log_info("running memory load\r\n");
+
+	do {
+		mem_load(load->ctx, load->cpu);
+	} while(1);
+}
+
+static void wakeup_peer_func(void *p1, void *p2, void *p3)
 {
 	struct rt_latency_ctx *ctx = p1;
 
+	do {
+		rt_latency_wakeup_peer(ctx);
+	} while(1);
+}
+
+static void sched_peer_func(void *p1, void *p2, void *p3)
+{
+	struct sched_peer *peer = p1;
+
+	do {
+		rt_latency_sched_peer(peer->ctx, peer->peer);
+	} while(1);
+}
+
+static void print_stats_func(void *p1, void *p2, void *p3)
+{
+	struct main_ctx *ctx = p1;
+
 	do {
 		k_msleep(STATS_PERIOD_SEC * 1000);
 
-		print_stats(ctx);
+		print_stats_cores(ctx->rt_ctx, ctx->cores);
 	} while(1);
 }
 
-int start_test_case(void *context, int test_case_id, bool quiet)
+/*
+ * Code relocation is not supported on Cortex-A: only the OCRAM test case
+ * statistics are placed in OCRAM, mapped on first use as (non executable)
+ * data. The OCRAM test case then compares the statistics placement only.
+ */
+rt_latency_stats_t *rt_latency_ocram_stats_get(void)
+{
+	static uint8_t *ocram_stats;
+	size_t size = ROUND_UP(sizeof(rt_latency_stats_t), CONFIG_MMU_PAGE_SIZE);
+
+	if (!ocram_stats && (size <= OCRAM_DATA_SIZE))
+		os_mmu_map("ocram", &ocram_stats, OCRAM_DATA_BASE, size,
+			   OS_MEM_CACHE_WB | OS_MEM_PERM_RW | OS_MEM_DIRECT_MAP);
+
+	return (rt_latency_stats_t *)ocram_stats;
+}
+
+/*
+ * Create a test case thread, pinned to @cpu on SMP builds (unless negative),
+ * started by the caller
+ */
+static struct k_thread *tc_thread_create(struct main_ctx *ctx, k_thread_stack_t *stack,
+		k_thread_entry_t entry, void *arg, int prio, const char *name, int cpu)
+{
+	struct k_thread *thread = &ctx->tc_thread[ctx->threads_running_count++];
+	char thread_name[CONFIG_THREAD_MAX_NAME_LEN];
+
+	k_thread_create(thread, stack, STACK_SIZE, entry, arg, NULL, NULL, prio, 0, K_FOREVER);
+
+	if ((RT_LATENCY_CPUS_MAX > 1) && (cpu >= 0)) {
+		snprintf(thread_name, sizeof(thread_name), "%s%d", name, cpu);
+		k_thread_name_set(thread, thread_name);
+	} else {
+		k_thread_name_set(thread, name);
+	}
+
+#if defined(CONFIG_SMP)
+	if (cpu >= 0)
+		k_thread_cpu_pin(thread, cpu);
+#endif
+
+	return thread;
+}
+
+int start_test_case(void *context, struct rt_latency_cfg *cfg)
 {
 	struct main_ctx *ctx = context;
-	const struct device *counter_dev;
-	const struct device *irq_load_dev;
-	struct k_thread *benchmark_thread;
-	struct k_thread *cpu_load_thread;
-	struct k_thread *cache_invld_thread;
-	struct k_thread *print_thread;
-	int ret;
+	struct rt_latency_cfg core_cfg;
+	struct rt_latency_ctx *load_ctx;
+	struct k_thread *benchmark_thread[RT_LATENCY_CPUS_MAX];
+	struct k_thread *thread;
+	unsigned int cpu, i;
+	int prio, ret;
 
 	if (ctx->started)
 		return -1;
 
-	log_info("Running test case %d:\n", test_case_id);
+	log_info("Running test case %d (load: 0x%x, period: %u us):\n",
+		 cfg->test_case_id, cfg->load, cfg->period_us);
 
-	ctx->test_case_id = test_case_id;
+	if (RT_LATENCY_CPUS_MAX > 1)
+		log_info("benchmark cores: 0x%x, load cores: 0x%x\n", cfg->cpu_mask, cfg->load_cpu_mask);
 
-	/* Initialize test case load conditions based on test case ID */
-	ctx->rt_ctx.tc_load = rt_latency_get_tc_load(test_case_id);
-	if (ctx->rt_ctx.tc_load < 0) {
-		log_err("Wrong test conditions!\n");
-		goto err;
-	}
+	ctx->test_case_id = cfg->test_case_id;
 
 	/* Give required clocks some time to stabilize. In particular, nRF SoCs
 	 * need such delay for the Xtal LF clock source to start and for this
@@ -118,85 +292,151 @@ int start_test_case(void *context, int test_case_id, bool quiet)
 	 */
 	k_busy_wait(USEC_PER_MSEC * 300);
 
-	/* Create GPT threads with Highest Priority*/
-	counter_dev = DEVICE_DT_GET(DT_ALIAS(counter0));
-	if (!counter_dev) {
-		log_err("Unable to get main counter device\n");
-		goto err;
-	}
+	/* Each benchmark core uses its own counters */
+	for (cpu = 0; cpu < RT_LATENCY_CPUS_MAX; cpu++) {
+		if (!(cfg->cpu_mask & (1U << cpu)))
+			continue;
 
-	/* Use the second counter instance to create irq load with lower priority */
-	irq_load_dev = DEVICE_DT_GET(DT_ALIAS(counter1));
-	if (!irq_load_dev) {
-		log_err("Unable to get IRQ load counter device\n");
-		goto err;
-	}
+		if (cpu >= ARRAY_SIZE(core_counters)) {
+			log_err("No counters for core %u\n", cpu);
+			goto err;
+		}
 
-	/* Initialize test cases' context */
-	ret = rt_latency_init((os_counter_t *)counter_dev, (os_counter_t *)irq_load_dev, &ctx->rt_ctx);
-	if (ret != 0) {
-		log_err("Initialization failed!\n");
-		goto err;
+		if (!core_counters[cpu].dev || !core_counters[cpu].irq_load_dev) {
+			log_err("Unable to get core %u counter devices\n", cpu);
+			goto err;
+		}
 	}
 
-	ctx->rt_ctx.quiet = quiet;
-	benchmark_thread = &ctx->tc_thread[ctx->threads_running_count++];
-	/* Benchmark task: main "high prio IRQ" task */
-	k_thread_create(benchmark_thread, counter_stack, STACK_SIZE,
-		counter_latency_test, &ctx->rt_ctx, NULL, NULL,
-		K_HIGHEST_THREAD_PRIO, 0, K_FOREVER);
+	/*
+	 * Initialize test cases' context, one per benchmark core. Capture,
+	 * outlier tracing and the wake-up matrix are handled by the first one.
+	 */
+	ctx->cores = 0;
+	for (cpu = 0; cpu < RT_LATENCY_CPUS_MAX; cpu++) {
+		if (!(cfg->cpu_mask & (1U << cpu)))
+			continue;
+
+		core_cfg = *cfg;
+		core_cfg.core = cpu;
+
+		if (ctx->cores) {
+			core_cfg.capture_ept = NULL;
+			core_cfg.trace_ept = NULL;
+			core_cfg.wakeup_matrix = false;
+			core_cfg.linux_load[0] = '\0';
+			core_cfg.soak_window_s = 0;
+		}
+
+		ret = rt_latency_init((os_counter_t *)core_counters[cpu].dev,
+				      (os_counter_t *)core_counters[cpu].irq_load_dev,
+				      &core_cfg, &ctx->rt_ctx[ctx->cores]);
+		if (ret != 0) {
+			log_err("Initialization failed!\n");
+			goto err_init;
+		}
+
+		/* Benchmark task: main "high prio IRQ" task */
+		if (cfg->mode == HRPN_LATENCY_MODE_SCHED)
+			prio = SCHED_PRIO;
+		else if (ctx->rt_ctx[ctx->cores].wakeup.enabled)
+			prio = WAKEUP_PRIO;
+		else
+			prio = K_HIGHEST_THREAD_PRIO;
+
+		benchmark_thread[ctx->cores] = tc_thread_create(ctx, counter_stack[cpu],
+				counter_latency_test, &ctx->rt_ctx[ctx->cores], prio,
+				"benchmark", cpu);
+
+		ctx->cores++;
+	}
 
 	k_busy_wait(USEC_PER_MSEC * 300);
-#ifdef THREAD_CPU_BINDING
-	k_thread_cpu_mask_clear(benchmark_thread);
-	k_thread_cpu_mask_enable(benchmark_thread, GPT_CPU_BINDING);
-#endif
 
-	if (!quiet) {
+	if (!cfg->quiet) {
 		/* Print Thread */
-		print_thread = &ctx->tc_thread[ctx->threads_running_count++];
-		k_thread_create(print_thread, print_stack, STACK_SIZE,
-				print_stats_func, &ctx->rt_ctx, NULL, NULL,
-				K_LOWEST_APPLICATION_THREAD_PRIO - 2, 0, K_FOREVER);
-#ifdef THREAD_CPU_BINDING
-		k_thread_cpu_mask_clear(print_thread);
-		k_thread_cpu_mask_enable(print_thread, PRINT_CPU_BINDING);
-#endif
-		k_thread_start(print_thread);
+		thread = tc_thread_create(ctx, print_stack, print_stats_func, ctx,
+				K_LOWEST_APPLICATION_THREAD_PRIO - 2, "print_stats", -1);
+		k_thread_start(thread);
 	}
 
-	/* CPU Load Thread */
-	if (ctx->rt_ctx.tc_load & RT_LATENCY_WITH_CPU_LOAD) {
-		cpu_load_thread = &ctx->tc_thread[ctx->threads_running_count++];
-		k_thread_create(cpu_load_thread, cpu_load_stack, STACK_SIZE,
-			cpu_load_func, &ctx->rt_ctx, NULL, NULL,
-			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_FOREVER);
-#ifdef THREAD_CPU_BINDING
-		k_thread_cpu_mask_clear(cpu_load_thread);
-		k_thread_cpu_mask_enable(cpu_load_thread, CPU_LOAD_CPU_BINDING);
-#endif
-		k_thread_start(cpu_load_thread);
+	/*
+	 * Load threads, on each load core. A core running a benchmark thread
+	 * loads it with its own context, other cores use the first one.
+	 */
+	for (cpu = 0; cpu < RT_LATENCY_CPUS_MAX; cpu++) {
+		if (!(cfg->load_cpu_mask & (1U << cpu)))
+			continue;
+
+		load_ctx = &ctx->rt_ctx[0];
+		for (i = 0; i < ctx->cores; i++)
+			if (ctx->rt_ctx[i].core == cpu)
+				load_ctx = &ctx->rt_ctx[i];
+
+		/* CPU Load Thread */
+		if (load_ctx->tc_load & RT_LATENCY_WITH_CPU_LOAD) {
+			thread = tc_thread_create(ctx, cpu_load_stack[cpu], cpu_load_func, load_ctx,
+					K_LOWEST_APPLICATION_THREAD_PRIO, "cpu_load", cpu);
+			k_thread_start(thread);
+		}
+
+		/* Cache Invalidate Thread */
+		if (load_ctx->tc_load & RT_LATENCY_WITH_INVD_CACHE) {
+			thread = tc_thread_create(ctx, cache_inval_stack[cpu], cache_inval_func, NULL,
+					K_LOWEST_APPLICATION_THREAD_PRIO - 1, "cache_inval", cpu);
+			k_thread_start(thread);
+		}
+
+		/* Memory Load Thread */
+		if (load_ctx->tc_load & RT_LATENCY_WITH_MEM_LOAD) {
+			ctx->mem_load[cpu].ctx = load_ctx;
+			ctx->mem_load[cpu].cpu = cpu;
+
+			thread = tc_thread_create(ctx, mem_load_stack[cpu], mem_load_func, &ctx->mem_load[cpu],
+					K_LOWEST_APPLICATION_THREAD_PRIO, "mem_load", cpu);
+			k_thread_start(thread);
+		}
 	}
 
-	/* Cache Invalidate Thread */
-	if (ctx->rt_ctx.tc_load & RT_LATENCY_WITH_INVD_CACHE) {
-		cache_invld_thread = &ctx->tc_thread[ctx->threads_running_count++];
-		k_thread_create(cache_invld_thread, cache_inval_stack, STACK_SIZE,
-			cache_inval_func, NULL, NULL, NULL,
-			K_LOWEST_APPLICATION_THREAD_PRIO - 1, 0, K_FOREVER);
-#ifdef THREAD_CPU_BINDING
-		k_thread_cpu_mask_clear(cache_invld_thread);
-		k_thread_cpu_mask_enable(cache_invld_thread, CPU_LOAD_CPU_BINDING);
-#endif
-		k_thread_start(cache_invld_thread);
+	/*
+	 * Wake-up matrix peer thread: above the benchmark thread, so that it
+	 * blocks on the wake-up primitive before the benchmark thread signals it
+	 * and the signal switches to it right away
+	 */
+	if (ctx->rt_ctx[0].wakeup.enabled) {
+		thread = tc_thread_create(ctx, wakeup_peer_stack, wakeup_peer_func, &ctx->rt_ctx[0],
+				WAKEUP_PRIO - 1, "wakeup_peer", cfg->core);
+		k_thread_start(thread);
+	}
+
+	/* Scheduling benchmark peer threads, on the benchmark core (single one) */
+	if (ctx->rt_ctx[0].sched.enabled) {
+		for (i = 0; i < RT_LATENCY_SCHED_PEER_MAX; i++) {
+			ctx->sched_peer[i].ctx = &ctx->rt_ctx[0];
+			ctx->sched_peer[i].peer = i;
+
+			thread = tc_thread_create(ctx, sched_peer_stack[i], sched_peer_func, &ctx->sched_peer[i],
+					sched_peer_prio[i], "sched_peer", cfg->core);
+			k_thread_start(thread);
+		}
 	}
 
 	/* Start GPT Threads */
-	k_thread_start(benchmark_thread);
+	for (i = 0; i < ctx->cores; i++)
+		k_thread_start(benchmark_thread[i]);
 
 	ctx->started = true;
 
 	return 0;
+
+err_init:
+	while (ctx->cores)
+		rt_latency_destroy(&ctx->rt_ctx[--ctx->cores]);
+
+	for (i = 0; i < ctx->threads_running_count; i++)
+		k_thread_abort(&ctx->tc_thread[i]);
+
+	ctx->threads_running_count = 0;
 err:
 	destroy_test_case(ctx);
 
@@ -206,7 +446,7 @@ err:
 void destroy_test_case(void *context)
 {
 	struct main_ctx *ctx = context;
-	int i;
+	unsigned int i;
 
 	if (!ctx->started)
 		return;
@@ -217,7 +457,13 @@ void destroy_test_case(void *context)
 
 	ctx->threads_running_count = 0;
 
-	rt_latency_destroy(&ctx->rt_ctx);
+	for (i = 0; i < ctx->cores; i++)
+		rt_latency_destroy(&ctx->rt_ctx[i]);
+
+	if (ctx->cores > 1)
+		print_stats_aggregate(ctx->rt_ctx, ctx->cores);
+
+	ctx->cores = 0;
 
 	ctx->started = false;
 }
@@ -236,10 +482,18 @@ int main(void)
 	rc = ctrl_ctx_init(&ctx->ctrl);
 	rtos_assert(!rc, "ctrl context failed!");
 
+	/* IPC round trip benchmark, always running, below the benchmark threads */
+	k_thread_create(&ctx->ipc_echo_thread, ipc_echo_stack, STACK_SIZE,
+			ipc_echo_func, &ctx->ctrl, NULL, NULL,
+			IPC_ECHO_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&ctx->ipc_echo_thread, "ipc_echo");
+
 	do {
 		command_handler(ctx, ctx->ctrl.ept);
+		rt_latency_ctrl_poll(ctx, &ctx->rt_ctx[0], ctx->ctrl.ept);
+		rt_latency_telemetry_poll(&ctx->ctrl, ctx->rt_ctx, ctx->cores);
 
-		k_msleep(100);
+		k_msleep(RT_LATENCY_CTRL_POLL_PERIOD_MS);
 
 	} while(1);
 
@@ -290,8 +290,16 @@ function gpio_stop ()
     fi
 }
 
+# harpoon_ctrl capabilities cache, only valid for the running inmate
+function caps_cache_clear()
+{
+    rm -f /run/harpoon_caps
+}
+
 function start ()
 {
+    caps_cache_clear
+
     set_real_time_configuration
 
     gpio_start
@@ -367,6 +375,8 @@ function stop ()
     modprobe -r jailhouse
 
     gpio_stop
+
+    caps_cache_clear
 }
 
 